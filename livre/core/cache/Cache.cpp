@@ -171,6 +171,21 @@ struct Cache::Impl
         return it->second;
     }
 
+    ConstCacheObjects getFromMap( const CacheIds& cacheIds ) const
+    {
+        ConstCacheObjects objects;
+        objects.reserve( cacheIds.size( ));
+
+        ReadLock readLock( _mutex );
+        for( const CacheId& cacheId: cacheIds )
+        {
+            ConstCacheMap::const_iterator it = _cacheMap.find( cacheId );
+            objects.push_back( it == _cacheMap.end() ? ConstCacheObjectPtr()
+                                                     : it->second );
+        }
+        return objects;
+    }
+
     bool unload( const CacheId& cacheId )
     {
         WriteLock lock( _mutex );
@@ -241,6 +256,11 @@ ConstCacheObjectPtr Cache::get( const CacheId& cacheId ) const
     return _impl->get( cacheId );
 }
 
+ConstCacheObjects Cache::get( const CacheIds& cacheIds ) const
+{
+    return _impl->getFromMap( cacheIds );
+}
+
 const std::type_index& Cache::_getCacheObjectType() const
 {
     return _impl->_cacheObjectType;
@@ -23,6 +23,7 @@
 #include <livre/core/api.h>
 #include <livre/core/types.h>
 #include <livre/core/lunchboxTypes.h>
+#include <livre/core/util/Tracer.h>
 
 namespace livre
 {
@@ -60,6 +61,14 @@ public:
      */
     LIVRECORE_API ConstCacheObjectPtr get( const CacheId& cacheId ) const;
 
+    /**
+     * Gets the cached objects from the cache with a single lock of the cache.
+     * @param cacheIds The object cache ids to be queried.
+     * @return The cache objects in the order of the ids, with an empty cache
+     * object for each id which is not in the list.
+     */
+    LIVRECORE_API ConstCacheObjects get( const CacheIds& cacheIds ) const;
+
     /**
      * Gets the cached object from the cache with a given type and d
      * @param cacheId The object cache id to be queried.
@@ -114,6 +123,7 @@ public:
 
         try
         {
+            const Tracer::Scope trace( "cache", getStatistics().getName( ));
             ConstCacheObjectPtr cacheObject
                     = _load( ConstCacheObjectPtr( new CacheObjectT( cacheId, args... )));
 
@@ -131,6 +141,24 @@ public:
         return obj;
     }
 
+    /**
+     * Inserts an object which has been constructed outside of the cache, e.g.
+     * to publish it only once it can be used by the other threads.
+     * @param cacheObject the object to insert
+     * @return the inserted object, or the previously loaded object with the
+     * same cache id.
+     * @throw std::runtime_error if the cache does not support the type
+     */
+    template< class CacheObjectT >
+    LIVRECORE_API std::shared_ptr< const CacheObjectT > insert(
+        const std::shared_ptr< const CacheObjectT >& cacheObject )
+    {
+        if( _getCacheObjectType() != getType< CacheObjectT >( ))
+            LBTHROW( std::runtime_error( "The cache does not support the type" ));
+
+        return std::static_pointer_cast< const CacheObjectT >( _load( cacheObject ));
+    }
+
     /**
      * @return Statistics.
      */
@@ -0,0 +1,163 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/cache/PrefetchStatistics.h>
+#include <livre/core/data/NodeId.h>
+
+namespace livre
+{
+
+struct PrefetchStatistics::Impl
+{
+    /** A prefetched node which was not visible yet */
+    struct Pending
+    {
+        size_t bytes;
+        uint64_t frame;
+    };
+
+    explicit Impl( const uint32_t expiryFrames )
+        : _expiryFrames( expiryFrames )
+    {
+        clear();
+    }
+
+    void notifyPrefetched( const NodeId& nodeId, const size_t bytes )
+    {
+        ScopedLock lock( _mutex );
+        if( _pending.emplace( nodeId.getId(), Pending{ bytes, _frame }).second )
+            ++_nPrefetched;
+    }
+
+    void notifyFrame( const NodeIds& visibles )
+    {
+        ScopedLock lock( _mutex );
+        ++_frame;
+        for( const NodeId& nodeId: visibles )
+            _nHits += _pending.erase( nodeId.getId( ));
+
+        for( auto i = _pending.begin(); i != _pending.end(); )
+        {
+            if( _frame - i->second.frame <= _expiryFrames )
+            {
+                ++i;
+                continue;
+            }
+            ++_nWasted;
+            _wastedBytes += i->second.bytes;
+            i = _pending.erase( i );
+        }
+    }
+
+    float getAccuracy() const
+    {
+        ScopedLock lock( _mutex );
+        const size_t nResolved = _nHits + _nWasted;
+        return nResolved > 0 ? float( _nHits ) / float( nResolved ) : 0.f;
+    }
+
+    void clear()
+    {
+        ScopedLock lock( _mutex );
+        _pending.clear();
+        _frame = 0;
+        _nPrefetched = 0;
+        _nHits = 0;
+        _nWasted = 0;
+        _wastedBytes = 0;
+    }
+
+    const uint64_t _expiryFrames;
+    mutable boost::mutex _mutex;
+    std::unordered_map< Identifier, Pending > _pending;
+    uint64_t _frame;
+    size_t _nPrefetched;
+    size_t _nHits;
+    size_t _nWasted;
+    size_t _wastedBytes;
+};
+
+PrefetchStatistics::PrefetchStatistics( const uint32_t expiryFrames )
+    : _impl( new PrefetchStatistics::Impl( expiryFrames ))
+{}
+
+PrefetchStatistics::~PrefetchStatistics()
+{}
+
+void PrefetchStatistics::notifyPrefetched( const NodeId& nodeId,
+                                           const size_t bytes )
+{
+    _impl->notifyPrefetched( nodeId, bytes );
+}
+
+void PrefetchStatistics::notifyFrame( const NodeIds& visibles )
+{
+    _impl->notifyFrame( visibles );
+}
+
+size_t PrefetchStatistics::getPrefetchedCount() const
+{
+    ScopedLock lock( _impl->_mutex );
+    return _impl->_nPrefetched;
+}
+
+size_t PrefetchStatistics::getHitCount() const
+{
+    ScopedLock lock( _impl->_mutex );
+    return _impl->_nHits;
+}
+
+size_t PrefetchStatistics::getWastedCount() const
+{
+    ScopedLock lock( _impl->_mutex );
+    return _impl->_nWasted;
+}
+
+size_t PrefetchStatistics::getWastedBytes() const
+{
+    ScopedLock lock( _impl->_mutex );
+    return _impl->_wastedBytes;
+}
+
+float PrefetchStatistics::getAccuracy() const
+{
+    return _impl->getAccuracy();
+}
+
+void PrefetchStatistics::clear()
+{
+    _impl->clear();
+}
+
+std::ostream& operator<<( std::ostream& stream,
+                          const PrefetchStatistics& statistics )
+{
+    const float accuracy = statistics.getAccuracy();
+    stream << "Prefetching" << std::endl;
+    stream << "  Prefetched blocks: "
+           << statistics.getPrefetchedCount() << std::endl;
+    stream << "  Accuracy: "
+           << int( 100.f * accuracy + .5f ) << "%" << std::endl;
+    stream << "  Wasted: " << statistics.getWastedCount() << " blocks, "
+           << ( statistics.getWastedBytes() + LB_1MB - 1 ) / LB_1MB << "MB"
+           << std::endl;
+    return stream;
+}
+
+}
@@ -0,0 +1,94 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _PrefetchStatistics_h_
+#define _PrefetchStatistics_h_
+
+#include <livre/core/api.h>
+#include <livre/core/types.h>
+
+namespace livre
+{
+
+/**
+ * The PrefetchStatistics class measures how many of the nodes loaded ahead
+ * of the camera are rendered later. A prefetched node is a hit once it is
+ * visible in a frame, and wasted if it is not visible within the expiry
+ * frames. The class is thread safe.
+ */
+class PrefetchStatistics
+{
+public:
+    /**
+     * @param expiryFrames the number of frames after which a prefetched node
+     * which was not visible is wasted
+     */
+    LIVRECORE_API explicit PrefetchStatistics( uint32_t expiryFrames );
+    LIVRECORE_API ~PrefetchStatistics();
+
+    /**
+     * Notifies a node loaded before it was visible.
+     * @param nodeId the node
+     * @param bytes the memory loaded for the node
+     */
+    LIVRECORE_API void notifyPrefetched( const NodeId& nodeId, size_t bytes );
+
+    /**
+     * Notifies the visible nodes of a rendered frame.
+     * @param visibles the visible nodes
+     */
+    LIVRECORE_API void notifyFrame( const NodeIds& visibles );
+
+    /** @return the number of prefetched nodes */
+    LIVRECORE_API size_t getPrefetchedCount() const;
+
+    /** @return the number of prefetched nodes which became visible */
+    LIVRECORE_API size_t getHitCount() const;
+
+    /** @return the number of prefetched nodes which did not become visible */
+    LIVRECORE_API size_t getWastedCount() const;
+
+    /** @return the memory loaded for the wasted nodes in bytes */
+    LIVRECORE_API size_t getWastedBytes() const;
+
+    /**
+     * @return the ratio of hits to the hit and wasted nodes, 0 if no
+     * prefetched node expired or became visible yet
+     */
+    LIVRECORE_API float getAccuracy() const;
+
+    /** Clears the statistics */
+    LIVRECORE_API void clear();
+
+    /**
+     * @param stream Output stream.
+     * @param statistics Input \see PrefetchStatistics
+     * @return The output stream.
+     */
+    LIVRECORE_API friend std::ostream& operator<<( std::ostream& stream,
+                                                   const PrefetchStatistics& statistics );
+
+private:
+    struct Impl;
+    std::unique_ptr< Impl > _impl;
+};
+
+}
+
+#endif // _PrefetchStatistics_h_
@@ -21,6 +21,7 @@
 #include <livre/core/defines.h>
 #include <livre/core/data/DataSource.h>
 #include <livre/core/data/DataSourcePlugin.h>
+#include <livre/core/maths/Quantizer.h>
 #include <livre/core/version.h>
 
 #include <lunchbox/pluginFactory.h>
@@ -31,6 +32,66 @@ namespace livre
 namespace
 {
     lunchbox::DSOs _plugins;
+
+template< class T >
+Vector2f getTypeRange()
+{
+    return Vector2f( std::numeric_limits< T >::min(),
+                     std::numeric_limits< T >::max( ));
+}
+
+Vector2f getQuantizationRange( DataSourcePlugin& plugin )
+{
+    const VolumeInformation& info = plugin.getVolumeInfo();
+    if( info.dataRange[ 0 ] <= info.dataRange[ 1 ] )
+        return info.dataRange;
+
+    const Vector2f range = plugin.computeDataRange();
+    if( range[ 0 ] <= range[ 1 ] )
+        return range;
+
+    // Without a known range, integer volumes use the range of their type
+    switch( info.dataType )
+    {
+        case DT_UINT8:
+            return getTypeRange< uint8_t >();
+        case DT_UINT16:
+            return getTypeRange< uint16_t >();
+        case DT_UINT32:
+            return getTypeRange< uint32_t >();
+        case DT_INT8:
+            return getTypeRange< int8_t >();
+        case DT_INT16:
+            return getTypeRange< int16_t >();
+        case DT_INT32:
+            return getTypeRange< int32_t >();
+        case DT_FLOAT:
+        case DT_UNDEFINED:
+        default:
+            LBTHROW( std::runtime_error( "Cannot quantize a volume with "
+                                         "unknown data range" ));
+    }
+}
+
+template< class SRC_TYPE, class DEST_TYPE >
+MemoryUnitPtr quantizeData( const MemoryUnit& data, const size_t count,
+                            const Vector2f& range )
+{
+    AllocMemoryUnitPtr quantized( new AllocMemoryUnit( count *
+                                                       sizeof( DEST_TYPE )));
+    quantize( data.getData< SRC_TYPE >(), quantized->getData< DEST_TYPE >(),
+              count, range );
+    return quantized;
+}
+
+template< class SRC_TYPE >
+MemoryUnitPtr quantizeData( const MemoryUnit& data, const size_t count,
+                            const DataType dataType, const Vector2f& range )
+{
+    if( dataType == DT_UINT8 )
+        return quantizeData< SRC_TYPE, uint8_t >( data, count, range );
+    return quantizeData< SRC_TYPE, uint16_t >( data, count, range );
+}
 }
 
 struct DataSource::Impl
@@ -42,8 +103,68 @@ public:
           const AccessMode accessMode )
         : plugin( PluginFactory::getInstance().create(
                       DataSourcePluginData( uri, accessMode )))
+        , quantization( DT_UNDEFINED )
+        , quantized( false )
     {}
 
+    const VolumeInformation& getVolumeInfo() const
+    {
+        return quantized ? volumeInfo : plugin->getVolumeInfo();
+    }
+
+    void updateVolumeInfo()
+    {
+        const VolumeInformation& info = plugin->getVolumeInfo();
+        volumeInfo = info;
+        volumeInfo.dataType = quantization;
+        quantized = quantization != DT_UNDEFINED &&
+                    info.getBytesPerVoxel() > volumeInfo.getBytesPerVoxel();
+        if( !quantized )
+            return;
+
+        quantizationRange = getQuantizationRange( *plugin );
+        volumeInfo.dataRange = quantization == DT_UINT8 ?
+                                   getTypeRange< uint8_t >() :
+                                   getTypeRange< uint16_t >();
+    }
+
+    template< class MemoryUnitPtrT >
+    MemoryUnitPtrT quantize( const MemoryUnitPtrT& data,
+                             const LODNode& node ) const
+    {
+        if( !quantized || !data )
+            return data;
+
+        const VolumeInformation& info = plugin->getVolumeInfo();
+        const Vector3ui blockSize = node.getBlockSize() + info.overlap * 2;
+        const size_t count = size_t( blockSize.product( )) * info.compCount;
+
+        switch( info.dataType )
+        {
+            case DT_UINT16:
+                return quantizeData< uint16_t >( *data, count, quantization,
+                                                 quantizationRange );
+            case DT_UINT32:
+                return quantizeData< uint32_t >( *data, count, quantization,
+                                                 quantizationRange );
+            case DT_INT16:
+                return quantizeData< int16_t >( *data, count, quantization,
+                                                quantizationRange );
+            case DT_INT32:
+                return quantizeData< int32_t >( *data, count, quantization,
+                                                quantizationRange );
+            case DT_FLOAT:
+                return quantizeData< float >( *data, count, quantization,
+                                              quantizationRange );
+            case DT_UINT8:
+            case DT_INT8:
+            case DT_UNDEFINED:
+            default:
+                LBUNREACHABLE;
+                return data;
+        }
+    }
+
     LODNode getNode( const NodeId& nodeId ) const
     {
         return plugin->getNode( nodeId );
@@ -51,15 +172,21 @@ public:
 
     MemoryUnitPtr getData( const LODNode& node )
     {
-        return plugin->getData( node );
+        return quantize( plugin->getData( node ), node );
     }
 
     ConstMemoryUnitPtr getData( const LODNode& node ) const
     {
-        return plugin->getData( node );
+        return quantize( plugin->getData( node ), node );
     }
 
     std::unique_ptr< DataSourcePlugin > plugin;
+
+    // Volume information of the quantized volume
+    VolumeInformation volumeInfo;
+    DataType quantization;
+    Vector2f quantizationRange;
+    bool quantized;
 };
 
 DataSource::DataSource( const lunchbox::URI& uri,
@@ -86,14 +213,41 @@ LODNode DataSource::getNode( const NodeId& nodeId ) const
     return _impl->getNode( nodeId );
 }
 
+bool DataSource::hasRegularTree() const
+{
+    return _impl->plugin->hasRegularTree();
+}
+
 bool DataSource::update()
 {
-    return _impl->plugin->update();
+    if( !_impl->plugin->update( ))
+        return false;
+
+    _impl->updateVolumeInfo();
+    return true;
+}
+
+bool DataSource::isQuantized() const
+{
+    return _impl->quantized;
+}
+
+void DataSource::setQuantization( const DataType dataType )
+{
+    if( dataType != DT_UINT8 && dataType != DT_UINT16 &&
+        dataType != DT_UNDEFINED )
+    {
+        LBTHROW( std::runtime_error( "Quantization is only supported to "
+                                     "8 and 16 bits" ));
+    }
+
+    _impl->quantization = dataType;
+    _impl->updateVolumeInfo();
 }
 
 const VolumeInformation& DataSource::getVolumeInfo() const
 {
-    return _impl->plugin->getVolumeInfo();
+    return _impl->getVolumeInfo();
 }
 
 bool DataSource::initializeGL()
@@ -110,7 +264,7 @@ MemoryUnitPtr DataSource::getData( const NodeId& nodeId )
     if( !lodNode.isValid( ))
         return MemoryUnitPtr();
 
-    return _impl->plugin->getData( lodNode );
+    return _impl->getData( lodNode );
 }
 
 ConstMemoryUnitPtr DataSource::getData( const NodeId& nodeId ) const
@@ -122,7 +276,7 @@ ConstMemoryUnitPtr DataSource::getData( const NodeId& nodeId ) const
     if( !lodNode.isValid( ))
         return ConstMemoryUnitPtr();
 
-    return _impl->plugin->getData( lodNode );
+    return _impl->getData( lodNode );
 }
 
 VolumeInformation DataSource::getVolumeInfo( const lunchbox::URI& uri )
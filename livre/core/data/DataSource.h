@@ -79,9 +79,33 @@ public:
      */
     LIVRECORE_API LODNode getNode( const NodeId& nodeId ) const;
 
+    /** @copydoc DataSourcePlugin::hasRegularTree() */
+    LIVRECORE_API bool hasRegularTree() const;
+
     /** @copydoc DataSourcePlugin::update() */
     LIVRECORE_API bool update();
 
+    /**
+     * Enable the quantization of the volume data on load.
+     *
+     * Voxels of wider types are converted to the given unsigned 8 or 16 bit
+     * type, mapping the data range of the volume to the full range of the
+     * type. The volume information reports the reduced type and range
+     * afterwards, so the caches and the renderer consume the reduced format.
+     * Volumes which are not wider than the given type are not touched.
+     *
+     * @param dataType DT_UINT8, DT_UINT16 or DT_UNDEFINED to disable it.
+     * @throw std::runtime_error if the data type is not supported or the
+     *        data range of a floating point volume is unknown.
+     */
+    LIVRECORE_API void setQuantization( DataType dataType );
+
+    /**
+     * @return true if the voxels are quantized on load, the volume
+     *         information then has the range of the quantized type.
+     */
+    LIVRECORE_API bool isQuantized() const;
+
 private:
 
     struct Impl;
@@ -19,32 +19,85 @@
 
 #include <livre/core/data/DataSourcePlugin.h>
 
+#include <array>
+#include <unordered_map>
+
 namespace livre
 {
 
-DataSourcePlugin::DataSourcePlugin()
-    : _lodNodeMap( 128 )
-{}
+namespace
+{
+// The cache is split into independently locked shards, so concurrent lookups
+// from the render, compute and upload threads rarely contend on one mutex.
+const size_t nLODNodeCacheShards = 64;
+const size_t maxLODNodesPerShard = 4096;
+const size_t shardIndexShift = 64 - 6; // 2^6 shards
+static_assert( nLODNodeCacheShards == 1u << ( 64 - shardIndexShift ),
+               "Shard count does not match the shard index shift" );
+}
 
-LODNode DataSourcePlugin::getNode( const NodeId& nodeId ) const
+/**
+ * Bounded concurrent map of LODNodes for data sources with irregular trees,
+ * where computing a node may be expensive (i.e. UVF metadata lookups). When a
+ * shard reaches its capacity it is cleared, which bounds the memory while the
+ * working set of a frame is re-populated in a few lookups.
+ */
+class DataSourcePlugin::LODNodeCache
 {
-    IdLODNodeMap::iterator it;
+public:
+    LODNode get( const NodeId& nodeId, const DataSourcePlugin& plugin )
     {
-        ReadLock lock( _mutex );
-        it = _lodNodeMap.find( nodeId.getId( ));
-        if( it != _lodNodeMap.end( ))
-            return it->second;
+        const Identifier id = nodeId.getId();
+        Shard& shard = _shards[ getShardIndex( id )];
+        {
+            ReadLock lock( shard.mutex );
+            const auto it = shard.nodes.find( id );
+            if( it != shard.nodes.end( ))
+                return it->second;
+        }
+
+        // Compute outside of the lock, concurrent misses for the same node
+        // compute the same value.
+        const LODNode node = plugin.internalNodeToLODNode( nodeId );
+
+        WriteLock lock( shard.mutex );
+        if( shard.nodes.size() >= maxLODNodesPerShard )
+            shard.nodes.clear();
+        shard.nodes.emplace( id, node );
+        return node;
     }
 
-    WriteLock writeLock( _mutex );
-    it = _lodNodeMap.find( nodeId.getId( ));
-    if( it == _lodNodeMap.end( ))
+private:
+    struct Shard
     {
-        const LODNode& node = internalNodeToLODNode( nodeId );
-        _lodNodeMap[ nodeId.getId() ] = node;
+        Shard() : nodes( maxLODNodesPerShard ) {}
+
+        ReadWriteMutex mutex;
+        std::unordered_map< Identifier, LODNode > nodes;
+    };
+
+    static size_t getShardIndex( const Identifier id )
+    {
+        // Fibonacci hashing spreads the level and position bits over shards
+        return ( id * 0x9E3779B97F4A7C15ull ) >> shardIndexShift;
     }
 
-    return _lodNodeMap[ nodeId.getId() ];
+    std::array< Shard, nLODNodeCacheShards > _shards;
+};
+
+DataSourcePlugin::DataSourcePlugin()
+    : _lodNodeCache( new LODNodeCache )
+{}
+
+DataSourcePlugin::~DataSourcePlugin()
+{}
+
+LODNode DataSourcePlugin::getNode( const NodeId& nodeId ) const
+{
+    if( hasRegularTree( ))
+        return internalNodeToLODNode( nodeId );
+
+    return _lodNodeCache->get( nodeId, *this );
 }
 
 const VolumeInformation& DataSourcePlugin::getVolumeInfo() const
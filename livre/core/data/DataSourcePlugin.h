@@ -66,12 +66,12 @@ public:
     /** Needed by the PluginRegisterer. */
     typedef DataSourcePluginData InitDataT;
 
-    virtual ~DataSourcePlugin() {}
+    LIVRECORE_API virtual ~DataSourcePlugin();
 
     /**
      * @return The volume information.
      */
-    const VolumeInformation& getVolumeInfo() const;
+    LIVRECORE_API const VolumeInformation& getVolumeInfo() const;
 
     /**
      * Initializes the GL specific functions.
@@ -100,22 +100,40 @@ public:
     LIVRECORE_API virtual bool update() { return false; }
 
     /**
+     * Regular trees compute their LODNodes arithmetically from the NodeId (see
+     * the default internalNodeToLODNode()), so getNode() does not need to
+     * cache them. Data sources with irregular trees should return false.
+     * @return true if the LOD tree is a regular octree.
+     */
+    LIVRECORE_API virtual bool hasRegularTree() const { return false; }
+
+    /**
+     * Computes the value range of the voxels, for data sources which can only
+     * find it by scanning the volume. It is only called when the range is
+     * needed for quantization and the volume information does not have it.
+     * @return the range, empty ( min > max ) if it is unknown
+     */
+    LIVRECORE_API virtual Vector2f computeDataRange() { return _volumeInfo.dataRange; }
+
+    /**
+     * For regular trees the node is computed without any locking or
+     * allocation, otherwise it is looked up in a bounded concurrent cache.
      * @param nodeId The nodeId to get the node for.
      * @return The LODNode for the ID or 0 if not found.
      */
-    LODNode getNode( const NodeId& nodeId ) const;
+    LIVRECORE_API LODNode getNode( const NodeId& nodeId ) const;
 
 protected:
 
     DataSourcePlugin( const DataSourcePlugin& ) = delete;
     DataSourcePlugin& operator=( const DataSourcePlugin& ) = delete;
 
-    typedef std::unordered_map< Identifier, LODNode > IdLODNodeMap;
-
-    mutable IdLODNodeMap _lodNodeMap;
     VolumeInformation _volumeInfo;
-    mutable ReadWriteMutex _mutex;
 
+private:
+
+    class LODNodeCache;
+    std::unique_ptr< LODNodeCache > _lodNodeCache;
 };
 
 /**
@@ -19,6 +19,8 @@
 
 #include <livre/core/data/Histogram.h>
 
+#include <cmath>
+
 namespace livre
 {
 
@@ -57,12 +59,8 @@ Histogram& Histogram::operator+=( const Histogram& histogram )
         return *this;
     }
 
-    if( histogram.getBins().size() != getBins().size() ||
-        histogram.getMin() != getMin() ||
-        histogram.getMax() != getMax( ))
-    {
+    if( !isCompatible( histogram ))
         LBTHROW( std::runtime_error( "Addition of incompatible histograms"));
-    }
 
     const uint64_t* srcBins = histogram.getBins().data();
 
@@ -151,6 +149,67 @@ void Histogram::resize( size_t newSize )
     }
 }
 
+Histogram Histogram::rebin( const Vector2f& range, const size_t binCount ) const
+{
+    Histogram histogram;
+    histogram.setMin( range[ 0 ] );
+    histogram.setMax( range[ 1 ] );
+    if( getBins().empty( ))
+        return histogram;
+
+    histogram.resize( binCount );
+    if( binCount == 0 )
+        return histogram;
+
+    const uint64_t* srcBins = getBins().data();
+    uint64_t* bins = histogram.getBins().data();
+    const double lastBin = double( binCount - 1 );
+    const double scale = range[ 1 ] > range[ 0 ] ?
+                             double( binCount ) / ( range[ 1 ] - range[ 0 ] ) : 0.0;
+    const double srcWidth = ( getMax() - getMin( )) / double( getBins().size( ));
+
+    for( size_t i = 0; i < getBins().size(); ++i )
+    {
+        const uint64_t count = srcBins[ i ];
+        if( count == 0 )
+            continue;
+
+        // Source bin extent in units of destination bins
+        const double begin = ( getMin() + i * srcWidth - range[ 0 ] ) * scale;
+        const double end = begin + srcWidth * scale;
+        const size_t first = std::min( std::max( begin, 0.0 ), lastBin );
+        if( end <= begin )
+        {
+            bins[ first ] += count;
+            continue;
+        }
+
+        const size_t last = std::min( std::max( std::ceil( end ) - 1.0, 0.0 ), lastBin );
+
+        uint64_t remaining = count;
+        for( size_t j = first; j < last && remaining > 0; ++j )
+        {
+            const double overlap = std::min( end, j + 1.0 ) - std::max( begin, double( j ));
+            const uint64_t share =
+                std::min( remaining, uint64_t( std::llround( count * overlap / ( end - begin ))));
+            bins[ j ] += share;
+            remaining -= share;
+        }
+        bins[ last ] += remaining;
+    }
+    return histogram;
+}
+
+bool Histogram::isCompatible( const Histogram& histogram ) const
+{
+    if( getBins().empty() || histogram.getBins().empty( ))
+        return true;
+
+    return histogram.getBins().size() == getBins().size() &&
+           histogram.getMin() == getMin() &&
+           histogram.getMax() == getMax();
+}
+
 std::ostream& operator<<( std::ostream& os, const Histogram& histogram )
 {
     os << " Min value index: " << histogram.getMinIndex()
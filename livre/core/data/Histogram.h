@@ -99,6 +99,23 @@ public:
       * @param newSize
       */
     LIVRECORE_API void resize( size_t newSize );
+
+    /**
+     * Remaps the histogram to another range and bin count without the source
+     * data. The count of every bin is distributed to the new bins it overlaps,
+     * proportionally to the overlap, so the sum of the histogram is preserved.
+     * Values outside of the new range are clamped to the outer bins.
+     * @param range the new data range, usually containing the current one
+     * @param binCount the new number of bins
+     * @return the rebinned histogram
+     */
+    LIVRECORE_API Histogram rebin( const Vector2f& range, size_t binCount ) const;
+
+    /**
+     * @return true if the histogram can be added to this one, i.e. they have
+     *         the same range and number of bins or one of them is empty.
+     */
+    LIVRECORE_API bool isCompatible( const Histogram& histogram ) const;
 };
 
 /** Outputs the histogram information */
@@ -22,6 +22,37 @@
 namespace livre
 {
 
+namespace
+{
+/** Spreads the lower 21 bits of value so there are two zero bits between each. */
+uint64_t spreadBits( uint64_t value )
+{
+    value &= 0x1fffff;
+    value = ( value | value << 32 ) & 0x1f00000000ffffull;
+    value = ( value | value << 16 ) & 0x1f0000ff0000ffull;
+    value = ( value | value << 8 ) & 0x100f00f00f00f00full;
+    value = ( value | value << 4 ) & 0x10c30c30c30c30c3ull;
+    value = ( value | value << 2 ) & 0x1249249249249249ull;
+    return value;
+}
+
+/** @return true if the most significant bit of lhs is lower than the one of rhs */
+bool lessMSB( const uint32_t lhs, const uint32_t rhs )
+{
+    return lhs < rhs && lhs < ( lhs ^ rhs );
+}
+
+/** @return the position of the node scaled to the given finer level */
+Vector3ui getPositionAtLevel( const NodeId& nodeId, const uint32_t level )
+{
+    const uint32_t shift = level - nodeId.getLevel();
+    const Vector3ui& position = nodeId.getPosition();
+    return Vector3ui( position.x() << shift,
+                      position.y() << shift,
+                      position.z() << shift );
+}
+}
+
 NodeId::NodeId()
     : _id( INVALID_NODE_ID )
 {}
@@ -47,13 +78,11 @@ Vector3ui NodeId::getPosition( ) const
 NodeIds NodeId::getParents() const
 {
     NodeIds nodeIds;
-    NodeId parent = getParent();
+    if( isValid( ))
+        nodeIds.reserve( _level );
 
-    while( parent.isValid( ))
-    {
+    for( const NodeId& parent: getParentRange( ))
         nodeIds.push_back( parent );
-        parent = parent.getParent();
-    }
 
     return nodeIds;
 }
@@ -90,25 +119,8 @@ bool NodeId::isChild( const NodeId& childNodeId ) const
 
 NodeIds NodeId::getChildren() const
 {
-    if( _level == INVALID_LEVEL )
-        return NodeIds();
-
-    NodeIds nodeIds;
-    const Vector3ui childPos = getPosition() * 2;
-    for( uint32_t x = 0; x < 2; ++x )
-    {
-        for( uint32_t y = 0; y < 2; ++y )
-        {
-            for( uint32_t z = 0; z < 2; ++z )
-            {
-                const Vector3ui pos( childPos[ 0 ] + x,
-                                     childPos[ 1 ] + y,
-                                     childPos[ 2 ] + z );
-                nodeIds.push_back( NodeId( _level + 1, pos, _timeStep ) );
-            }
-        }
-    }
-    return nodeIds;
+    const NodeIdChildRange& children = getChildRange();
+    return NodeIds( children.begin(), children.end( ));
 }
 
 NodeId NodeId::getRoot() const
@@ -118,11 +130,8 @@ NodeId NodeId::getRoot() const
 
 NodeIds NodeId::getSiblings( ) const
 {
-    if( _level == INVALID_LEVEL || _level == 0 )
-        return NodeIds();
-
-    const NodeId& parentId = getParent();
-    return parentId.getChildren();
+    const NodeIdChildRange& siblings = getSiblingRange();
+    return NodeIds( siblings.begin(), siblings.end( ));
 }
 
 Range NodeId::getRange() const
@@ -161,4 +170,41 @@ NodeIds NodeId::getChildrenAtLevel( const uint32_t level ) const
     return nodeIds;
 }
 
+uint64_t NodeId::getMortonCode() const
+{
+    return ( spreadBits( _blockPosX ) << 2 ) |
+           ( spreadBits( _blockPosY ) << 1 ) |
+             spreadBits( _blockPosZ );
+}
+
+bool mortonLess( const NodeId& lhs, const NodeId& rhs )
+{
+    if( lhs.getTimeStep() != rhs.getTimeStep( ))
+        return lhs.getTimeStep() < rhs.getTimeStep();
+
+    // Compare the positions on the finer level, without building the codes
+    // which may not fit in 64 bits for deep trees with many root blocks.
+    const uint32_t level = std::max( lhs.getLevel(), rhs.getLevel( ));
+    const Vector3ui& lhsPos = getPositionAtLevel( lhs, level );
+    const Vector3ui& rhsPos = getPositionAtLevel( rhs, level );
+
+    // x is the most significant axis, see getMortonCode()
+    size_t axis = 0;
+    for( size_t i = 1; i < 3; ++i )
+    {
+        if( lessMSB( lhsPos[ axis ] ^ rhsPos[ axis ], lhsPos[ i ] ^ rhsPos[ i ] ))
+            axis = i;
+    }
+
+    if( lhsPos[ axis ] != rhsPos[ axis ] )
+        return lhsPos[ axis ] < rhsPos[ axis ];
+
+    return lhs.getLevel() < rhs.getLevel();
+}
+
+void sortMorton( NodeIds& nodeIds )
+{
+    std::sort( nodeIds.begin(), nodeIds.end(), mortonLess );
+}
+
 }
@@ -25,10 +25,14 @@
 #include <livre/core/types.h>
 
 #include <functional>
+#include <iterator>
 
 namespace livre
 {
 
+class NodeIdChildRange;
+class NodeIdParentRange;
+
 /** Identifier for octree LOD nodes */
 class NodeId
 {
@@ -84,6 +88,36 @@ public:
     LIVRECORE_API Range getRange() const; //<! Normalized data range within tree
     LIVRECORE_API Identifier getId() const { return _id; } //<! Returns the unique identifier
 
+    /**
+     * @param index of the child in [0,8), in Morton order (same order as
+     *        getChildren())
+     * @return the child with the given index
+     */
+    LIVRECORE_API NodeId getChild( const uint32_t index ) const
+    {
+        return NodeId( _level + 1,
+                       Vector3ui(( _blockPosX << 1 ) + (( index >> 2 ) & 1u ),
+                                 ( _blockPosY << 1 ) + (( index >> 1 ) & 1u ),
+                                 ( _blockPosZ << 1 ) + ( index & 1u )),
+                       _timeStep );
+    }
+
+    /** @return the children, iterated without allocation. */
+    inline NodeIdChildRange getChildRange() const;
+
+    /** @return the siblings ( including this node ), iterated without allocation. */
+    inline NodeIdChildRange getSiblingRange() const;
+
+    /** @return all parents up to the root, iterated without allocation. */
+    inline NodeIdParentRange getParentRange() const;
+
+    /**
+     * @return the Z-order code of the position within the node level. The bits
+     * are interleaved as ...x1y1z1x0y0z0, so children are consecutive and
+     * ordered like getChildren().
+     */
+    LIVRECORE_API uint64_t getMortonCode() const;
+
     /**
      * @param node The node which is compared against
      * @return true if two nodes have the same id
@@ -166,6 +200,111 @@ private:
 };
 
 
+/**
+ * Range over the children of a node. The children are computed on iteration,
+ * so no container is allocated.
+ */
+class NodeIdChildRange
+{
+public:
+    class const_iterator
+        : public std::iterator< std::forward_iterator_tag, NodeId, ptrdiff_t,
+                                const NodeId*, NodeId >
+    {
+    public:
+        const_iterator( const NodeId& parent, const uint32_t index )
+            : _parent( parent ), _index( index ) {}
+
+        NodeId operator*() const { return _parent.getChild( _index ); }
+        const_iterator& operator++() { ++_index; return *this; }
+        const_iterator operator++( int )
+            { const_iterator it( *this ); ++_index; return it; }
+        bool operator==( const const_iterator& rhs ) const
+            { return _index == rhs._index && _parent == rhs._parent; }
+        bool operator!=( const const_iterator& rhs ) const
+            { return !( *this == rhs ); }
+
+    private:
+        NodeId _parent;
+        uint32_t _index;
+    };
+
+    explicit NodeIdChildRange( const NodeId& parent )
+        : _parent( parent ) {}
+
+    const_iterator begin() const { return const_iterator( _parent, 0 ); }
+    const_iterator end() const { return const_iterator( _parent, size( )); }
+    size_t size() const { return _parent.isValid() ? 8 : 0; }
+    bool empty() const { return size() == 0; }
+
+private:
+    const NodeId _parent;
+};
+
+/**
+ * Range over the parents of a node, from the direct parent up to the root.
+ */
+class NodeIdParentRange
+{
+public:
+    class const_iterator
+        : public std::iterator< std::forward_iterator_tag, NodeId, ptrdiff_t,
+                                const NodeId*, const NodeId& >
+    {
+    public:
+        explicit const_iterator( const NodeId& nodeId ) : _nodeId( nodeId ) {}
+
+        const NodeId& operator*() const { return _nodeId; }
+        const NodeId* operator->() const { return &_nodeId; }
+        const_iterator& operator++() { _nodeId = _nodeId.getParent(); return *this; }
+        const_iterator operator++( int )
+            { const_iterator it( *this ); ++( *this ); return it; }
+        bool operator==( const const_iterator& rhs ) const
+            { return _nodeId == rhs._nodeId; }
+        bool operator!=( const const_iterator& rhs ) const
+            { return !( *this == rhs ); }
+
+    private:
+        NodeId _nodeId;
+    };
+
+    explicit NodeIdParentRange( const NodeId& nodeId )
+        : _first( nodeId.getParent( )) {}
+
+    const_iterator begin() const { return const_iterator( _first ); }
+    const_iterator end() const { return const_iterator( NodeId( )); }
+    bool empty() const { return !_first.isValid(); }
+
+private:
+    const NodeId _first;
+};
+
+NodeIdChildRange NodeId::getChildRange() const
+{
+    return NodeIdChildRange( *this );
+}
+
+NodeIdChildRange NodeId::getSiblingRange() const
+{
+    return NodeIdChildRange( getParent( ));
+}
+
+NodeIdParentRange NodeId::getParentRange() const
+{
+    return NodeIdParentRange( *this );
+}
+
+/**
+ * Orders nodes along the Z-order curve. Nodes on different levels are compared
+ * at the finer level, and a parent is ordered before its children, so a
+ * sorted LOD cut is spatially coherent and matches the depth first order.
+ * @return true if lhs is before rhs on the curve.
+ */
+LIVRECORE_API bool mortonLess( const NodeId& lhs, const NodeId& rhs );
+
+/** Sorts the nodes along the Z-order curve. @see mortonLess */
+LIVRECORE_API void sortMorton( NodeIds& nodeIds );
+
 inline std::ostream& operator<<( std::ostream& os, const NodeId& nodeId )
 {
     return os << "Level: " << nodeId.getLevel()
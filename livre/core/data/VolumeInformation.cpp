@@ -19,6 +19,8 @@
 
 #include <livre/core/data/VolumeInformation.h>
 
+#include <limits>
+
 namespace livre
 {
 
@@ -26,6 +28,8 @@ VolumeInformation::VolumeInformation()
     : bigEndian( false )
     , compCount( 1u )
     , dataType( DT_UINT8 )
+    , dataRange( std::numeric_limits< float >::max(),
+                 -std::numeric_limits< float >::max( ))
     , overlap( 0u )
     , maximumBlockSize( 0u )
     , voxels( 256u )
@@ -55,4 +59,9 @@ size_t VolumeInformation::getBytesPerVoxel() const
     }
 }
 
+size_t VolumeInformation::getBlockMemSize() const
+{
+    return maximumBlockSize.product() * getBytesPerVoxel() * compCount;
+}
+
 }
@@ -59,6 +59,12 @@ struct VolumeInformation
      */
     DataType dataType;
 
+    /**
+     * The value range [min, max] of the voxels over the whole volume. Data
+     * sources which know it set it, otherwise it is empty (min > max).
+     */
+    Vector2f dataRange;
+
     /**
      * The overlap voxels between blocks.
      */
@@ -101,6 +107,9 @@ struct VolumeInformation
     /** @return the number of bytes per element. */
     LIVRECORE_API size_t getBytesPerVoxel() const;
 
+    /** @return the number of bytes of the data of a block. */
+    LIVRECORE_API size_t getBlockMemSize() const;
+
     /** The frame range for the data sources. If there are no frames,
       * [0,0) range is the default value. In streaming data sources
       * frame range can change over time.
@@ -21,68 +21,44 @@
 #define _Quantizer_h_
 
 #include <livre/core/types.h>
-#include <climits>
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
 
 namespace livre
 {
 
 /**
- * Quantizes an array of type T to type U between min and max
+ * Quantizes an array of type T to the full range of the unsigned type U.
+ *
+ * Values in [range[0], range[1]] are mapped linearly and rounded to the
+ * nearest integer, values outside of the range are clamped. The loop body is
+ * branch-free, so the compiler vectorizes it for all source types.
+ *
  * @param srcData Source data pointer.
  * @param dstData Destination data pointer.
- * @param count Number of elements in source data.
- * @param compCount Component count for source data.
- * @param min Minimum value of source data.
- * @param max Maximum value of source data.
+ * @param count Number of values in source data.
+ * @param range Minimum and maximum value of source data.
  */
 template < class T, class U >
-void unsignedQuantize( const T* srcData,
-                       U* dstData,
-                       const size_t count,
-                       const size_t compCount,
-                       const Vector3f& min,
-                       const Vector3f& max )
+void quantize( const T* srcData,
+               U* dstData,
+               const size_t count,
+               const Vector2f& range )
 {
-    const float dataTypeMax = std::numeric_limits< U >::max( );
-    const Vector3f range = max - min;
-
-    #pragma omp parallel for schedule( dynamic, 65536 )
-    for( int64_t i = 0; i < int64_t(count); ++i )
-    {
-        for( size_t j = 0; j < compCount; ++j )
-        {
-            dstData[ i + j ] = ( (float)srcData[ i + j ] - min[ j ] ) / range[ j ] * dataTypeMax;
-        }
-    }
-}
+    static_assert( std::is_unsigned< U >::value && sizeof( U ) <= 2,
+                   "Quantization is only supported to 8 and 16 bits" );
 
-/**
- * Quantizes an array of type T to type U between min and max
- * @param srcData Source data pointer.
- * @param dstData Destination data pointer.
- * @param count Number of elements in source data.
- * @param compCount Component count for source data.
- * @param min Minimum value of source data.
- * @param max Maximum value of source data.
- */
-template < class T, class U >
-void signedQuantize( const T* srcData,
-                     U* dstData,
-                     const size_t count,
-                     const size_t compCount,
-                     const Vector3f& min,
-                     const Vector3f& max )
-{
-    const float dataTypeMax = std::numeric_limits< U >::max( );
-    const Vector3f range = max - min;
+    const float dataTypeMax = std::numeric_limits< U >::max();
+    const float extent = range[ 1 ] - range[ 0 ];
+    const float scale = extent > 0.0f ? dataTypeMax / extent : 0.0f;
+    const float offset = 0.5f - range[ 0 ] * scale;
 
-    #pragma omp parallel for schedule( dynamic, 65536 )
-    for( int64_t i = 0; i < int64_t(count); ++i )
+    for( size_t i = 0; i < count; ++i )
     {
-        for( size_t j = 0; j < compCount; ++j )
-        {
-            dstData[ i + j ] = 2.0 * ( ( (float)srcData[ i + j ] - min[ j ] ) / range[ j ] - 0.5 ) * dataTypeMax;
-        }
+        const float value = float( srcData[ i ] ) * scale + offset;
+        dstData[ i ] = U( std::min( std::max( 0.0f, value ), dataTypeMax ));
     }
 }
 
@@ -0,0 +1,108 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _CancellationToken_h_
+#define _CancellationToken_h_
+
+#include <livre/core/types.h>
+
+#include <lunchbox/clock.h>
+
+#include <atomic>
+
+namespace livre
+{
+
+/**
+ * Shared flag for cancelling work which is no longer needed, i.e. work for
+ * a frame that was superseded by a newer one. All copies of a token share
+ * the flag. Executors drop cancelled executables before they start, running
+ * ones can poll isCancelled(). A token with a deadline is only cancelled once
+ * it is older than the deadline, so that the work of every frame makes some
+ * progress.
+ */
+class CancellationToken
+{
+public:
+
+    /**
+     * Constructs a token which is never cancelled.
+     */
+    CancellationToken() {}
+
+    /**
+     * @param deadline the time in ms from the creation after which cancel()
+     * takes effect
+     * @return a new token which can be cancelled
+     */
+    static CancellationToken create( const float deadline = 0.f )
+    {
+        CancellationToken token;
+        token._state = std::make_shared< State >( deadline );
+        return token;
+    }
+
+    /**
+     * Cancels the work of all holders of the token. Has no effect on tokens
+     * which are never cancelled.
+     */
+    void cancel() const
+    {
+        if( _state )
+            _state->cancelled = true;
+    }
+
+    /**
+     * @return true if the token is cancelled and older than its deadline
+     */
+    bool isCancelled() const
+    {
+        return _state && _state->cancelled &&
+               ( _state->deadline <= 0.f || getAge() > _state->deadline );
+    }
+
+    /**
+     * @return the time in ms since the token was created, 0 for tokens which
+     * are never cancelled
+     */
+    float getAge() const
+    {
+        return _state ? _state->clock.getTimef() : 0.f;
+    }
+
+private:
+
+    struct State
+    {
+        explicit State( const float deadline_ )
+            : cancelled( false )
+            , deadline( deadline_ )
+        {}
+
+        std::atomic< bool > cancelled;
+        const float deadline;
+        const lunchbox::Clock clock;
+    };
+
+    std::shared_ptr< State > _state;
+};
+
+}
+
+#endif // _CancellationToken_h_
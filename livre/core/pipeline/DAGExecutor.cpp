@@ -0,0 +1,143 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/pipeline/DAGExecutor.h>
+
+#include <livre/core/pipeline/Executable.h>
+#include <livre/core/pipeline/FuturePromise.h>
+#include <livre/core/pipeline/Workers.h>
+
+#include <atomic>
+
+namespace livre
+{
+
+namespace
+{
+/**
+ * Shared between the executor and the registered continuations, which may
+ * outlive the executor when their promises are never set.
+ */
+struct Dispatcher
+{
+    explicit Dispatcher( Workers* workers_ )
+        : workers( workers_ )
+        , generation( 0 )
+    {}
+
+    void dispatch( ExecutablePtr executable, const uint32_t scheduled )
+    {
+        ReadLock lock( mutex );
+        if( workers && scheduled == generation )
+            workers->schedule( executable );
+    }
+
+    ReadWriteMutex mutex;
+    Workers* workers;
+    std::atomic< uint32_t > generation;
+};
+typedef std::shared_ptr< Dispatcher > DispatcherPtr;
+
+/** An executable and the number of its preconditions not yet ready */
+struct PendingExecutable
+{
+    PendingExecutable( ExecutablePtr executable_,
+                       const DispatcherPtr& dispatcher_,
+                       const size_t unmet_ )
+        : executable( executable_ )
+        , dispatcher( dispatcher_ )
+        , generation( dispatcher_->generation )
+        , unmet( unmet_ )
+    {}
+
+    void satisfy()
+    {
+        if( --unmet == 0 )
+            dispatcher->dispatch( std::move( executable ), generation );
+    }
+
+    ExecutablePtr executable;
+    const DispatcherPtr dispatcher;
+    const uint32_t generation;
+    std::atomic< size_t > unmet;
+};
+typedef std::shared_ptr< PendingExecutable > PendingExecutablePtr;
+}
+
+struct DAGExecutor::Impl
+{
+    explicit Impl( WorkersPtr workers )
+        : _workers( workers )
+        , _dispatcher( std::make_shared< Dispatcher >( _workers.get( )))
+    {}
+
+    ~Impl()
+    {
+        // Late continuations must not reach the workers any more
+        WriteLock lock( _dispatcher->mutex );
+        _dispatcher->workers = nullptr;
+    }
+
+    void schedule( ExecutablePtr executable )
+    {
+        const Futures& preConds = executable->getPreconditions();
+
+        // One extra count guards against dispatching before all continuations
+        // are registered
+        const PendingExecutablePtr pending =
+                std::make_shared< PendingExecutable >( executable, _dispatcher,
+                                                       preConds.size() + 1 );
+        for( const Future& future: preConds )
+            future.onReady( [pending] { pending->satisfy(); } );
+        pending->satisfy();
+    }
+
+    void clear()
+    {
+        ++_dispatcher->generation;
+    }
+
+    WorkersPtr _workers;
+    DispatcherPtr _dispatcher;
+};
+
+DAGExecutor::DAGExecutor( const size_t threadCount, ConstGLContextPtr glContext )
+    : _impl( new Impl( std::make_shared< Workers >( threadCount, glContext )))
+{
+}
+
+DAGExecutor::DAGExecutor( WorkersPtr workers )
+    : _impl( new Impl( workers ))
+{
+}
+
+DAGExecutor::~DAGExecutor( )
+{}
+
+void DAGExecutor::clear()
+{
+    _impl->clear();
+}
+
+void DAGExecutor::schedule( ExecutablePtr executable )
+{
+    _impl->schedule( executable );
+}
+
+}
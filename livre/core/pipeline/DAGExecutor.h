@@ -0,0 +1,78 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _DAGExecutor_h_
+#define _DAGExecutor_h_
+
+#include <livre/core/api.h>
+#include <livre/core/pipeline/Executor.h>
+#include <livre/core/types.h>
+
+namespace livre
+{
+
+/**
+ * Executes the submitted executables in the dependency order of their pre
+ * and post conditions, without polling.
+ *
+ * On schedule(), a continuation is registered on every precondition and the
+ * executable keeps an atomic count of its unmet preconditions. The last
+ * continuation bringing the count to zero dispatches the executable to the
+ * worker threads, so the scheduling cost is linear in the number of edges.
+ */
+class DAGExecutor : public Executor
+{
+public:
+
+    /**
+     * @param threadCount is number of worker threads
+     * @param glContext if a gl context is provided, a new context will be created and
+     * the worker threads will share the context with the given context
+     */
+    LIVRECORE_API DAGExecutor( size_t threadCount,
+                               ConstGLContextPtr glContext = ConstGLContextPtr( ));
+
+    /**
+     * @param workers is the thread pool the executables are run on. It can be
+     * shared between executors.
+     */
+    LIVRECORE_API explicit DAGExecutor( WorkersPtr workers );
+
+    LIVRECORE_API virtual ~DAGExecutor();
+
+    /**
+     * @copydoc Executor::schedule
+     */
+    LIVRECORE_API void schedule( ExecutablePtr executable ) final;
+
+    /**
+     * Drops the executables which are still waiting for their preconditions.
+     * @copydoc Executor::clear
+     */
+    LIVRECORE_API void clear() final;
+
+private:
+
+    struct Impl;
+    std::unique_ptr<Impl> _impl;
+};
+
+}
+
+#endif // _DAGExecutor_h_
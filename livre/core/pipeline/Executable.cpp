@@ -31,6 +31,26 @@ Futures Executable::schedule( Executor& executor )
 Executable::~Executable()
 {}
 
+void Executable::setPriority( const ExecutionPriority priority )
+{
+    _priority = priority;
+}
+
+ExecutionPriority Executable::getPriority() const
+{
+    return _priority;
+}
+
+void Executable::setCancellationToken( const CancellationToken& token )
+{
+    _cancellationToken = token;
+}
+
+bool Executable::isCancelled() const
+{
+    return _cancellationToken.isCancelled();
+}
+
 void Executable::_schedule( Executor& executor )
 {
     executor.schedule( clone( ));
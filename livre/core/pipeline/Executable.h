@@ -22,6 +22,7 @@
 
 #include <livre/core/api.h>
 #include <livre/core/types.h>
+#include <livre/core/pipeline/CancellationToken.h>
 #include <livre/core/pipeline/FuturePromise.h>
 #include <livre/core/pipeline/Executor.h>
 
@@ -41,6 +42,13 @@ public:
      */
     virtual void execute() =  0;
 
+    /**
+     * Called by the executors instead of execute() when the executable is
+     * cancelled before it started. The implementation should release the
+     * executables waiting on its post conditions.
+     */
+    LIVRECORE_API virtual void cancel() {}
+
     /**
      * Schedules the executable through an Executor
      * @param executor schedules the executable
@@ -72,6 +80,27 @@ public:
      */
     virtual ExecutablePtr clone() const = 0;
 
+    /**
+     * @param priority is the order in which the workers pick up the executable
+     */
+    LIVRECORE_API void setPriority( ExecutionPriority priority );
+
+    /**
+     * @return the order in which the workers pick up the executable
+     */
+    LIVRECORE_API ExecutionPriority getPriority() const;
+
+    /**
+     * @param token when cancelled, the executable is dropped by the executors
+     * if it has not started yet
+     */
+    LIVRECORE_API void setCancellationToken( const CancellationToken& token );
+
+    /**
+     * @return true if the cancellation token of the executable is cancelled
+     */
+    LIVRECORE_API bool isCancelled() const;
+
     virtual ~Executable();
 
 protected:
@@ -80,6 +109,11 @@ protected:
      * @copydoc Executable::schedule
      */
     virtual void _schedule( Executor& executor );
+
+private:
+
+    ExecutionPriority _priority = PRIORITY_NORMAL;
+    CancellationToken _cancellationToken;
 };
 
 }
@@ -21,23 +21,218 @@
 
 #include <servus/uint128_t.h>
 
-#include <boost/thread/future.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <atomic>
 
 namespace livre
 {
 
-typedef boost::shared_future< PortDataPtr > PortDataFuture;
-typedef boost::promise< PortDataPtr > PortDataPromise;
-typedef std::vector< PortDataFuture > PortDataFutures;
+typedef std::function< void() > Callback;
+
+namespace
+{
+/** Wakes up a thread waiting for one or more shared states */
+struct Signal
+{
+    Signal()
+        : notified( false )
+    {}
+
+    void notify()
+    {
+        ScopedLock lock( mutex );
+        notified = true;
+        condition.notify_one();
+    }
+
+    void wait()
+    {
+        ScopedLock lock( mutex );
+        while( !notified )
+            condition.wait( lock );
+    }
+
+    boost::mutex mutex;
+    boost::condition_variable condition;
+    bool notified;
+};
+
+/** A node of the intrusive waiter list of a shared state, on the waiter's stack */
+struct Waiter
+{
+    Waiter()
+        : signal( nullptr )
+        , previous( nullptr )
+        , next( nullptr )
+    {}
+
+    Signal* signal;
+    Waiter* previous;
+    Waiter* next;
+};
+
+/**
+ * The single assignment state shared by a promise and its futures. The value
+ * is published by the atomic ready flag, so a ready state is read without
+ * locking. Only the threads which have to block, and the continuations, are
+ * registered under the lock.
+ */
+class SharedState
+{
+public:
+    explicit SharedState( const servus::uint128_t& id )
+        : _id( id )
+        , _ready( false )
+        , _abandoned( false )
+        , _waiters( nullptr )
+    {}
+
+    const servus::uint128_t& getId() const
+    {
+        return _id;
+    }
+
+    bool isReady() const
+    {
+        return _ready.load( std::memory_order_acquire );
+    }
+
+    /** @return false if the state is already set */
+    bool set( const PortDataPtr& value )
+    {
+        std::vector< Callback > callbacks;
+        {
+            ScopedLock lock( _mutex );
+            if( _ready.load( std::memory_order_relaxed ))
+                return _abandoned; // late results for a reset promise are dropped
+
+            _value = value;
+            _ready.store( true, std::memory_order_release );
+            _notifyWaiters();
+            callbacks.swap( _callbacks );
+        }
+
+        for( const Callback& callback: callbacks )
+            callback();
+        return true;
+    }
+
+    /**
+     * Readies the state without a value. The waiters are woken up, but the
+     * continuations are dropped: the work depending on an abandoned state
+     * belongs to a previous run and is not dispatched any more.
+     */
+    void abandon()
+    {
+        std::vector< Callback > callbacks; // released outside of the lock
+        {
+            ScopedLock lock( _mutex );
+            if( _ready.load( std::memory_order_relaxed ))
+                return;
+
+            _abandoned = true;
+            _ready.store( true, std::memory_order_release );
+            _notifyWaiters();
+            callbacks.swap( _callbacks );
+        }
+    }
+
+    const PortDataPtr& get()
+    {
+        wait();
+        return _value;
+    }
+
+    void wait()
+    {
+        if( isReady( ))
+            return;
+
+        Signal signal;
+        Waiter waiter;
+        waiter.signal = &signal;
+        if( addWaiter( waiter ))
+            signal.wait(); // set() unlinks all waiters
+    }
+
+    void onReady( const Callback& callback )
+    {
+        {
+            ScopedLock lock( _mutex );
+            if( !_ready.load( std::memory_order_relaxed ))
+            {
+                _callbacks.push_back( callback );
+                return;
+            }
+        }
+        callback();
+    }
+
+    /** @return false if the state is already set, the waiter is not added */
+    bool addWaiter( Waiter& waiter )
+    {
+        ScopedLock lock( _mutex );
+        if( _ready.load( std::memory_order_relaxed ))
+            return false;
+
+        waiter.previous = nullptr;
+        waiter.next = _waiters;
+        if( _waiters )
+            _waiters->previous = &waiter;
+        _waiters = &waiter;
+        return true;
+    }
+
+    void removeWaiter( Waiter& waiter )
+    {
+        ScopedLock lock( _mutex );
+        if( _ready.load( std::memory_order_relaxed ))
+            return; // already unlinked by set()
+
+        if( waiter.previous )
+            waiter.previous->next = waiter.next;
+        else
+            _waiters = waiter.next;
+
+        if( waiter.next )
+            waiter.next->previous = waiter.previous;
+    }
+
+private:
+    void _notifyWaiters()
+    {
+        // A notified waiter may leave immediately, so its successor is read
+        // first
+        Waiter* waiter = _waiters;
+        while( waiter )
+        {
+            Waiter* next = waiter->next;
+            waiter->signal->notify();
+            waiter = next;
+        }
+        _waiters = nullptr;
+    }
+
+    const servus::uint128_t _id;
+    std::atomic< bool > _ready;
+    bool _abandoned;
+    PortDataPtr _value;
+    boost::mutex _mutex;
+    Waiter* _waiters;
+    std::vector< Callback > _callbacks;
+};
+typedef std::shared_ptr< SharedState > SharedStatePtr;
+}
 
 struct Future::Impl
 {
-    Impl( const PortDataFuture& future,
+    Impl( const SharedStatePtr& state,
           const std::string& name,
-          const servus::uint128_t& uuid )
+          const bool promiseBound )
         : _name( name )
-        , _future( future )
-        , _uuid( uuid )
+        , _state( state )
+        , _promiseBound( promiseBound )
     {}
 
     std::string getName() const
@@ -45,9 +240,21 @@ struct Future::Impl
         return _name;
     }
 
+    SharedStatePtr getState() const
+    {
+        // Only the state of a promise bound future is swapped by reset()
+        return _promiseBound ? std::atomic_load( &_state ) : _state;
+    }
+
+    void setState( const SharedStatePtr& state )
+    {
+        std::atomic_store( &_state, state );
+    }
+
     PortDataPtr get( const std::type_index& dataType ) const
     {
-        const PortDataPtr& data = _future.get();
+        const SharedStatePtr state = getState();
+        const PortDataPtr& data = state->get();
 
         if( !data )
             LBTHROW( std::runtime_error( "Returns empty data" ));
@@ -60,27 +267,28 @@ struct Future::Impl
 
     bool isReady() const
     {
-        return _future.is_ready();
+        return getState()->isReady();
     }
 
     void wait() const
     {
-        return _future.wait();
+        getState()->wait();
     }
 
-    std::string _name;
-    mutable PortDataFuture _future;
-    servus::uint128_t _uuid;
+    const std::string _name;
+
+    // The state of Future( const Promise& ) is swapped by Promise::reset(),
+    // all others are immutable and shared by the copies
+    SharedStatePtr _state;
+    const bool _promiseBound;
 };
 
 struct Promise::Impl
 {
-    Impl( const DataInfo& dataInfo )
+    Impl( const DataInfo& dataInfo, const SharedStatePtr& state )
         : _dataInfo( dataInfo )
-        , _uuid( servus::make_UUID( ))
-        , _futureImpl( new Future::Impl( PortDataFuture( _promise.get_future()),
-                                         dataInfo.first,
-                                         _uuid ))
+        , _futureImpl( std::make_shared< Future::Impl >( state, dataInfo.first,
+                                                          true ))
     {}
 
     std::string getName() const
@@ -93,6 +301,11 @@ struct Promise::Impl
         return _dataInfo.second;
     }
 
+    SharedStatePtr getState() const
+    {
+        return _futureImpl->getState();
+    }
+
     void set( const PortDataPtr& data )
     {
         if( data )
@@ -101,51 +314,36 @@ struct Promise::Impl
                 LBTHROW( std::runtime_error( "Types does not match on set value"));
         }
 
-        try
-        {
-            _promise.set_value( data );
-        }
-        catch( const boost::promise_already_satisfied& )
-        {
+        if( !getState()->set( data ))
             LBTHROW( std::runtime_error( "Data only can be set once"));
-        }
     }
 
     void reset()
     {
-        try
-        {
-            _promise.set_value( PortDataPtr( ));
-        }
-        catch( const boost::promise_already_satisfied& )
-        {
-        }
+        const SharedStatePtr state = getState();
+        servus::uint128_t id = state->getId();
+        ++id; // unique again, without the cost of a new random UUID
 
-        PortDataPromise promise;
-        _promise.swap( promise );
-        _uuid = servus::make_UUID();
-        _futureImpl->_future = _promise.get_future();
-        _futureImpl->_uuid = _uuid;
+        _futureImpl->setState( std::make_shared< SharedState >( id ));
+        state->abandon();
     }
 
     void flush()
     {
-        try
-        {
-            _promise.set_value( PortDataPtr( ));
-        }
-        catch( const boost::promise_already_satisfied& )
-        {}
+        getState()->set( PortDataPtr( ));
     }
 
-    PortDataPromise _promise;
     const DataInfo _dataInfo;
-    servus::uint128_t _uuid;
-    std::shared_ptr< Future::Impl > _futureImpl;
+    const std::shared_ptr< Future::Impl > _futureImpl;
 };
 
 Promise::Promise( const DataInfo& dataInfo )
-    : _impl( new Promise::Impl( dataInfo ))
+    : _impl( new Promise::Impl( dataInfo, std::make_shared< SharedState >(
+                                              servus::make_UUID( ))))
+{}
+
+Promise::Promise( std::shared_ptr< Impl > impl )
+    : _impl( std::move( impl ))
 {}
 
 Promise::~Promise()
@@ -172,6 +370,12 @@ Future Promise::getFuture() const
      return Future( ret );
 }
 
+Promise Promise::getCurrent() const
+{
+    return Promise( std::make_shared< Impl >( _impl->_dataInfo,
+                                              _impl->getState( )));
+}
+
 void Promise::reset()
 {
     _impl->reset();
@@ -187,9 +391,10 @@ Future::Future( const Promise& promise )
 {}
 
 Future::Future( const Future& future )
-    : _impl( new Future::Impl( future._impl->_future,
-                               future.getName( ),
-                               future._impl->_uuid ))
+    : _impl( future._impl->_promiseBound ?
+                 std::make_shared< Impl >( future._impl->getState(),
+                                           future._impl->_name, false ) :
+                 future._impl )
 {}
 
 Future::~Future()
@@ -201,7 +406,10 @@ std::string Future::getName() const
 }
 
 Future::Future( const Future& future, const std::string& name )
-    : _impl( new Future::Impl( future._impl->_future, name, future._impl->_uuid ))
+    : _impl( !future._impl->_promiseBound && future._impl->_name == name ?
+                 future._impl :
+                 std::make_shared< Impl >( future._impl->getState(), name,
+                                           false ))
 {
 }
 
@@ -215,14 +423,25 @@ bool Future::isReady() const
     return _impl->isReady();
 }
 
+bool Future::hasValue() const
+{
+    const SharedStatePtr state = _impl->getState();
+    return !!state->get();
+}
+
+void Future::onReady( const std::function< void() >& callback ) const
+{
+    _impl->getState()->onReady( callback );
+}
+
 bool Future::operator==( const Future& future ) const
 {
-    return _impl->_uuid == future._impl->_uuid;
+    return getId() == future.getId();
 }
 
-const servus::uint128_t& Future::getId() const
+servus::uint128_t Future::getId() const
 {
-   return _impl->_uuid;
+   return _impl->getState()->getId();
 }
 
 PortDataPtr Future::_getPtr( const std::type_index& dataType ) const
@@ -235,12 +454,36 @@ void waitForAny( const Futures& futures )
     if( futures.empty( ))
         return;
 
-    PortDataFutures boostFutures;
-    boostFutures.reserve( futures.size( ));
     for( const auto& future: futures )
-        boostFutures.push_back( future._impl->_future );
+    {
+        if( future.isReady( ))
+            return;
+    }
+
+    // One signal for all states, a waiter node in each of their lists. The
+    // states are held, so a reset() meanwhile does not unlink them.
+    Signal signal;
+    std::vector< SharedStatePtr > states;
+    states.reserve( futures.size( ));
+    for( const auto& future: futures )
+        states.push_back( future._impl->getState( ));
+
+    std::vector< Waiter > waiters( states.size( ));
+    auto waiter = waiters.begin();
+    auto state = states.begin();
+    for( ; state != states.end(); ++state, ++waiter )
+    {
+        waiter->signal = &signal;
+        if( !(*state)->addWaiter( *waiter ))
+            break;
+    }
+
+    if( state == states.end( ))
+        signal.wait();
 
-    boost::wait_for_any( boostFutures.begin(), boostFutures.end( ));
+    waiter = waiters.begin();
+    for( auto added = states.begin(); added != state; ++added, ++waiter )
+        (*added)->removeWaiter( *waiter );
 }
 
 }
@@ -52,15 +52,17 @@ public:
     LIVRECORE_API std::string getName() const;
 
     /**
-     * Sets the port with the value.
+     * Sets the port with the value. Rvalues are moved into the port data,
+     * which is shared by all the futures without further copies.
      * @param value to be set
      * @throw std::runtime_error when the port data is not exact
      * type T or there is no such port name.
      */
     template< class T >
-    void set( const T& value )
+    void set( T&& value )
     {
-        _set( std::make_shared< PortDataT< T >>( value ));
+        typedef typename std::decay< T >::type DataT;
+        _set( std::make_shared< PortDataT< DataT >>( std::forward< T >( value )));
     }
 
     /**
@@ -76,12 +78,21 @@ public:
      */
     LIVRECORE_API Future getFuture() const;
 
+    /**
+     * @return a promise for the current data. Setting or flushing it after
+     * reset() does not affect the reset promise, so a late writer cannot
+     * satisfy the data of the next run.
+     */
+    LIVRECORE_API Promise getCurrent() const;
+
     /**
      * @resets the promise.( If related future is constructed using
      * Future( const Promise& ) constructor, future can be re-used
-     * for different data )
-     * The behavior of the function is undefined when multiple threads
-     * execute query/get from future.
+     * for different data ) The futures are re-armed atomically, so other
+     * threads may query them meanwhile. The previous data is abandoned:
+     * its waiters return without a value and its onReady() callbacks are
+     * not called. Resetting the same promise from multiple threads is not
+     * supported.
      */
     LIVRECORE_API void reset();
 
@@ -92,6 +103,7 @@ private:
     void _set( PortDataPtr data );
 
     struct Impl;
+    explicit Promise( std::shared_ptr< Impl > impl );
     std::shared_ptr<Impl> _impl;
 };
 
@@ -132,6 +144,23 @@ public:
     template< class T >
     const T& get() const { return _get<T>(); }
 
+    /**
+     * Gets the shared, immutable value with the given type T. Blocks until
+     * data is available. The value is not copied and stays valid as long
+     * as the returned pointer, independent of the future and the promise.
+     * @return the value.
+     * @throw std::runtime_error when the data is not exact
+     * type T
+     */
+    template< class T >
+    std::shared_ptr< const T > getShared() const
+    {
+        const auto dataPtr =
+                std::static_pointer_cast< const PortDataT< T >>( _getPtr( getType< T >( )));
+
+        return std::shared_ptr< const T >( dataPtr, &dataPtr->data );
+    }
+
     /**
      * Waits until the data is ready.
      */
@@ -142,6 +171,22 @@ public:
      */
     bool isReady() const;
 
+    /**
+     * Blocks until data is available.
+     * @return false if the promise was flushed without setting a value, i.e.
+     * the producing filter was cancelled.
+     */
+    bool hasValue() const;
+
+    /**
+     * Registers a callback which is called once the future is ready. If the
+     * future is already ready, the callback is called immediately, otherwise
+     * it is called by the thread setting ( or flushing ) the promise.
+     * @param callback is called at most once, never if the promise is reset
+     * before it is set
+     */
+    void onReady( const std::function< void() >& callback ) const;
+
     /**
      * @param future is the future to be checked with
      * @return true if both futures are belonging to same promise
@@ -157,7 +202,7 @@ public:
     /**
      * @return the unique identifier for the future
      */
-    const servus::uint128_t& getId() const;
+    servus::uint128_t getId() const;
 
     /**
      * Promise construction is needed when reset() on the promise
@@ -0,0 +1,347 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _ParallelMap_h_
+#define _ParallelMap_h_
+
+#include <livre/core/types.h>
+#include <livre/core/pipeline/Filter.h>
+#include <livre/core/pipeline/PipeFilter.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <sstream>
+
+namespace livre
+{
+
+/**
+ * The collection of a parallel map being processed, shared by its lanes.
+ * Lanes claim chunks of the items with the atomic cursor.
+ */
+template< class T >
+struct MapWork
+{
+    MapWork( const std::shared_ptr< const std::vector< T >>& items_,
+             const Futures& inputs_ )
+        : items( items_ )
+        , inputs( inputs_ )
+        , cursor( 0 )
+    {}
+
+    const std::shared_ptr< const std::vector< T >> items;
+    const Futures inputs; //!< The other inputs of the mapped filter
+    std::atomic< size_t > cursor;
+};
+
+/**
+ * Orders the collection of a parallel map before it is split, given all inputs
+ * of the mapped filter. The lanes claim the chunks in this order.
+ */
+template< class T >
+using MapOrder = std::function< void( std::vector< T >&, const FutureMap& ) >;
+
+/**
+ * Computes the results a parallel map can provide before its lanes have
+ * processed the collection, e.g. the items which are available already, given
+ * the collection and all inputs of the mapped filter.
+ */
+template< class T, class R >
+using MapPreview = std::function< std::vector< R >( const std::vector< T >&,
+                                                    const FutureMap& ) >;
+
+/**
+ * Receives the inputs of a parallel map and hands them to its lanes without
+ * copying the collection, unless it has to be ordered first. Once the lanes
+ * can start, the preview of the results is written to the result port.
+ */
+template< class T, class R >
+class MapSplitFilter : public Filter
+{
+public:
+    MapSplitFilter( const std::string& collectionPort, const std::string& resultPort,
+                    const DataInfos& inputInfos, const MapOrder< T >& order,
+                    const MapPreview< T, R >& preview )
+        : _collectionPort( collectionPort )
+        , _resultPort( resultPort )
+        , _inputInfos( inputInfos )
+        , _order( order )
+        , _preview( preview )
+    {}
+
+    void execute( const FutureMap& input, PromiseMap& output ) const final
+    {
+        Futures inputs;
+        for( const Future& future: input.getFutures( ))
+        {
+            if( future.getName() != _collectionPort )
+                inputs.push_back( future );
+        }
+
+        const Future collection = input.getFutures( _collectionPort ).front();
+        std::shared_ptr< const std::vector< T >> items =
+                collection.getShared< std::vector< T >>();
+        if( _order )
+        {
+            std::vector< T > ordered( *items );
+            _order( ordered, input );
+            items = std::make_shared< const std::vector< T >>( std::move( ordered ));
+        }
+        output.set( "Work", std::make_shared< MapWork< T >>( items, inputs ));
+
+        if( _preview )
+            output.set( _resultPort, _preview( *items, input ));
+        else
+            output.set( _resultPort, std::vector< R >( ));
+    }
+
+    DataInfos getInputDataInfos() const final { return _inputInfos; }
+
+    DataInfos getOutputDataInfos() const final
+    {
+        return {{ "Work", getType< std::shared_ptr< MapWork< T >>>() },
+                { _resultPort, getType< std::vector< R >>() }};
+    }
+
+private:
+    const std::string _collectionPort;
+    const std::string _resultPort;
+    const DataInfos _inputInfos;
+    const MapOrder< T > _order;
+    const MapPreview< T, R > _preview;
+};
+
+/**
+ * Executes the mapped filter on chunks of the collection until all chunks are
+ * claimed. The chunks shrink with the remaining items, so that lanes which
+ * finish early take over the work of the slower ones.
+ */
+template< class T, class R >
+class MapLaneFilter : public Filter
+{
+public:
+    MapLaneFilter( const std::shared_ptr< const Filter >& filter,
+                   const std::string& collectionPort,
+                   const std::string& resultPort,
+                   const size_t nLanes,
+                   const size_t minChunkSize )
+        : _filter( filter )
+        , _collectionPort( collectionPort )
+        , _resultPort( resultPort )
+        , _nLanes( nLanes )
+        , _minChunkSize( std::max( minChunkSize, size_t( 1 )))
+    {}
+
+    void execute( const FutureMap& input, PromiseMap& output ) const final
+    {
+        typedef std::shared_ptr< MapWork< T >> MapWorkPtr;
+        const Future workFuture = input.getFutures( "Work" ).front();
+        if( !workFuture.hasValue( )) // the input of the map was cancelled
+            return;
+
+        MapWork< T >& work = *workFuture.get< MapWorkPtr >();
+        const std::vector< T >& items = *work.items;
+        const DataInfos& outputInfos = _filter->getOutputDataInfos();
+
+        std::vector< R > results;
+        size_t begin = work.cursor;
+        while( begin < items.size( ))
+        {
+            const size_t remaining = items.size() - begin;
+            const size_t chunkSize =
+                    std::min( remaining, std::max( _minChunkSize,
+                                                   remaining / ( 2 * _nLanes )));
+            if( !work.cursor.compare_exchange_weak( begin, begin + chunkSize ))
+                continue;
+
+            Promise chunk( DataInfo( _collectionPort, getType< std::vector< T >>( )));
+            chunk.set( std::vector< T >( items.begin() + begin,
+                                         items.begin() + begin + chunkSize ));
+            Futures inputs = work.inputs;
+            inputs.push_back( chunk.getFuture( ));
+
+            Promises promises;
+            for( const DataInfo& info: outputInfos )
+                promises.emplace_back( info );
+            PromiseMap chunkOutput( promises );
+            _filter->execute( FutureMap( inputs ), chunkOutput );
+            chunkOutput.flush();
+
+            const Future result = chunkOutput.getPromise( _resultPort ).getFuture();
+            const std::vector< R >& chunkResults = result.get< std::vector< R >>();
+            results.insert( results.end(), chunkResults.begin(), chunkResults.end( ));
+
+            begin = work.cursor;
+        }
+
+        output.set( "Results", std::move( results ));
+    }
+
+    DataInfos getInputDataInfos() const final
+    {
+        return {{ "Work", getType< std::shared_ptr< MapWork< T >>>() }};
+    }
+
+    DataInfos getOutputDataInfos() const final
+    {
+        return {{ "Results", getType< std::vector< R >>() }};
+    }
+
+private:
+    const std::shared_ptr< const Filter > _filter;
+    const std::string _collectionPort;
+    const std::string _resultPort;
+    const size_t _nLanes;
+    const size_t _minChunkSize;
+};
+
+/** Concatenates the results of the lanes of a parallel map */
+template< class R >
+class MapGatherFilter : public Filter
+{
+public:
+    explicit MapGatherFilter( const std::string& resultPort )
+        : _resultPort( resultPort )
+    {}
+
+    void execute( const FutureMap& input, PromiseMap& output ) const final
+    {
+        std::vector< std::reference_wrapper< const std::vector< R >>> laneResults;
+        for( const Future& future: input.getFutures( "Results" ))
+        {
+            // Cancelled lanes have no results
+            if( future.hasValue( ))
+                laneResults.push_back( std::cref( future.get< std::vector< R >>( )));
+        }
+
+        size_t size = 0;
+        for( const std::vector< R >& results: laneResults )
+            size += results.size();
+
+        std::vector< R > gathered;
+        gathered.reserve( size );
+        for( const std::vector< R >& results: laneResults )
+            gathered.insert( gathered.end(), results.begin(), results.end( ));
+        output.set( _resultPort, std::move( gathered ));
+    }
+
+    DataInfos getInputDataInfos() const final
+    {
+        return {{ "Results", getType< std::vector< R >>() }};
+    }
+
+    DataInfos getOutputDataInfos() const final
+    {
+        return {{ _resultPort, getType< std::vector< R >>() }};
+    }
+
+private:
+    const std::string _resultPort;
+};
+
+/**
+ * ParallelMap applies a filter to the items of a collection in parallel. The
+ * filter is executed on chunks of the std::vector< T > collection port and
+ * has to write a std::vector< R > result port, the results of all chunks are
+ * gathered into one std::vector< R > port. The results are not in the order
+ * of the items.
+ *
+ * The map consists of an input filter with the input ports of the mapped
+ * filter, a lane per thread which claims chunks of the collection until it is
+ * exhausted, and an output filter with the result port. All of them have to
+ * be scheduled, see getFilters(). The input filter also has the result port,
+ * with a preview of the results which is ready before the lanes start.
+ */
+template< class T, class R >
+class ParallelMap
+{
+public:
+    /**
+     * @param name the name of the map, prefixing the names of its filters
+     * @param filter the filter applied to the chunks of the collection
+     * @param collectionPort the name of the input port with the collection
+     * @param resultPort the name of the output port with the results
+     * @param nLanes the number of filters processing chunks in parallel
+     * @param minChunkSize the minimum number of items in a chunk
+     * @param order if given, orders the collection before it is split
+     * @param preview if given, computes the preview of the results, which is
+     *        empty otherwise
+     */
+    ParallelMap( const std::string& name,
+                 const std::shared_ptr< const Filter >& filter,
+                 const std::string& collectionPort,
+                 const std::string& resultPort,
+                 const size_t nLanes,
+                 const size_t minChunkSize = 1,
+                 const MapOrder< T >& order = MapOrder< T >(),
+                 const MapPreview< T, R >& preview = MapPreview< T, R >( ))
+        : _input( PipeFilterT< MapSplitFilter< T, R >>( name + "Split", collectionPort,
+                                                        resultPort,
+                                                        filter->getInputDataInfos(),
+                                                        order, preview ))
+        , _output( PipeFilterT< MapGatherFilter< R >>( name + "Gather", resultPort ))
+    {
+        const size_t lanes = std::max( nLanes, size_t( 1 ));
+        for( size_t i = 0; i < lanes; ++i )
+        {
+            std::stringstream laneName;
+            laneName << name << "Lane" << i;
+            PipeFilter lane = PipeFilterT< MapLaneFilter< T, R >>( laneName.str(),
+                                                                  filter,
+                                                                  collectionPort,
+                                                                  resultPort,
+                                                                  lanes,
+                                                                  minChunkSize );
+            _input.connect( "Work", lane, "Work" );
+            lane.connect( "Results", _output, "Results" );
+            _lanes.push_back( lane );
+        }
+    }
+
+    /**
+     * @return the filter receiving the inputs of the mapped filter, and
+     * providing the preview of the results
+     */
+    PipeFilter& getInput() { return _input; }
+
+    /** @return the filter providing the gathered results */
+    PipeFilter& getOutput() { return _output; }
+
+    /** @return the lanes executing the mapped filter */
+    const std::vector< PipeFilter >& getLanes() const { return _lanes; }
+
+    /** @return all filters of the map: the input, the lanes and the output */
+    std::vector< PipeFilter > getFilters() const
+    {
+        std::vector< PipeFilter > filters( 1, _input );
+        filters.insert( filters.end(), _lanes.begin(), _lanes.end( ));
+        filters.push_back( _output );
+        return filters;
+    }
+
+private:
+    PipeFilter _input;
+    PipeFilter _output;
+    std::vector< PipeFilter > _lanes;
+};
+
+}
+
+#endif // _ParallelMap_h_
@@ -25,6 +25,7 @@
 #include <livre/core/pipeline/PipeFilter.h>
 #include <livre/core/pipeline/FuturePromise.h>
 #include <livre/core/pipeline/Filter.h>
+#include <livre/core/util/Tracer.h>
 
 namespace livre
 {
@@ -84,6 +85,7 @@ struct PipeFilter::Impl
 
         const FutureMap futures( inputFutures );
         PromiseMap promises( getOutputPromises( ));
+        const Tracer::Scope trace( "filter", _name );
 
         try
         {
@@ -123,9 +125,11 @@ struct PipeFilter::Impl
 
     Promises getOutputPromises() const
     {
+        // Bound to the current run, so a reset() while the filter is still
+        // executing does not let its outputs satisfy the next run
         Promises promises;
         for( const auto& namePort: _outputMap )
-            promises.push_back( namePort.second.getPromise( ));
+            promises.push_back( namePort.second.getPromise().getCurrent( ));
 
         return promises;
     }
@@ -174,13 +178,13 @@ struct PipeFilter::Impl
 
     void reset()
     {
+        // The manually set ports stay connected, so the filter can be re-armed
+        // without creating new ports and promises
         for( auto& namePort: _manuallySetPortsMap )
-            _inputMap.find( namePort.first )->second.disconnect( namePort.second );
+            namePort.second.reset();
 
-        _manuallySetPortsMap.clear();
         for( auto& namePort: _outputMap )
             namePort.second.reset();
-
     }
 
     PipeFilter& _pipeFilter;
@@ -224,6 +228,11 @@ Futures PipeFilter::getPostconditions() const
     return _impl->getPostconditions();
 }
 
+void PipeFilter::cancel()
+{
+    PromiseMap( _impl->getOutputPromises( )).flush();
+}
+
 Futures PipeFilter::getPreconditions() const
 {
     return _impl->getPreconditions();
@@ -59,7 +59,8 @@ public:
     /**
      * @return promise for the given input port. If there is no connection to the
      * input port, a new promise is created for the port and no further connections are allowed,
-     * if there is a connection getting a promise is not allowed.
+     * if there is a connection getting a promise is not allowed. reset() keeps
+     * the promise, so it can be set again for the next execution.
      * @throw std::logic_error if there is already a connection if there is
      * no input port or it is a notification port.
      */
@@ -70,6 +71,13 @@ public:
      */
     LIVRECORE_API void execute() final;
 
+    /**
+     * Writes empty values to the output ports, so the connected filters
+     * are not blocked.
+     * @copydoc Executable::cancel
+     */
+    LIVRECORE_API void cancel() final;
+
     /**
      * @copydoc Executable::getPostconditions
      */
@@ -24,6 +24,7 @@
 #include <livre/core/types.h>
 #include <livre/core/pipeline/PipeFilter.h>
 #include <livre/core/pipeline/Executable.h>
+#include <livre/core/pipeline/ParallelMap.h>
 
 namespace livre
 {
@@ -78,6 +79,35 @@ public:
         return pipeFilter;
     }
 
+    /**
+     * Creates and adds a parallel map, which applies a filter of type FilterT
+     * to chunks of a collection in parallel, see ParallelMap.
+     * @param name the name of the map.
+     * @param collectionPort the input port of FilterT with the std::vector< T >
+     * @param resultPort the output port of FilterT with the std::vector< R >
+     * @param nLanes the number of filters processing chunks in parallel
+     * @param args for the FilterT construction
+     * @return the generated parallel map.
+     * @throw std::runtime_error if an executable with same name is present
+     */
+    template< class FilterT, class T, class R, class... Args >
+    ParallelMap< T, R > addParallelMap( const std::string& name,
+                                        const std::string& collectionPort,
+                                        const std::string& resultPort,
+                                        const size_t nLanes,
+                                        Args&&... args )
+    {
+        const ParallelMap< T, R > map( name,
+                                       std::make_shared< FilterT >(
+                                           std::forward< Args >( args )... ),
+                                       collectionPort, resultPort, nLanes );
+        for( const PipeFilter& filter: map.getFilters( ))
+            _add( filter.getName(),
+                  UniqueExecutablePtr( new PipeFilter( filter )),
+                  true );
+        return map;
+    }
+
     /**
      * @param name of the executable
      * @return the executable
@@ -55,6 +55,15 @@ struct PortDataT final : public PortData
         , data( data_ )
     {}
 
+    /**
+     * Constructor
+     * @param data_ is moved
+     */
+    explicit PortDataT( T&& data_ )
+        : PortData( getType< T >())
+        , data( std::move( data_ ))
+    {}
+
     ~PortDataT() {}
     const T data;
 
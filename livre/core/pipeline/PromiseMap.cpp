@@ -113,7 +113,7 @@ void PromiseMap::reset( const std::string& name) const
 
 void PromiseMap::reset() const
 {
-    _impl->flush();
+    _impl->reset();
 }
 
 Promise PromiseMap::getPromise( const std::string& name ) const
@@ -55,9 +55,9 @@ public:
      * type T
      */
     template< class T >
-    void set( const std::string& name, const T& value ) const
+    void set( const std::string& name, T&& value ) const
     {
-        getPromise( name ).set( value );
+        getPromise( name ).set( std::forward< T >( value ));
     }
 
     /**
@@ -30,6 +30,7 @@
 #include <livre/core/data/NodeId.h>
 #include <livre/core/data/LODNode.h>
 #include <livre/core/render/GLContext.h>
+#include <livre/core/util/Tracer.h>
 
 #include <lunchbox/mtQueue.h>
 
@@ -49,8 +50,8 @@ bool operator<( const Future& future1, const Future& future2 )
 struct SimpleExecutor::Impl
 {
 
-    Impl( const size_t threadCount, ConstGLContextPtr glContext )
-        : _workers( threadCount, glContext )
+    explicit Impl( WorkersPtr workers )
+        : _workers( workers )
         , _unlockPromise( DataInfo( "LoopUnlock", getType< bool >( )))
         , _workThread( boost::thread( boost::bind( &Impl::schedule, this )))
     {}
@@ -94,6 +95,7 @@ struct SimpleExecutor::Impl
                 }
             }
 
+            const Tracer::Scope trace( "executor", "SimpleExecutor" );
             std::list< ExecutablePtr >::iterator it = executables.begin();
             while( it != executables.end( ))
             {
@@ -102,7 +104,7 @@ struct SimpleExecutor::Impl
                 const FutureMap futureMap( preConds );
                 if( futureMap.isReady( ))
                 {
-                    _workers.schedule( executable );
+                    _workers->schedule( executable );
                     it = executables.erase( it );
                     for( const auto& future: futureMap.getFutures( ))
                         inputConditions.erase( future );
@@ -128,14 +130,19 @@ struct SimpleExecutor::Impl
     }
 
     lunchbox::MTQueue< ExecutablePtr > _mtWorkQueue;
-    Workers _workers;
+    WorkersPtr _workers;
     Promise _unlockPromise;
     boost::mutex _promiseReset;
     boost::thread _workThread;
 };
 
 SimpleExecutor::SimpleExecutor( const size_t threadCount, ConstGLContextPtr glContext )
-    : _impl( new Impl( threadCount, glContext ))
+    : _impl( new Impl( std::make_shared< Workers >( threadCount, glContext )))
+{
+}
+
+SimpleExecutor::SimpleExecutor( WorkersPtr workers )
+    : _impl( new Impl( workers ))
 {
 }
 
@@ -47,6 +47,13 @@ public:
     LIVRECORE_API SimpleExecutor( size_t threadCount,
                                   ConstGLContextPtr glContext = ConstGLContextPtr( ));
 
+    /**
+     * @param workers is the thread pool the executables are run on. It can be
+     * shared between executors, idle workers then steal the work of the busy
+     * ones.
+     */
+    LIVRECORE_API explicit SimpleExecutor( WorkersPtr workers );
+
     LIVRECORE_API virtual ~SimpleExecutor();
 
     /**
@@ -0,0 +1,118 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/pipeline/ThreadTuner.h>
+
+#include <algorithm>
+
+namespace livre
+{
+
+namespace
+{
+// Throughput gain required to keep a thread count, below it the gain is
+// considered to be measurement noise
+const float minGain = 1.05f;
+}
+
+ThreadTuner::ThreadTuner( const size_t nThreads, const size_t minThreads,
+                          const size_t maxThreads, const size_t nFramesPerStep )
+    : _minThreads( std::max( minThreads, size_t( 1 )))
+    , _maxThreads( std::max( maxThreads, _minThreads ))
+    , _nFramesPerStep( std::max( nFramesPerStep, size_t( 1 )))
+    , _nThreads( std::min( std::max( nThreads, _minThreads ), _maxThreads ))
+    , _bestThreads( _nThreads )
+    , _bestThroughput( 0.f )
+    , _direction( 0 )
+    , _done( _minThreads == _maxThreads )
+    , _nFrames( 0 )
+    , _nItems( 0 )
+    , _milliseconds( 0.f )
+    , _queueDepth( 0 )
+{}
+
+size_t ThreadTuner::addFrame( const size_t nItems, const float milliseconds,
+                              const size_t queueDepth )
+{
+    if( _done )
+        return _nThreads;
+
+    _nItems += nItems;
+    _milliseconds += milliseconds;
+    _queueDepth += queueDepth;
+    if( ++_nFrames < _nFramesPerStep )
+        return _nThreads;
+
+    const float throughput = _milliseconds > 0.f ? _nItems / _milliseconds : 0.f;
+    _step( throughput, float( _queueDepth ) / _nFrames );
+
+    _nFrames = 0;
+    _nItems = 0;
+    _milliseconds = 0.f;
+    _queueDepth = 0;
+    return _nThreads;
+}
+
+void ThreadTuner::_step( const float throughput, const float queueDepth )
+{
+    if( _direction == 0 )
+    {
+        // First measurement at the initial count
+        _bestThroughput = throughput;
+        if( queueDepth >= 1.f && _nThreads < _maxThreads )
+        {
+            _direction = 1;
+            ++_nThreads;
+        }
+        else if( _nThreads > _minThreads )
+        {
+            _direction = -1;
+            --_nThreads;
+        }
+        else
+            _finish( _nThreads );
+        return;
+    }
+
+    const bool improved = _direction > 0 ? throughput > _bestThroughput * minGain
+                                         : throughput * minGain >= _bestThroughput;
+    if( !improved )
+    {
+        _finish( _bestThreads );
+        return;
+    }
+
+    _bestThreads = _nThreads;
+    _bestThroughput = std::max( throughput, _bestThroughput );
+
+    if( _direction > 0 && queueDepth >= 1.f && _nThreads < _maxThreads )
+        ++_nThreads;
+    else if( _direction < 0 && _nThreads > _minThreads )
+        --_nThreads;
+    else
+        _finish( _nThreads );
+}
+
+void ThreadTuner::_finish( const size_t nThreads )
+{
+    _nThreads = nThreads;
+    _done = true;
+}
+
+}
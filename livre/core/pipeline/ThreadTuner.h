@@ -0,0 +1,88 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _ThreadTuner_h_
+#define _ThreadTuner_h_
+
+#include <livre/core/api.h>
+
+#include <cstddef>
+
+namespace livre
+{
+
+/**
+ * The ThreadTuner class searches the number of threads of a pipeline stage
+ * which maximizes its throughput. It measures the throughput for a few frames
+ * at a thread count, and climbs to the neighbouring count while the
+ * throughput improves. More threads are only tried while work is waiting in
+ * the queues, otherwise the stage is not limited by its threads.
+ *
+ * The tuning ends once the best count is found, it is not thread safe.
+ */
+class ThreadTuner
+{
+public:
+    /**
+     * @param nThreads the initial number of threads
+     * @param minThreads the minimum number of threads
+     * @param maxThreads the maximum number of threads
+     * @param nFramesPerStep the number of frames measured per thread count
+     */
+    LIVRECORE_API ThreadTuner( size_t nThreads, size_t minThreads,
+                               size_t maxThreads, size_t nFramesPerStep = 4 );
+
+    /**
+     * Adds the measurement of a frame, run with getThreadCount() threads.
+     * @param nItems the number of items processed by the stage
+     * @param milliseconds the time the stage took
+     * @param queueDepth the number of tasks waiting for a thread
+     * @return the number of threads for the next frames
+     */
+    LIVRECORE_API size_t addFrame( size_t nItems, float milliseconds,
+                                   size_t queueDepth );
+
+    /** @return the number of threads to use */
+    size_t getThreadCount() const { return _nThreads; }
+
+    /** @return true if the tuning has ended */
+    bool isDone() const { return _done; }
+
+private:
+    void _step( float throughput, float queueDepth );
+    void _finish( size_t nThreads );
+
+    const size_t _minThreads;
+    const size_t _maxThreads;
+    const size_t _nFramesPerStep;
+    size_t _nThreads;
+    size_t _bestThreads;
+    float _bestThroughput;
+    int _direction;
+    bool _done;
+
+    size_t _nFrames;
+    size_t _nItems;
+    float _milliseconds;
+    size_t _queueDepth;
+};
+
+}
+
+#endif // _ThreadTuner_h_
@@ -20,29 +20,204 @@
 #include <livre/core/pipeline/Workers.h>
 #include <livre/core/pipeline/Executable.h>
 #include <livre/core/render/GLContext.h>
+#include <livre/core/util/Tracer.h>
 
-#include <lunchbox/mtQueue.h>
+#include <lunchbox/thread.h>
 
+#include <boost/thread/condition_variable.hpp>
 #include <boost/thread/thread.hpp>
 
+#include <atomic>
+
 namespace livre
 {
 
+namespace
+{
+/** A scheduled executable, with its queueing time when tracing */
+struct Task
+{
+    explicit Task( ExecutablePtr executable_ )
+        : executable( std::move( executable_ ))
+        , queued( Tracer::isEnabled() ? Tracer::getTime() : -1.0 )
+    {}
+
+    ExecutablePtr executable;
+    const double queued;
+};
+
+typedef Task* WorkItem;
+
+/**
+ * Chase-Lev work-stealing deque, with the memory orderings from Le et al.,
+ * "Correct and Efficient Work-Stealing for Weak Memory Models". push() and
+ * take() may only be called by the owning worker, steal() by any thread.
+ */
+class WorkStealingDeque
+{
+public:
+    explicit WorkStealingDeque( const size_t capacity = 256 )
+        : _top( 0 )
+        , _bottom( 0 )
+    {
+        _arrays.emplace_back( new Array( capacity ));
+        _array.store( _arrays.back().get(), std::memory_order_relaxed );
+    }
+
+    ~WorkStealingDeque()
+    {
+        while( WorkItem item = take( ))
+            delete item;
+    }
+
+    void push( const WorkItem item )
+    {
+        const int64_t bottom = _bottom.load( std::memory_order_relaxed );
+        const int64_t top = _top.load( std::memory_order_acquire );
+        Array* array = _array.load( std::memory_order_relaxed );
+        if( bottom - top > int64_t( array->size ) - 1 )
+            array = _grow( array, top, bottom );
+
+        array->put( bottom, item );
+        _bottom.store( bottom + 1, std::memory_order_release );
+    }
+
+    WorkItem take()
+    {
+        const int64_t bottom = _bottom.load( std::memory_order_relaxed ) - 1;
+        Array* array = _array.load( std::memory_order_relaxed );
+        _bottom.store( bottom, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        int64_t top = _top.load( std::memory_order_relaxed );
+
+        if( top > bottom )
+        {
+            _bottom.store( bottom + 1, std::memory_order_relaxed );
+            return nullptr;
+        }
+
+        WorkItem item = array->get( bottom );
+        if( top == bottom )
+        {
+            // Last item, race against the thieves
+            if( !_top.compare_exchange_strong( top, top + 1,
+                                               std::memory_order_seq_cst,
+                                               std::memory_order_relaxed ))
+            {
+                item = nullptr;
+            }
+            _bottom.store( bottom + 1, std::memory_order_relaxed );
+        }
+        return item;
+    }
+
+    WorkItem steal()
+    {
+        int64_t top = _top.load( std::memory_order_acquire );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        const int64_t bottom = _bottom.load( std::memory_order_acquire );
+        if( top >= bottom )
+            return nullptr;
+
+        Array* array = _array.load( std::memory_order_acquire );
+        WorkItem item = array->get( top );
+        if( !_top.compare_exchange_strong( top, top + 1,
+                                           std::memory_order_seq_cst,
+                                           std::memory_order_relaxed ))
+        {
+            return nullptr;
+        }
+        return item;
+    }
+
+private:
+    struct Array
+    {
+        explicit Array( const size_t size_ )
+            : size( size_ )
+            , items( new std::atomic< WorkItem >[ size_ ] )
+        {}
+
+        WorkItem get( const int64_t index ) const
+        {
+            return items[ index & ( size - 1 )].load( std::memory_order_relaxed );
+        }
+
+        void put( const int64_t index, const WorkItem item )
+        {
+            items[ index & ( size - 1 )].store( item, std::memory_order_relaxed );
+        }
+
+        const size_t size; // power of two
+        std::unique_ptr< std::atomic< WorkItem >[] > items;
+    };
+
+    Array* _grow( const Array* array, const int64_t top, const int64_t bottom )
+    {
+        // Thieves may still read from the old array, so it is only released
+        // together with the deque
+        _arrays.emplace_back( new Array( array->size * 2 ));
+        Array* grown = _arrays.back().get();
+        for( int64_t i = top; i < bottom; ++i )
+            grown->put( i, array->get( i ));
+        _array.store( grown, std::memory_order_release );
+        return grown;
+    }
+
+    std::atomic< int64_t > _top;
+    std::atomic< int64_t > _bottom;
+    std::atomic< Array* > _array;
+    std::vector< std::unique_ptr< Array >> _arrays;
+};
+
+/** Maximum number of items a worker moves from the injection queue at once */
+const size_t maxInjectionBatch = 32;
+const size_t nPriorities = PRIORITY_HIGH + 1;
+}
+
 struct Workers::Impl
 {
+    struct Worker
+    {
+        Worker( Impl& pool_, const size_t index_ )
+            : pool( pool_ )
+            , index( index_ )
+        {}
+
+        Impl& pool;
+        const size_t index;
+        WorkStealingDeque deque;
+    };
+
     Impl( Workers& workers,
           const size_t nThreads,
-          const ConstGLContextPtr& glContext )
+          const ConstGLContextPtr& glContext,
+          const Affinity affinity,
+          const uint32_t node )
         : _workers( workers )
         , _glContext( glContext )
+        , _affinity( affinity )
+        , _node( node )
+        , _pending( 0 )
+        , _sleeping( 0 )
+        , _stopping( false )
     {
+        for( std::atomic< size_t >& nInjected: _nInjected )
+            nInjected = 0;
+
+        for( size_t i = 0; i < nThreads; ++i )
+            _queues.emplace_back( new Worker( *this, i ));
+
         for( size_t i = 0; i < nThreads; ++i )
             _threadGroup.create_thread( boost::bind( &Impl::execute,
-                                                     this ));
+                                                     this, i ));
     }
 
-    void execute()
+    void execute( const size_t index )
     {
+        _setAffinity( index );
+        _current = _queues[ index ].get();
+
         GLContextPtr context;
         if( _glContext )
         {
@@ -51,13 +226,18 @@ struct Workers::Impl
             context->makeCurrent();
         }
 
-        while( true )
+        while( WorkItem item = _next( index ))
         {
-            ExecutablePtr exec = _workQueue.pop();
-            if( !exec )
-                break;
+            const ExecutablePtr exec( std::move( item->executable ));
+            if( item->queued >= 0.0 && Tracer::isEnabled( ))
+                Tracer::setQueueWait( Tracer::getTime() - item->queued );
+            delete item;
 
-            exec->execute();
+            if( exec->isCancelled( ))
+                exec->cancel();
+            else
+                exec->execute();
+            Tracer::setQueueWait( 0.0 );
         }
 
         if( context )
@@ -65,20 +245,40 @@ struct Workers::Impl
             context->doneCurrent();
             context.reset();
         }
+        _current = nullptr;
     }
 
     ~Impl()
     {
-        for( size_t i = 0; i < getSize(); ++i )
-            _workQueue.push( ExecutablePtr( ));
+        {
+            ScopedLock lock( _mutex );
+            _stopping = true;
+        }
+        _condition.notify_all();
         _threadGroup.join_all();
         _glContext.reset();
     }
 
-
     void submitWork( ExecutablePtr executable )
     {
-        _workQueue.pushFront( executable );
+        const ExecutionPriority priority = executable->getPriority();
+        WorkItem item = new Task( std::move( executable ));
+        Worker* worker = _current;
+        if( worker && &worker->pool == this && priority == PRIORITY_NORMAL )
+            worker->deque.push( item );
+        else
+        {
+            ScopedLock lock( _injectionMutex );
+            _injected[ priority ].push_back( item );
+            ++_nInjected[ priority ];
+        }
+
+        ++_pending;
+        if( _sleeping > 0 )
+        {
+            ScopedLock lock( _mutex );
+            _condition.notify_one();
+        }
     }
 
     size_t getSize() const
@@ -86,17 +286,139 @@ struct Workers::Impl
         return _threadGroup.size();
     }
 
+    /** @return the next item to execute or nullptr if the pool is stopped */
+    WorkItem _next( const size_t index )
+    {
+        while( true )
+        {
+            if( WorkItem item = _find( index ))
+            {
+                --_pending;
+                return item;
+            }
+
+            // An item is in flight between being counted and being visible
+            if( _pending > 0 )
+            {
+                boost::this_thread::yield();
+                continue;
+            }
+
+            ScopedLock lock( _mutex );
+            ++_sleeping;
+            while( _pending == 0 && !_stopping )
+                _condition.wait( lock );
+            --_sleeping;
+
+            if( _pending == 0 && _stopping )
+                return nullptr;
+        }
+    }
+
+    WorkItem _find( const size_t index )
+    {
+        WorkStealingDeque& own = _queues[ index ]->deque;
+        if( WorkItem item = _takeInjected( own, PRIORITY_HIGH ))
+            return item;
+
+        if( WorkItem item = own.take( ))
+            return item;
+
+        if( WorkItem item = _takeInjected( own, PRIORITY_NORMAL ))
+            return item;
+
+        const size_t nQueues = _queues.size();
+        for( size_t i = 1; i < nQueues; ++i )
+        {
+            if( WorkItem item = _queues[( index + i ) % nQueues ]->deque.steal( ))
+                return item;
+        }
+        return _takeInjected( own, PRIORITY_BACKGROUND );
+    }
+
+    WorkItem _takeInjected( WorkStealingDeque& own,
+                            const ExecutionPriority priority )
+    {
+        if( _nInjected[ priority ] == 0 )
+            return nullptr;
+
+        ScopedLock lock( _injectionMutex );
+        std::deque< WorkItem >& injected = _injected[ priority ];
+        if( injected.empty( ))
+            return nullptr;
+
+        WorkItem item = injected.front();
+        injected.pop_front();
+        --_nInjected[ priority ];
+
+        // Move a fair share of normal work into the own deque, where idle
+        // workers steal it
+        if( priority != PRIORITY_NORMAL )
+            return item;
+
+        const size_t batch = std::min( injected.size() / _queues.size(),
+                                       maxInjectionBatch );
+        for( size_t i = 0; i < batch; ++i )
+        {
+            own.push( injected.front( ));
+            injected.pop_front();
+        }
+        _nInjected[ priority ] -= batch;
+        return item;
+    }
+
+    void _setAffinity( const size_t index ) const
+    {
+        switch( _affinity )
+        {
+        case AFFINITY_CORE:
+        {
+            const size_t nCores =
+                    std::max( boost::thread::hardware_concurrency(), 1u );
+            lunchbox::Thread::setAffinity( lunchbox::Thread::CORE +
+                                           int32_t(( _node + index ) % nCores ));
+            break;
+        }
+        case AFFINITY_NUMA:
+            lunchbox::Thread::setAffinity( lunchbox::Thread::SOCKET +
+                                           int32_t( _node ));
+            break;
+        case AFFINITY_NONE:
+        default:
+            break;
+        }
+    }
+
     Workers& _workers;
-    lunchbox::MTQueue< ExecutablePtr > _workQueue;
+    std::vector< std::unique_ptr< Worker >> _queues;
+    std::deque< WorkItem > _injected[ nPriorities ];
+    std::atomic< size_t > _nInjected[ nPriorities ];
+    boost::mutex _injectionMutex;
     boost::thread_group _threadGroup;
     ConstGLContextPtr _glContext;
+    const Affinity _affinity;
+    const uint32_t _node;
+
+    std::atomic< size_t > _pending;
+    std::atomic< size_t > _sleeping;
+    bool _stopping;
+    boost::mutex _mutex;
+    boost::condition_variable _condition;
+
+    static thread_local Worker* _current;
 };
 
+thread_local Workers::Impl::Worker* Workers::Impl::_current = nullptr;
+
 Workers::Workers( const size_t nThreads,
-                  ConstGLContextPtr glContext )
+                  ConstGLContextPtr glContext,
+                  const Affinity affinity,
+                  const uint32_t node )
     : _impl( new Workers::Impl( *this,
                                 nThreads,
-                                glContext ))
+                                glContext,
+                                affinity,
+                                node ))
 {}
 
 Workers::~Workers()
@@ -112,4 +434,9 @@ size_t Workers::getSize() const
     return _impl->getSize();
 }
 
+size_t Workers::getQueueDepth() const
+{
+    return _impl->_pending;
+}
+
 }
@@ -27,25 +27,49 @@ namespace livre
 {
 
 /**
- * A simple thread pool
+ * A work-stealing thread pool.
+ *
+ * Every worker owns a Chase-Lev deque: executables scheduled from a worker
+ * thread are pushed to and taken from the bottom of its own deque (LIFO),
+ * idle workers steal the oldest entries from the top of the other deques
+ * (FIFO). Executables scheduled from outside the pool go to a shared
+ * injection queue, from which a worker moves a batch into its own deque so
+ * that the remaining workers can steal from it.
+ *
+ * High priority executables are picked up before any other work, background
+ * ones only when there is nothing else to do. Cancelled executables are
+ * not executed, their cancel() is called instead.
  */
 class Workers
 {
 public:
 
+    /** CPU placement of the worker threads */
+    enum Affinity
+    {
+        AFFINITY_NONE, //!< Threads are placed by the OS
+        AFFINITY_CORE, //!< Worker i is bound to core ( node + i ) % nCores
+        AFFINITY_NUMA  //!< All workers are bound to the NUMA node 'node'
+    };
+
     /**
      * Constructs a thread pool given the number of threads.
      * @param nThreads is the number of threads.
      * @param glContext if given, the threads can share this
      * context.
+     * @param affinity the CPU placement of the worker threads
+     * @param node the first core or the NUMA node, depending on affinity
      */
     LIVRECORE_API Workers( size_t nThreads = 4,
-                           ConstGLContextPtr glContext = ConstGLContextPtr( ));
+                           ConstGLContextPtr glContext = ConstGLContextPtr(),
+                           Affinity affinity = AFFINITY_NONE,
+                           uint32_t node = 0 );
     LIVRECORE_API ~Workers();
 
     /**
      * Submitted executable is scheduled to the execution
-     * queue.
+     * queue. It is safe to call this from any thread, including
+     * the worker threads of this pool.
      * @param executable is executed by thread pool.
      */
     LIVRECORE_API void schedule( ExecutablePtr executable );
@@ -55,6 +79,12 @@ public:
      */
     LIVRECORE_API size_t getSize() const;
 
+    /**
+     * @return the number of scheduled executables which are not picked up by
+     * a worker yet.
+     */
+    LIVRECORE_API size_t getQueueDepth() const;
+
 private:
 
     struct Impl;
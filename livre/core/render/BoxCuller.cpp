@@ -0,0 +1,135 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/render/BoxCuller.h>
+
+#include <cmath>
+
+#ifdef __AVX__
+#  include <immintrin.h>
+#elif defined __SSE__
+#  include <xmmintrin.h>
+#endif
+
+namespace livre
+{
+
+BoxCuller::BoxCuller( const std::vector< Plane >& planes )
+{
+    for( const Plane& plane: planes )
+    {
+        _normalX.push_back( plane[ 0 ]);
+        _normalY.push_back( plane[ 1 ]);
+        _normalZ.push_back( plane[ 2 ]);
+        _d.push_back( plane[ 3 ]);
+        _absNormalX.push_back( std::abs( plane[ 0 ]));
+        _absNormalY.push_back( std::abs( plane[ 1 ]));
+        _absNormalZ.push_back( std::abs( plane[ 2 ]));
+    }
+}
+
+BoxCuller::~BoxCuller()
+{}
+
+uint32_t BoxCuller::cull( const BoxBatch& boxes ) const
+{
+    // A box is culled by a plane if !( distance - radius >= 0 ||
+    // distance + radius > 0 ), with the distance of its center and the radius
+    // of its extent projected on the normal
+    const uint32_t all = ( 1u << boxes.size ) - 1u;
+    uint32_t culled = 0;
+    for( size_t i = 0; i < _normalX.size() && culled != all; ++i )
+    {
+#ifdef __AVX__
+        const __m256 distance =
+            _mm256_add_ps( _mm256_add_ps( _mm256_add_ps(
+                _mm256_mul_ps( _mm256_set1_ps( _normalX[ i ]),
+                               _mm256_load_ps( boxes.centerX )),
+                _mm256_mul_ps( _mm256_set1_ps( _normalY[ i ]),
+                               _mm256_load_ps( boxes.centerY ))),
+                _mm256_mul_ps( _mm256_set1_ps( _normalZ[ i ]),
+                               _mm256_load_ps( boxes.centerZ ))),
+                _mm256_set1_ps( _d[ i ]));
+        const __m256 radius =
+            _mm256_add_ps( _mm256_add_ps(
+                _mm256_mul_ps( _mm256_set1_ps( _absNormalX[ i ]),
+                               _mm256_load_ps( boxes.extentX )),
+                _mm256_mul_ps( _mm256_set1_ps( _absNormalY[ i ]),
+                               _mm256_load_ps( boxes.extentY ))),
+                _mm256_mul_ps( _mm256_set1_ps( _absNormalZ[ i ]),
+                               _mm256_load_ps( boxes.extentZ )));
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 outside =
+            _mm256_and_ps( _mm256_cmp_ps( _mm256_sub_ps( distance, radius ),
+                                          zero, _CMP_LT_OQ ),
+                           _mm256_cmp_ps( _mm256_add_ps( distance, radius ),
+                                          zero, _CMP_LE_OQ ));
+        culled |= uint32_t( _mm256_movemask_ps( outside ));
+#elif defined __SSE__
+        const __m128 normalX = _mm_set1_ps( _normalX[ i ]);
+        const __m128 normalY = _mm_set1_ps( _normalY[ i ]);
+        const __m128 normalZ = _mm_set1_ps( _normalZ[ i ]);
+        const __m128 d = _mm_set1_ps( _d[ i ]);
+        const __m128 absNormalX = _mm_set1_ps( _absNormalX[ i ]);
+        const __m128 absNormalY = _mm_set1_ps( _absNormalY[ i ]);
+        const __m128 absNormalZ = _mm_set1_ps( _absNormalZ[ i ]);
+        const __m128 zero = _mm_setzero_ps();
+        for( size_t j = 0; j < boxes.size; j += 4 )
+        {
+            const __m128 distance =
+                _mm_add_ps( _mm_add_ps( _mm_add_ps(
+                    _mm_mul_ps( normalX, _mm_load_ps( boxes.centerX + j )),
+                    _mm_mul_ps( normalY, _mm_load_ps( boxes.centerY + j ))),
+                    _mm_mul_ps( normalZ, _mm_load_ps( boxes.centerZ + j ))), d );
+            const __m128 radius =
+                _mm_add_ps( _mm_add_ps(
+                    _mm_mul_ps( absNormalX, _mm_load_ps( boxes.extentX + j )),
+                    _mm_mul_ps( absNormalY, _mm_load_ps( boxes.extentY + j ))),
+                    _mm_mul_ps( absNormalZ, _mm_load_ps( boxes.extentZ + j )));
+            const __m128 outside =
+                _mm_and_ps( _mm_cmplt_ps( _mm_sub_ps( distance, radius ), zero ),
+                            _mm_cmple_ps( _mm_add_ps( distance, radius ), zero ));
+            culled |= uint32_t( _mm_movemask_ps( outside )) << j;
+        }
+#else
+        for( size_t j = 0; j < boxes.size; ++j )
+        {
+            const float distance = _normalX[ i ] * boxes.centerX[ j ] +
+                                   _normalY[ i ] * boxes.centerY[ j ] +
+                                   _normalZ[ i ] * boxes.centerZ[ j ] + _d[ i ];
+            const float radius = _absNormalX[ i ] * boxes.extentX[ j ] +
+                                 _absNormalY[ i ] * boxes.extentY[ j ] +
+                                 _absNormalZ[ i ] * boxes.extentZ[ j ];
+            if( distance - radius < 0.f && distance + radius <= 0.f )
+                culled |= 1u << j;
+        }
+#endif
+    }
+    return culled & all;
+}
+
+bool BoxCuller::isCulled( const Boxf& box ) const
+{
+    // Same rounding as for the batches
+    BoxBatch boxes;
+    boxes.add( box );
+    return cull( boxes ) != 0;
+}
+
+}
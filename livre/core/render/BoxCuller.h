@@ -0,0 +1,109 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _BoxCuller_h_
+#define _BoxCuller_h_
+
+#include <livre/core/api.h>
+#include <livre/core/types.h>
+
+namespace livre
+{
+
+/**
+ * Axis aligned boxes in structure of arrays form, the input of the batched
+ * culling. A batch holds the children of a node.
+ */
+struct BoxBatch
+{
+    static const size_t maxSize = 8;
+
+    BoxBatch()
+        : size( 0 )
+    {
+        std::fill( centerX, centerX + maxSize, 0.f );
+        std::fill( centerY, centerY + maxSize, 0.f );
+        std::fill( centerZ, centerZ + maxSize, 0.f );
+        std::fill( extentX, extentX + maxSize, 0.f );
+        std::fill( extentY, extentY + maxSize, 0.f );
+        std::fill( extentZ, extentZ + maxSize, 0.f );
+    }
+
+    /** Appends a box to the batch, which must not be full. */
+    void add( const Boxf& box )
+    {
+        const Vector3f& center = box.getCenter();
+        const Vector3f& extent = box.getSize() * 0.5f;
+        centerX[ size ] = center[ 0 ];
+        centerY[ size ] = center[ 1 ];
+        centerZ[ size ] = center[ 2 ];
+        extentX[ size ] = extent[ 0 ];
+        extentY[ size ] = extent[ 1 ];
+        extentZ[ size ] = extent[ 2 ];
+        ++size;
+    }
+
+    void clear() { size = 0; }
+
+    alignas( 32 ) float centerX[ maxSize ];
+    alignas( 32 ) float centerY[ maxSize ];
+    alignas( 32 ) float centerZ[ maxSize ];
+    alignas( 32 ) float extentX[ maxSize ];
+    alignas( 32 ) float extentY[ maxSize ];
+    alignas( 32 ) float extentZ[ maxSize ];
+    size_t size;
+};
+
+/**
+ * Culls boxes against a set of planes, the frustum or the clip planes. A box
+ * is culled if it is entirely on the negative side of one of the planes, like
+ * for vmml::FrustumCuller and ClipPlanes::isClipped().
+ *
+ * Batches are tested with AVX or SSE, depending on the target of the build,
+ * for all boxes against one plane at a time.
+ */
+class BoxCuller
+{
+public:
+    /** @param planes the planes, with the inner side on the positive side */
+    LIVRECORE_API explicit BoxCuller( const std::vector< Plane >& planes );
+    LIVRECORE_API ~BoxCuller();
+
+    /** @return a mask of the culled boxes, with the bit i set for box i */
+    LIVRECORE_API uint32_t cull( const BoxBatch& boxes ) const;
+
+    /** @return true if the box is culled */
+    LIVRECORE_API bool isCulled( const Boxf& box ) const;
+
+    /** @return the number of planes */
+    size_t getPlaneCount() const { return _normalX.size(); }
+
+private:
+    // The planes in structure of arrays form
+    std::vector< float > _normalX;
+    std::vector< float > _normalY;
+    std::vector< float > _normalZ;
+    std::vector< float > _d;
+    std::vector< float > _absNormalX;
+    std::vector< float > _absNormalY;
+    std::vector< float > _absNormalZ;
+};
+
+}
+
+#endif // _BoxCuller_h_
@@ -0,0 +1,89 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/render/BrickCost.h>
+
+#include <algorithm>
+
+namespace livre
+{
+
+namespace
+{
+// Weight of a new measurement in the learned costs, so they follow changes
+// of the data and view within a few tens of frames
+const float learningRate = 0.1f;
+
+float learn( const float cost, const float time, const float amount )
+{
+    if( time <= 0.f || amount <= 0.f )
+        return cost;
+    return cost + learningRate * ( time / amount - cost );
+}
+}
+
+BrickCostModel::BrickCostModel( const float renderCost, const float uploadCost )
+    : _renderCost( renderCost )
+    , _uploadCost( uploadCost )
+{}
+
+void BrickCostModel::addFrame( const FrameCost& frameCost )
+{
+    _renderCost = learn( _renderCost, frameCost.renderTime,
+                         frameCost.renderedArea );
+    _uploadCost = learn( _uploadCost, frameCost.uploadTime,
+                         float( frameCost.uploadedBytes ) / LB_1MB );
+}
+
+float BrickCostModel::getCost( const float area, const size_t bytes ) const
+{
+    return _renderCost * area + _uploadCost * float( bytes ) / LB_1MB;
+}
+
+float getScreenArea( const Boxf& worldBox, const Matrix4f& mvpMatrix )
+{
+    const Vector3f& min = worldBox.getMin();
+    const Vector3f& max = worldBox.getMax();
+
+    Vector2f lower( 1.f, 1.f );
+    Vector2f upper( -1.f, -1.f );
+    for( size_t i = 0; i < 8; ++i )
+    {
+        const Vector4f corner( i & 1 ? max[0] : min[0],
+                               i & 2 ? max[1] : min[1],
+                               i & 4 ? max[2] : min[2], 1.f );
+        const Vector4f projected = mvpMatrix * corner;
+        if( projected[3] <= 0.f )
+            return 1.f;
+
+        for( size_t j = 0; j < 2; ++j )
+        {
+            const float value = projected[j] / projected[3];
+            lower[j] = std::min( lower[j], value );
+            upper[j] = std::max( upper[j], value );
+        }
+    }
+
+    // Only the part within the viewport [-1, 1] is rendered
+    const float width = std::min( upper[0], 1.f ) - std::max( lower[0], -1.f );
+    const float height = std::min( upper[1], 1.f ) - std::max( lower[1], -1.f );
+    return width > 0.f && height > 0.f ? width * height * .25f : 0.f;
+}
+
+}
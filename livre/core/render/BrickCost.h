@@ -0,0 +1,100 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _BrickCost_h_
+#define _BrickCost_h_
+
+#include <livre/core/api.h>
+#include <livre/core/types.h>
+
+namespace livre
+{
+
+/** The measured times and amounts of work of a rendered frame */
+struct FrameCost
+{
+    FrameCost()
+        : renderTime( 0.f )
+        , renderedArea( 0.f )
+        , uploadTime( 0.f )
+        , uploadedBytes( 0 )
+    {}
+
+    float renderTime; //!< Time in ms the bricks took to render
+    float renderedArea; //!< Sum of the viewport fractions of the bricks
+    float uploadTime; //!< Time in ms the bricks took to load and upload
+    uint64_t uploadedBytes; //!< Memory of the loaded and uploaded bricks
+};
+
+/**
+ * The BrickCostModel class estimates the time a brick takes to render and to
+ * upload, from the viewport area it projects to and its memory size. The
+ * cost per area and per byte are learned from the measured frames.
+ *
+ * The estimates are used to split the bricks between sort-last channels,
+ * which have to agree on them, so the learned costs have to be shared by the
+ * channels. The class is not thread safe.
+ */
+class BrickCostModel
+{
+public:
+    /**
+     * @param renderCost the initial rendering time in ms per viewport area
+     * @param uploadCost the initial upload time in ms per MB
+     */
+    LIVRECORE_API explicit BrickCostModel( float renderCost = 10.f,
+                                           float uploadCost = 1.f );
+
+    /**
+     * Adds the measurement of a frame. Costs of work not done in the frame
+     * are kept.
+     * @param frameCost the measured times and amounts of work
+     */
+    LIVRECORE_API void addFrame( const FrameCost& frameCost );
+
+    /**
+     * @param area the viewport fraction the brick projects to
+     * @param bytes the memory size of the brick
+     * @return the estimated time in ms the brick takes to render and upload
+     */
+    LIVRECORE_API float getCost( float area, size_t bytes ) const;
+
+    /** @return the rendering time in ms per viewport area */
+    float getRenderCost() const { return _renderCost; }
+
+    /** @return the upload time in ms per MB */
+    float getUploadCost() const { return _uploadCost; }
+
+private:
+    float _renderCost;
+    float _uploadCost;
+};
+
+/**
+ * @param worldBox the box of a brick in world space
+ * @param mvpMatrix the modelview projection matrix of the view
+ * @return the fraction of the viewport the box projects to, 1 if the box
+ *         reaches behind the eye
+ */
+LIVRECORE_API float getScreenArea( const Boxf& worldBox,
+                                   const Matrix4f& mvpMatrix );
+
+}
+
+#endif // _BrickCost_h_
@@ -0,0 +1,188 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/render/BrickOrder.h>
+
+#include <livre/core/data/DataSource.h>
+#include <livre/core/data/LODNode.h>
+#include <livre/core/data/NodeId.h>
+#include <livre/core/data/VolumeInformation.h>
+#include <livre/core/render/Frustum.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace livre
+{
+
+namespace
+{
+/**
+ * Traverses the octree of a regular tree front to back. Virtual levels above
+ * the root blocks make them the leaves of one octree.
+ */
+class OctreeOrder
+{
+public:
+    OctreeOrder( const VolumeInformation& volInfo, const Vector3f& eye )
+        : _rootLevels( 0 )
+    {
+        const uint32_t nRootBlocks = volInfo.rootNode.getBlockSize().find_max();
+        while(( 1u << _rootLevels ) < nRootBlocks )
+            ++_rootLevels;
+
+        // The eye in units of the root blocks, see
+        // DataSourcePlugin::internalNodeToLODNode()
+        for( size_t i = 0; i < 3; ++i )
+            _eye[ i ] = ( double( eye[ i ]) + volInfo.worldSize[ i ] * 0.5 ) *
+                        nRootBlocks;
+    }
+
+    /** Appends the bricks in [begin, end), in Morton order, front to back */
+    void order( const NodeIds::const_iterator begin,
+                const NodeIds::const_iterator end, NodeIds& ordered ) const
+    {
+        _traverse( begin, end, 0, Vector3ui( 0u ), ordered );
+    }
+
+private:
+    uint32_t _rootLevels;
+    std::array< double, 3 > _eye;
+
+    /** The bricks in [begin, end) are in the cell at the depth below the top */
+    void _traverse( NodeIds::const_iterator begin,
+                    const NodeIds::const_iterator end,
+                    const uint32_t depth, const Vector3ui& cell,
+                    NodeIds& ordered ) const
+    {
+        // A brick of the cell itself precedes the ones it overlaps
+        while( begin != end && begin->getLevel() + _rootLevels == depth )
+            ordered.push_back( *begin++ );
+
+        if( begin == end )
+            return;
+
+        // The children on the side of the split planes of the eye come first
+        const uint32_t childDepth = depth + 1;
+        const double scale = std::ldexp( 1.0,
+                                         int( childDepth ) - int( _rootLevels ));
+        uint32_t nearChild = 0;
+        for( size_t i = 0; i < 3; ++i )
+        {
+            if( _eye[ i ] * scale >= 2.0 * cell[ i ] + 1.0 )
+                nearChild |= 4u >> i;
+        }
+
+        // The bricks of each child are consecutive in Morton order
+        std::array< NodeIds::const_iterator, 9 > children;
+        children[ 0 ] = begin;
+        for( uint32_t child = 0; child < 8; ++child )
+        {
+            NodeIds::const_iterator i = children[ child ];
+            while( i != end && _getChildIndex( *i, childDepth ) == child )
+                ++i;
+            children[ child + 1 ] = i;
+        }
+
+        // Children closer to the eye along a split plane can not be occluded
+        // by the ones after them in this order
+        for( uint32_t i = 0; i < 8; ++i )
+        {
+            const uint32_t child = nearChild ^ i;
+            if( children[ child ] == children[ child + 1 ] )
+                continue;
+
+            const Vector3ui childCell( cell[ 0 ] * 2 + (( child >> 2 ) & 1u ),
+                                       cell[ 1 ] * 2 + (( child >> 1 ) & 1u ),
+                                       cell[ 2 ] * 2 + ( child & 1u ));
+            _traverse( children[ child ], children[ child + 1 ], childDepth,
+                       childCell, ordered );
+        }
+    }
+
+    /** @return the index of the child at the depth the brick is in */
+    uint32_t _getChildIndex( const NodeId& brick, const uint32_t depth ) const
+    {
+        const uint32_t shift = brick.getLevel() + _rootLevels - depth;
+        const Vector3ui& position = brick.getPosition();
+        return ((( position[ 0 ] >> shift ) & 1u ) << 2 ) |
+               ((( position[ 1 ] >> shift ) & 1u ) << 1 ) |
+                 (( position[ 2 ] >> shift ) & 1u );
+    }
+};
+
+NodeIds sortByDistance( const DataSource& dataSource, const NodeIds& bricks,
+                        const Frustum& frustum )
+{
+    const Matrix4f& mvMatrix = frustum.getMVMatrix();
+
+    std::vector< std::pair< float, NodeId >> keys;
+    keys.reserve( bricks.size( ));
+    for( const NodeId& brick: bricks )
+    {
+        const LODNode& lodNode = dataSource.getNode( brick );
+        keys.emplace_back(( mvMatrix * lodNode.getWorldBox().getCenter( )).length(),
+                          brick );
+    }
+    std::sort( keys.begin(), keys.end( ));
+
+    NodeIds ordered;
+    ordered.reserve( keys.size( ));
+    for( const auto& key: keys )
+        ordered.push_back( key.second );
+    return ordered;
+}
+}
+
+NodeIds orderFrontToBack( const DataSource& dataSource, const NodeIds& bricks,
+                          const Frustum& frustum )
+{
+    if( !dataSource.hasRegularTree( ))
+        return sortByDistance( dataSource, bricks, frustum );
+
+    NodeIds sorted;
+    if( !std::is_sorted( bricks.begin(), bricks.end(), mortonLess ))
+    {
+        sorted = bricks;
+        sortMorton( sorted );
+    }
+    const NodeIds& inMortonOrder = sorted.empty() ? bricks : sorted;
+
+    const OctreeOrder octreeOrder( dataSource.getVolumeInfo(),
+                                   frustum.getEyePos( ));
+    NodeIds ordered;
+    ordered.reserve( bricks.size( ));
+
+    // Time steps are consecutive in Morton order and traversed one by one
+    NodeIds::const_iterator begin = inMortonOrder.begin();
+    while( begin != inMortonOrder.end( ))
+    {
+        const uint32_t timeStep = begin->getTimeStep();
+        const NodeIds::const_iterator end =
+                std::find_if( begin, inMortonOrder.end(),
+                              [timeStep]( const NodeId& brick )
+                                  { return brick.getTimeStep() != timeStep; });
+        octreeOrder.order( begin, end, ordered );
+        begin = end;
+    }
+    return ordered;
+}
+
+}
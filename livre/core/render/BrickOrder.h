@@ -0,0 +1,50 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _BrickOrder_h_
+#define _BrickOrder_h_
+
+#include <livre/core/api.h>
+#include <livre/core/types.h>
+
+namespace livre
+{
+
+/**
+ * Orders the bricks front to back, so no brick is occluded by a brick after
+ * it.
+ *
+ * The bricks of regular trees are ordered by a traversal of the octree, which
+ * visits the children of each node in the order given by the side of its
+ * split planes the eye is on. The traversal needs no node lookups and is
+ * linear for bricks in Morton order. The bricks of irregular trees are sorted
+ * by the distance of their centers to the eye, looking up each node once.
+ *
+ * @param dataSource the data source of the bricks
+ * @param bricks the bricks, which must not overlap
+ * @param frustum the view
+ * @return the bricks in front to back order
+ */
+LIVRECORE_API NodeIds orderFrontToBack( const DataSource& dataSource,
+                                        const NodeIds& bricks,
+                                        const Frustum& frustum );
+
+}
+
+#endif // _BrickOrder_h_
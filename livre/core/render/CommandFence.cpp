@@ -0,0 +1,97 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/render/CommandFence.h>
+#include <livre/core/render/GLContext.h>
+
+#include <eq/gl.h>
+
+namespace livre
+{
+
+#define glewGetContext() GLContext::getCurrent()->glewGetContext()
+
+namespace
+{
+// Time in ns to wait on a fence before checking it again
+const GLuint64 fenceTimeout = 1000000;
+}
+
+struct CommandFence::Impl
+{
+    Impl()
+        : fence( GLEW_ARB_sync ? glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 )
+                               : nullptr )
+    {
+        // Flushed once, so the fence is guaranteed to signal also when it is
+        // waited on from another context
+        if( fence )
+            glFlush();
+        else
+            glFinish();
+    }
+
+    ~Impl()
+    {
+        if( fence && GLContext::getCurrent( ))
+            glDeleteSync( fence );
+    }
+
+    bool wait( const GLuint64 timeout )
+    {
+        if( !fence )
+            return true;
+
+        const GLenum result = glClientWaitSync( fence, 0, timeout );
+        if( result == GL_TIMEOUT_EXPIRED )
+            return false;
+
+        if( result == GL_WAIT_FAILED )
+        {
+            LBWARN << "Waiting on a GL fence failed, finishing the commands"
+                   << std::endl;
+            glFinish();
+        }
+        glDeleteSync( fence );
+        fence = nullptr;
+        return true;
+    }
+
+    GLsync fence;
+};
+
+CommandFence::CommandFence()
+    : _impl( new Impl )
+{}
+
+CommandFence::~CommandFence()
+{}
+
+bool CommandFence::isSignaled()
+{
+    return _impl->wait( 0 );
+}
+
+void CommandFence::wait()
+{
+    while( !_impl->wait( fenceTimeout ))
+        ;
+}
+
+}
@@ -0,0 +1,66 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _CommandFence_h_
+#define _CommandFence_h_
+
+#include <livre/core/api.h>
+#include <livre/core/types.h>
+
+namespace livre
+{
+
+/**
+ * The CommandFence class tracks the completion of the GL commands issued in
+ * the current context before its construction, e.g. texture uploads which have
+ * to complete before the textures are used in other shared contexts.
+ *
+ * The fence can be checked and waited on from any context sharing the objects
+ * of the context it was created in. Without sync object support, the commands
+ * are finished on construction.
+ */
+class CommandFence
+{
+public:
+    /** Inserts the fence in the current GL context and flushes the commands. */
+    LIVRECORE_API CommandFence();
+
+    /** Deletes the fence, if a GL context is current. */
+    LIVRECORE_API ~CommandFence();
+
+    /**
+     * @return true if the commands before the fence have completed, without
+     * blocking.
+     */
+    LIVRECORE_API bool isSignaled();
+
+    /** Blocks until the commands before the fence have completed. */
+    LIVRECORE_API void wait();
+
+private:
+    CommandFence( const CommandFence& ) = delete;
+    CommandFence& operator=( const CommandFence& ) = delete;
+
+    struct Impl;
+    std::unique_ptr< Impl > _impl;
+};
+
+}
+
+#endif // _CommandFence_h_
@@ -0,0 +1,87 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/render/FrustumPredictor.h>
+#include <livre/core/render/Frustum.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace livre
+{
+
+FrustumPredictor::FrustumPredictor( const size_t historySize,
+                                    const float tolerance )
+    : _historySize( std::max( historySize, size_t( 2 )))
+    , _tolerance( tolerance )
+    , _predictable( false )
+{}
+
+void FrustumPredictor::update( const Frustum& frustum )
+{
+    const Matrix4f& modelView = frustum.getMVMatrix();
+    _projection = frustum.getProjMatrix();
+    if( !_modelViews.empty() &&
+        modelView.equals( _modelViews.back(),
+                          std::numeric_limits< float >::epsilon( )))
+    {
+        return;
+    }
+
+    _modelViews.push_back( modelView );
+    if( _modelViews.size() > _historySize )
+        _modelViews.pop_front();
+
+    _predictable = false;
+    if( _modelViews.size() < _historySize )
+        return;
+
+    // The motion maps the modelview of a frame to the one of the next frame
+    const size_t last = _modelViews.size() - 1;
+    _motion = _modelViews[ last ] * _modelViews[ last - 1 ].inverse();
+    for( size_t i = 1; i < last; ++i )
+    {
+        const Matrix4f motion = _modelViews[ i ] * _modelViews[ i - 1 ].inverse();
+        if( !motion.equals( _motion, _tolerance ))
+            return;
+    }
+    _predictable = true;
+}
+
+Frustum FrustumPredictor::predict( const uint32_t nFrames ) const
+{
+    if( _modelViews.empty( ))
+        LBTHROW( std::runtime_error( "No frustum to predict from" ));
+
+    Matrix4f modelView = _modelViews.back();
+    if( _predictable )
+    {
+        for( uint32_t i = 0; i < nFrames; ++i )
+            modelView = _motion * modelView;
+    }
+    return Frustum( modelView, _projection );
+}
+
+void FrustumPredictor::clear()
+{
+    _modelViews.clear();
+    _predictable = false;
+}
+
+}
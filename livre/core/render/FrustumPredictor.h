@@ -0,0 +1,78 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _FrustumPredictor_h_
+#define _FrustumPredictor_h_
+
+#include <livre/core/api.h>
+#include <livre/core/types.h>
+
+namespace livre
+{
+
+/**
+ * The FrustumPredictor class extrapolates the camera of the next frames from
+ * the frusta of the last rendered frames. It assumes the motion between two
+ * frames stays the same, which holds while the camera orbits, pans or zooms
+ * steadily, and predicts nothing while the motion changes.
+ *
+ * Frames rendered again with the same frustum, e.g. once data arrives, are
+ * not a camera motion and are ignored. The class is not thread safe.
+ */
+class FrustumPredictor
+{
+public:
+    /**
+     * @param historySize the number of frames whose motion has to agree
+     * before predicting, at least two
+     * @param tolerance the largest difference of the matrix elements of the
+     * motions still considered the same
+     */
+    LIVRECORE_API explicit FrustumPredictor( size_t historySize = 3,
+                                             float tolerance = 0.02f );
+
+    /** Adds the frustum of a rendered frame. */
+    LIVRECORE_API void update( const Frustum& frustum );
+
+    /** @return true if the camera moves steadily over the last frames */
+    bool isPredictable() const { return _predictable; }
+
+    /**
+     * @param nFrames the number of frames to look ahead
+     * @return the frustum expected nFrames after the last update, the last
+     * one if the motion is not predictable
+     * @throws std::runtime_error if no frustum has been added
+     */
+    LIVRECORE_API Frustum predict( uint32_t nFrames ) const;
+
+    /** Forgets the frusta added before. */
+    LIVRECORE_API void clear();
+
+private:
+    const size_t _historySize;
+    const float _tolerance;
+    std::deque< Matrix4f > _modelViews;
+    Matrix4f _projection;
+    Matrix4f _motion;
+    bool _predictable;
+};
+
+}
+
+#endif // _FrustumPredictor_h_
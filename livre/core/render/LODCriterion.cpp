@@ -0,0 +1,365 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/render/LODCriterion.h>
+
+#include <livre/core/data/LODNode.h>
+#include <livre/core/render/BoxCuller.h>
+#include <livre/core/render/ClipPlanes.h>
+#include <livre/core/render/Frustum.h>
+
+#include <cmath>
+#include <limits>
+
+namespace livre
+{
+
+namespace
+{
+const float infinity = std::numeric_limits< float >::infinity();
+
+// The planes of the frustum culling, and the near plane used for the distance
+// of the screen space error
+const size_t nFrustumPlanes = 6;
+const size_t nMotionPlanes = nFrustumPlanes + 1;
+
+/** @return the signed distance of the farthest point of the box on the positive side */
+float getMaxDistance( const Plane& plane, const Boxf& box )
+{
+    const Vector3f& center = box.getCenter();
+    const Vector3f& extent = box.getSize() * 0.5f;
+    return plane[ 0 ] * center[ 0 ] + plane[ 1 ] * center[ 1 ] +
+           plane[ 2 ] * center[ 2 ] + plane[ 3 ] +
+           extent[ 0 ] * std::abs( plane[ 0 ]) +
+           extent[ 1 ] * std::abs( plane[ 1 ]) +
+           extent[ 2 ] * std::abs( plane[ 2 ]);
+}
+
+/** @return the frustum planes in world space, normalized to measure distances */
+std::vector< Plane > getFrustumPlanes( const Frustum& frustum )
+{
+    std::vector< Plane > planes( nFrustumPlanes );
+    const Matrix4f& mvp = frustum.getMVPMatrix();
+    for( size_t i = 0; i < nFrustumPlanes; ++i )
+    {
+        const size_t row = i / 2;
+        const float sign = ( i % 2 == 0 ) ? 1.f : -1.f;
+        Plane& plane = planes[ i ];
+        for( size_t j = 0; j < 4; ++j )
+            plane[ j ] = mvp( 3, j ) + sign * mvp( row, j );
+
+        const float length = std::sqrt( plane[ 0 ] * plane[ 0 ] +
+                                        plane[ 1 ] * plane[ 1 ] +
+                                        plane[ 2 ] * plane[ 2 ]);
+        plane /= length;
+    }
+    return planes;
+}
+
+std::vector< Plane > getClipPlanes( const ClipPlanes& clipPlanes )
+{
+    std::vector< Plane > planes;
+    for( const auto& plane: clipPlanes.getPlanes( ))
+    {
+        const float* normal = plane.getNormal();
+        planes.push_back( Plane( normal[ 0 ], normal[ 1 ], normal[ 2 ],
+                                 plane.getD( )));
+    }
+    return planes;
+}
+}
+
+struct LODCriterion::Impl
+{
+    Impl( const Frustum& frustum,
+          const uint32_t windowHeight,
+          const float screenSpaceError,
+          const uint32_t minLOD,
+          const uint32_t maxLOD,
+          const uint32_t depth,
+          const ClipPlanes& clipPlanes )
+        : _frustum( frustum )
+        , _windowHeight( windowHeight )
+        , _screenSpaceError( screenSpaceError )
+        , _minLOD( minLOD )
+        , _maxLOD( maxLOD )
+        , _depth( depth )
+        , _clipPlanes( clipPlanes )
+        , _worldSpacePerPixel(( frustum.top() - frustum.bottom( )) / windowHeight )
+        , _planes( getFrustumPlanes( frustum ))
+        , _frustumCuller( _planes )
+        , _clipCuller( getClipPlanes( clipPlanes ))
+    {
+        _planes.push_back( frustum.getNearPlane( ));
+    }
+
+    /**
+     * @return the distance of the box to the near plane for the screen space
+     *         error, and the distance to the near plane of the nearest point
+     *         in slack, zero if the box intersects it
+     */
+    float getDistance( const Boxf& worldBox, float& slack ) const
+    {
+        Vector3f vmin, vmax;
+        const Plane& nearPlane = _frustum.getNearPlane();
+
+        worldBox.computeNearFar( nearPlane, vmin, vmax );
+
+        Vector4f hVmin = vmin;
+        hVmin[ 3 ] = 1.0f;
+
+        Vector4f hVmax = vmax;
+        hVmax[ 3 ] = 1.0f;
+
+        slack = std::max( std::min( nearPlane.dot( hVmin ),
+                                    nearPlane.dot( hVmax )), 0.f );
+
+        // The bounding box intersects the plane
+        if( nearPlane.dot( hVmin ) < 0 || nearPlane.dot( hVmax ) < 0 )
+        {
+            // Where eye direction intersects with near plane
+            vmin = _frustum.getEyePos() - _frustum.getViewDir() * _frustum.nearPlane();
+            hVmin = vmin;
+            hVmin[ 3 ] = 1.0f;
+        }
+        return std::abs( nearPlane.dot( hVmin ));
+    }
+
+    float getPixelPerVoxel( const LODNode& node ) const
+    {
+        const Vector3f& voxelBox = node.getVoxelBox().getSize();
+        const Vector3f& worldSpacePerVoxel = node.getWorldBox().getSize() / voxelBox;
+        return worldSpacePerVoxel.find_min() / _worldSpacePerPixel;
+    }
+
+    LODVisibility evaluate( const LODNode& node, float* slack ) const
+    {
+        const Boxf& worldBox = node.getWorldBox();
+        return evaluate( node, _clipCuller.isCulled( worldBox ),
+                         _frustumCuller.isCulled( worldBox ), slack );
+    }
+
+    void evaluate( const LODNode* nodes, const size_t count,
+                   LODVisibility* visibilities, float* slacks ) const
+    {
+        LBASSERT( count <= BoxBatch::maxSize );
+        BoxBatch boxes;
+        for( size_t i = 0; i < count; ++i )
+            boxes.add( nodes[ i ].getWorldBox( ));
+
+        const uint32_t clipped = _clipCuller.cull( boxes );
+        const uint32_t outside = _frustumCuller.cull( boxes );
+        for( size_t i = 0; i < count; ++i )
+        {
+            if( !nodes[ i ].isValid( ))
+            {
+                visibilities[ i ] = LOD_REFINED;
+                if( slacks )
+                    slacks[ i ] = infinity;
+                continue;
+            }
+
+            visibilities[ i ] = evaluate( nodes[ i ], ( clipped >> i ) & 1u,
+                                          ( outside >> i ) & 1u,
+                                          slacks ? slacks + i : nullptr );
+        }
+    }
+
+    /** @param slack if set, returns the slack of the outcome */
+    LODVisibility evaluate( const LODNode& node, const bool clipped,
+                            const bool outside, float* slack ) const
+    {
+        const Boxf& worldBox = node.getWorldBox();
+        if( clipped )
+        {
+            if( slack )
+                *slack = infinity; // the clip planes do not move with the view
+            return LOD_CULLED;
+        }
+
+        if( outside )
+        {
+            // Visible once the box is back on the inner side of all planes
+            if( slack )
+            {
+                *slack = 0.f;
+                for( size_t i = 0; i < nFrustumPlanes; ++i )
+                    *slack = std::max( *slack,
+                                       -getMaxDistance( _planes[ i ], worldBox ));
+            }
+            return LOD_CULLED;
+        }
+
+        float frustumSlack = infinity;
+        if( slack )
+        {
+            for( size_t i = 0; i < nFrustumPlanes; ++i )
+                frustumSlack = std::min( frustumSlack,
+                                         getMaxDistance( _planes[ i ], worldBox ));
+            *slack = std::max( frustumSlack, 0.f );
+        }
+
+        const uint32_t level = node.getRefLevel();
+        if( level == _maxLOD || level == _depth - 1 )
+            return LOD_SELECTED;
+
+        if( level < _minLOD )
+            return LOD_REFINED;
+
+        float nearSlack;
+        const float distance = getDistance( worldBox, nearSlack );
+        const float pixelPerVoxel = getPixelPerVoxel( node );
+        const float n = _frustum.nearPlane();
+        const bool lodVisible =
+                pixelPerVoxel * n / ( n + distance ) <= _screenSpaceError;
+
+        // The distance from which on the node has enough detail
+        if( slack )
+        {
+            const float lodDistance = pixelPerVoxel * n / _screenSpaceError - n;
+            *slack = std::min( *slack, std::min( nearSlack,
+                                                 std::abs( distance - lodDistance )));
+        }
+        return lodVisible ? LOD_SELECTED : LOD_REFINED;
+    }
+
+    float getScreenSpaceError( const LODNode& node ) const
+    {
+        float nearSlack;
+        const float distance = getDistance( node.getWorldBox(), nearSlack );
+        const float n = _frustum.nearPlane();
+        return getPixelPerVoxel( node ) * n / ( n + distance );
+    }
+
+    bool isCoherent( const Impl& previous ) const
+    {
+        if( _windowHeight != previous._windowHeight ||
+            _screenSpaceError != previous._screenSpaceError ||
+            _minLOD != previous._minLOD || _maxLOD != previous._maxLOD ||
+            _depth != previous._depth ||
+            _frustum.getProjMatrix() != previous._frustum.getProjMatrix( ))
+        {
+            return false;
+        }
+
+        const auto& planes = _clipPlanes.getPlanes();
+        const auto& previousPlanes = previous._clipPlanes.getPlanes();
+        if( planes.size() != previousPlanes.size( ))
+            return false;
+
+        for( size_t i = 0; i < planes.size(); ++i )
+        {
+            const float* normal = planes[ i ].getNormal();
+            const float* previousNormal = previousPlanes[ i ].getNormal();
+            if( !std::equal( normal, normal + 3, previousNormal ) ||
+                planes[ i ].getD() != previousPlanes[ i ].getD( ))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    float getMotion( const Impl& previous, const float radius ) const
+    {
+        // The distance of a point p to a plane changes by at most
+        // |normal - previousNormal| * |p| + |d - previousD|
+        float motion = 0.f;
+        for( size_t i = 0; i < nMotionPlanes; ++i )
+        {
+            const Plane& plane = _planes[ i ];
+            const Plane& previousPlane = previous._planes[ i ];
+            const Vector3f normalMotion( plane[ 0 ] - previousPlane[ 0 ],
+                                         plane[ 1 ] - previousPlane[ 1 ],
+                                         plane[ 2 ] - previousPlane[ 2 ]);
+            motion = std::max( motion, normalMotion.length() * radius +
+                                       std::abs( plane[ 3 ] - previousPlane[ 3 ]));
+        }
+        return motion;
+    }
+
+    const Frustum _frustum;
+    const uint32_t _windowHeight;
+    const float _screenSpaceError;
+    const uint32_t _minLOD;
+    const uint32_t _maxLOD;
+    const uint32_t _depth;
+    const ClipPlanes _clipPlanes;
+    const float _worldSpacePerPixel;
+    std::vector< Plane > _planes; //!< frustum planes and near plane
+    const BoxCuller _frustumCuller;
+    const BoxCuller _clipCuller;
+};
+
+LODCriterion::LODCriterion( const Frustum& frustum,
+                            const uint32_t windowHeight,
+                            const float screenSpaceError,
+                            const uint32_t minLOD,
+                            const uint32_t maxLOD,
+                            const uint32_t depth,
+                            const ClipPlanes& clipPlanes )
+    : _impl( new LODCriterion::Impl( frustum, windowHeight, screenSpaceError,
+                                     minLOD, maxLOD, depth, clipPlanes ))
+{}
+
+LODCriterion::LODCriterion( const LODCriterion& rhs )
+    : _impl( new LODCriterion::Impl( *rhs._impl ))
+{}
+
+LODCriterion::~LODCriterion()
+{}
+
+LODVisibility LODCriterion::evaluate( const LODNode& node ) const
+{
+    return _impl->evaluate( node, nullptr );
+}
+
+LODVisibility LODCriterion::evaluate( const LODNode& node, float& slack ) const
+{
+    return _impl->evaluate( node, &slack );
+}
+
+void LODCriterion::evaluate( const LODNode* nodes, const size_t count,
+                             LODVisibility* visibilities, float* slacks ) const
+{
+    _impl->evaluate( nodes, count, visibilities, slacks );
+}
+
+uint32_t LODCriterion::getMinLOD() const
+{
+    return _impl->_minLOD;
+}
+
+float LODCriterion::getScreenSpaceError( const LODNode& node ) const
+{
+    return _impl->getScreenSpaceError( node );
+}
+
+bool LODCriterion::isCoherent( const LODCriterion& previous ) const
+{
+    return _impl->isCoherent( *previous._impl );
+}
+
+float LODCriterion::getMotion( const LODCriterion& previous,
+                               const float radius ) const
+{
+    return _impl->getMotion( *previous._impl, radius );
+}
+
+}
@@ -0,0 +1,129 @@
+/* Copyright (c) 2015, EPFL/Blue Brain Project
+ *                     Stefan.Eilemann@epfl.ch
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _LODCriterion_h_
+#define _LODCriterion_h_
+
+#include <livre/core/api.h>
+#include <livre/core/types.h>
+
+namespace livre
+{
+
+/** The outcome of the LOD selection for a node */
+enum LODVisibility
+{
+    LOD_CULLED,   //!< Outside of the frustum or clipped
+    LOD_SELECTED, //!< Visible with enough detail, the node is rendered
+    LOD_REFINED   //!< Visible without enough detail, the children are selected
+};
+
+/**
+ * The view dependent criterion of the LOD selection: culls the nodes against
+ * the frustum and the clip planes, and compares their projected voxel size
+ * with the screen space error.
+ *
+ * Along with the outcome, the criterion computes a slack for a node, the
+ * distance the view has to move relative to the node before the outcome may
+ * change. With the motion between two criteria, this allows to revisit only
+ * the nodes whose slack is used up.
+ */
+class LODCriterion
+{
+public:
+    /**
+     * @param frustum frustum
+     * @param windowHeight height of window in pixels
+     * @param screenSpaceError number of voxels per pixel
+     * @param minLOD minimum level of detail
+     * @param maxLOD maximum level of detail
+     * @param depth depth of the node tree
+     * @param clipPlanes clip planes
+     */
+    LIVRECORE_API LODCriterion( const Frustum& frustum,
+                                uint32_t windowHeight,
+                                float screenSpaceError,
+                                uint32_t minLOD,
+                                uint32_t maxLOD,
+                                uint32_t depth,
+                                const ClipPlanes& clipPlanes );
+    LIVRECORE_API LODCriterion( const LODCriterion& rhs );
+    LIVRECORE_API ~LODCriterion();
+
+    /** @return the outcome of the selection for the node */
+    LIVRECORE_API LODVisibility evaluate( const LODNode& node ) const;
+
+    /**
+     * @param node the evaluated node
+     * @param slack returns the slack of the outcome, infinite if only a change
+     *        of the projection or of the parameters can change it
+     * @return the outcome of the selection for the node
+     */
+    LIVRECORE_API LODVisibility evaluate( const LODNode& node,
+                                          float& slack ) const;
+
+    /**
+     * Evaluates a batch of nodes, usually the children of a node, with the
+     * culling of all boxes at once. Invalid nodes are refined with an
+     * infinite slack.
+     * @param nodes the evaluated nodes, at most BoxBatch::maxSize
+     * @param count the number of nodes
+     * @param visibilities returns the outcome for each node
+     * @param slacks if set, returns the slack for each node
+     */
+    LIVRECORE_API void evaluate( const LODNode* nodes, size_t count,
+                                 LODVisibility* visibilities,
+                                 float* slacks = nullptr ) const;
+
+    /** @return the minimum level of detail */
+    LIVRECORE_API uint32_t getMinLOD() const;
+
+    /**
+     * @param node a visible node
+     * @return the size of a voxel of the node on the screen in pixels, which
+     *         is compared with the screen space error
+     */
+    LIVRECORE_API float getScreenSpaceError( const LODNode& node ) const;
+
+    /**
+     * @param previous the criterion of a previous view
+     * @return true if the criteria only differ by the modelview matrix, so the
+     *         slack of previous outcomes can be compared with getMotion()
+     */
+    LIVRECORE_API bool isCoherent( const LODCriterion& previous ) const;
+
+    /**
+     * @param previous the criterion of a previous, coherent view
+     * @param radius the distance of the farthest node from the origin
+     * @return an upper bound of the view motion relative to any node within
+     *         the radius, in the units of the slack
+     */
+    LIVRECORE_API float getMotion( const LODCriterion& previous,
+                                   float radius ) const;
+
+private:
+    LODCriterion& operator=( const LODCriterion& ) = delete;
+
+    struct Impl;
+    std::unique_ptr< Impl > _impl;
+};
+
+}
+
+#endif // _LODCriterion_h_
@@ -0,0 +1,350 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/render/LODCut.h>
+
+#include <livre/core/data/DataSource.h>
+#include <livre/core/data/LODNode.h>
+#include <livre/core/data/NodeId.h>
+#include <livre/core/data/VolumeInformation.h>
+#include <livre/core/render/BoxCuller.h>
+#include <livre/core/render/LODCriterion.h>
+
+#include <limits>
+#include <queue>
+#include <set>
+#include <unordered_map>
+
+namespace livre
+{
+
+namespace
+{
+const float infinity = std::numeric_limits< float >::infinity();
+
+// Margin of the slack for the rounding of the bounds
+const float slackTolerance = 0.01f;
+
+// Above this fraction of the cut to revisit, a full traversal is cheaper
+const float maxRevisitedRatio = 0.5f;
+
+struct MortonLess
+{
+    bool operator()( const NodeId& lhs, const NodeId& rhs ) const
+    {
+        return mortonLess( lhs, rhs );
+    }
+};
+
+struct Evaluation
+{
+    LODVisibility visibility;
+    float slack;
+};
+}
+
+struct LODCut::Impl
+{
+    // A node of the cut, where the traversal stops
+    struct Entry
+    {
+        LODVisibility visibility;
+        double deadline; //!< motion clock at which the outcome may change
+    };
+
+    typedef std::pair< double, Identifier > Deadline;
+    typedef std::priority_queue< Deadline, std::vector< Deadline >,
+                                 std::greater< Deadline >> Deadlines;
+
+    explicit Impl( const DataSource& dataSource )
+        : _dataSource( dataSource )
+        , _timeStep( 0 )
+        , _depth( 0 )
+        , _radius( 0.f )
+        , _motion( 0.0 )
+        , _evaluations( 0 )
+    {}
+
+    NodeIds update( const LODCriterion& criterion, const uint32_t timeStep )
+    {
+        ScopedLock lock( _mutex );
+        _evaluations = 0;
+
+        const uint32_t depth = _dataSource.getVolumeInfo().rootNode.getDepth();
+        if( !_criterion || timeStep != _timeStep || depth != _depth ||
+            !criterion.isCoherent( *_criterion ))
+        {
+            rebuild( criterion, timeStep );
+        }
+        else
+        {
+            const float motion = criterion.getMotion( *_criterion, _radius );
+            if( motion > 0.f )
+            {
+                _motion += motion;
+                if( !revisit( criterion ))
+                    rebuild( criterion, timeStep );
+            }
+        }
+
+        _evaluated.clear();
+        _criterion.reset( new LODCriterion( criterion ));
+        return NodeIds( _selected.begin(), _selected.end( ));
+    }
+
+    void clear()
+    {
+        ScopedLock lock( _mutex );
+        _criterion.reset();
+        _front.clear();
+        _selected.clear();
+        _deadlines = Deadlines();
+    }
+
+    void rebuild( const LODCriterion& criterion, const uint32_t timeStep )
+    {
+        const RootNode& rootNode = _dataSource.getVolumeInfo().rootNode;
+        _timeStep = timeStep;
+        _depth = rootNode.getDepth();
+        _motion = 0.0;
+        _front.clear();
+        _selected.clear();
+        _deadlines = Deadlines();
+
+        NodeIds roots;
+        const Vector3ui& blockSize = rootNode.getBlockSize();
+        for( uint32_t x = 0; x < blockSize.x(); ++x )
+            for( uint32_t y = 0; y < blockSize.y(); ++y )
+                for( uint32_t z = 0; z < blockSize.z(); ++z )
+                    roots.push_back( NodeId( 0, Vector3ui( x, y, z ), timeStep ));
+
+        // The motion bounds the change of the outcomes for the nodes within
+        // the radius, which covers the root blocks
+        Vector3f extent( 0.f );
+        for( const NodeId& root: roots )
+        {
+            const LODNode& node = _dataSource.getNode( root );
+            if( !node.isValid( ))
+                continue;
+
+            const Boxf& worldBox = node.getWorldBox();
+            for( size_t i = 0; i < 3; ++i )
+                extent[ i ] = std::max( extent[ i ],
+                                        std::max( std::abs( worldBox.getMin()[ i ]),
+                                                  std::abs( worldBox.getMax()[ i ])));
+        }
+        _radius = extent.length();
+
+        for( const NodeId& root: roots )
+            split( criterion, root, evaluate( criterion, root ), infinity );
+    }
+
+    /**
+     * Revisits the nodes of the cut whose slack is used up.
+     * @return false if a full traversal is cheaper
+     */
+    bool revisit( const LODCriterion& criterion )
+    {
+        NodeIds due;
+        while( !_deadlines.empty() && _deadlines.top().first <= _motion )
+        {
+            const Deadline& deadline = _deadlines.top();
+            const auto i = _front.find( deadline.second );
+            if( i != _front.end() && i->second.deadline == deadline.first )
+                due.push_back( NodeId( deadline.second ));
+            _deadlines.pop();
+        }
+
+        if( due.size() > _front.size() * maxRevisitedRatio )
+            return false;
+
+        for( const NodeId& nodeId: due )
+        {
+            // Already merged into an ancestor
+            if( _front.find( nodeId.getId( )) == _front.end( ))
+                continue;
+
+            // The traversal stops at the topmost terminal ancestor, and the
+            // slack of the refined ancestors bounds the one of the node
+            NodeId merged;
+            float ancestorSlack = infinity;
+            for( const NodeId& parentId: nodeId.getParentRange( ))
+            {
+                const Evaluation& parent = evaluateOnce( criterion, parentId );
+                if( parent.visibility == LOD_REFINED )
+                    ancestorSlack = std::min( ancestorSlack, parent.slack );
+                else
+                {
+                    merged = parentId;
+                    ancestorSlack = infinity;
+                }
+            }
+
+            if( merged.isValid( ))
+            {
+                erase( merged );
+                const Evaluation& evaluation = evaluateOnce( criterion, merged );
+                insert( merged, evaluation.visibility,
+                        std::min( evaluation.slack, ancestorSlack ));
+                continue;
+            }
+
+            erase( nodeId );
+            split( criterion, nodeId, evaluate( criterion, nodeId ), ancestorSlack );
+        }
+        return true;
+    }
+
+    /** Adds the cut of the subtree rooted at the node, like a traversal */
+    void split( const LODCriterion& criterion, const NodeId& nodeId,
+                const Evaluation& evaluation, const float ancestorSlack )
+    {
+        const float slack = std::min( evaluation.slack, ancestorSlack );
+        if( evaluation.visibility != LOD_REFINED )
+        {
+            insert( nodeId, evaluation.visibility, slack );
+            return;
+        }
+
+        // The children are evaluated as a batch
+        LODNode nodes[ BoxBatch::maxSize ];
+        LODVisibility visibilities[ BoxBatch::maxSize ];
+        float slacks[ BoxBatch::maxSize ];
+        size_t nChildren = 0;
+        for( const NodeId& childId: nodeId.getChildRange( ))
+            nodes[ nChildren++ ] = _dataSource.getNode( childId );
+        criterion.evaluate( nodes, nChildren, visibilities, slacks );
+        _evaluations += nChildren;
+
+        size_t i = 0;
+        for( const NodeId& childId: nodeId.getChildRange( ))
+        {
+            Evaluation child = { visibilities[ i ], slacks[ i ] };
+            if( !nodes[ i ].isValid( ))
+                child = getInvalid( childId );
+            split( criterion, childId, child, slack );
+            ++i;
+        }
+    }
+
+    /** Removes the nodes of the cut in the subtree rooted at the node */
+    void erase( const NodeId& nodeId )
+    {
+        const auto i = _front.find( nodeId.getId( ));
+        if( i != _front.end( ))
+        {
+            if( i->second.visibility == LOD_SELECTED )
+                _selected.erase( nodeId );
+            _front.erase( i );
+            return;
+        }
+
+        if( nodeId.getLevel() + 1 >= _depth )
+            return;
+
+        for( const NodeId& childId: nodeId.getChildRange( ))
+            erase( childId );
+    }
+
+    void insert( const NodeId& nodeId, const LODVisibility visibility,
+                 const float slack )
+    {
+        Entry& entry = _front[ nodeId.getId() ];
+        entry.visibility = visibility;
+        if( visibility == LOD_SELECTED )
+            _selected.insert( nodeId );
+
+        if( slack == infinity )
+        {
+            entry.deadline = infinity;
+            return;
+        }
+
+        entry.deadline = _motion + std::max( slack * ( 1.f - slackTolerance ), 0.f );
+        _deadlines.push( Deadline( entry.deadline, nodeId.getId( )));
+    }
+
+    /** Evaluates the ancestors shared by the revisited nodes only once */
+    const Evaluation& evaluateOnce( const LODCriterion& criterion,
+                                    const NodeId& nodeId )
+    {
+        const auto i = _evaluated.find( nodeId.getId( ));
+        if( i != _evaluated.end( ))
+            return i->second;
+        return _evaluated[ nodeId.getId() ] = evaluate( criterion, nodeId );
+    }
+
+    Evaluation evaluate( const LODCriterion& criterion, const NodeId& nodeId )
+    {
+        ++_evaluations;
+        const LODNode& node = _dataSource.getNode( nodeId );
+        if( !node.isValid( ))
+            return getInvalid( nodeId );
+
+        Evaluation evaluation;
+        evaluation.visibility = criterion.evaluate( node, evaluation.slack );
+        return evaluation;
+    }
+
+    /** Like the traversal, descends below the nodes without data */
+    Evaluation getInvalid( const NodeId& nodeId ) const
+    {
+        const Evaluation evaluation = { nodeId.getLevel() + 1 >= _depth ?
+                                            LOD_CULLED : LOD_REFINED, infinity };
+        return evaluation;
+    }
+
+    const DataSource& _dataSource;
+    std::unique_ptr< LODCriterion > _criterion; //!< of the last update
+    uint32_t _timeStep;
+    uint32_t _depth;
+    float _radius;
+    double _motion; //!< accumulated since the last full traversal
+    std::unordered_map< Identifier, Entry > _front;
+    std::set< NodeId, MortonLess > _selected;
+    Deadlines _deadlines;
+    std::unordered_map< Identifier, Evaluation > _evaluated; //!< per update
+    size_t _evaluations;
+    mutable boost::mutex _mutex;
+};
+
+LODCut::LODCut( const DataSource& dataSource )
+    : _impl( new LODCut::Impl( dataSource ))
+{}
+
+LODCut::~LODCut()
+{}
+
+NodeIds LODCut::update( const LODCriterion& criterion, const uint32_t timeStep )
+{
+    return _impl->update( criterion, timeStep );
+}
+
+void LODCut::clear()
+{
+    _impl->clear();
+}
+
+size_t LODCut::getEvaluations() const
+{
+    ScopedLock lock( _impl->_mutex );
+    return _impl->_evaluations;
+}
+
+}
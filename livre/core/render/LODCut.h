@@ -0,0 +1,77 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _LODCut_h_
+#define _LODCut_h_
+
+#include <livre/core/api.h>
+#include <livre/core/types.h>
+
+namespace livre
+{
+
+/**
+ * The cut of the node tree selected by the LOD criterion, kept across frames.
+ *
+ * The cut holds the nodes where a full traversal stops, selected or culled,
+ * with the slack of their outcome. An update with a coherent criterion only
+ * re-evaluates the nodes whose slack is used up by the camera motion since
+ * their evaluation: they are merged into their parent or split into their
+ * children in place, so the cost follows the change of the view rather than
+ * the size of the cut. A change of the projection, of the parameters or of
+ * the time step, or a motion which invalidates most of the cut rebuilds it
+ * with a full traversal.
+ *
+ * The selected nodes are the same as the ones of a full traversal with
+ * SelectVisibles. The update is thread safe.
+ */
+class LODCut
+{
+public:
+    /**
+     * @param dataSource the data source of the node tree
+     */
+    LIVRECORE_API explicit LODCut( const DataSource& dataSource );
+    LIVRECORE_API ~LODCut();
+
+    /**
+     * Updates the cut to the criterion.
+     * @param criterion the criterion of the current view
+     * @param timeStep the temporal position of the node tree
+     * @return the selected nodes in Morton order
+     */
+    LIVRECORE_API NodeIds update( const LODCriterion& criterion,
+                                  uint32_t timeStep );
+
+    /** Drops the cut, the next update does a full traversal. */
+    LIVRECORE_API void clear();
+
+    /** @return the number of nodes evaluated by the last update */
+    LIVRECORE_API size_t getEvaluations() const;
+
+private:
+    LODCut( const LODCut& ) = delete;
+    LODCut& operator=( const LODCut& ) = delete;
+
+    struct Impl;
+    std::unique_ptr< Impl > _impl;
+};
+
+}
+
+#endif // _LODCut_h_
@@ -0,0 +1,186 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/render/PixelBufferRing.h>
+#include <livre/core/render/CommandFence.h>
+#include <livre/core/render/GLContext.h>
+
+#include <eq/gl.h>
+
+#include <boost/thread/condition_variable.hpp>
+
+#include <cstring>
+#include <deque>
+#include <string>
+
+namespace livre
+{
+
+#define glewGetContext() GLContext::getCurrent()->glewGetContext()
+
+namespace
+{
+const GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+                            GL_MAP_COHERENT_BIT;
+}
+
+struct PixelBufferRing::Impl
+{
+    Impl( const size_t slotSize_, const size_t nSlots )
+        : slotSize( slotSize_ )
+        , buffer( 0 )
+        , mapped( nullptr )
+    {
+        const GLsizeiptr size = slotSize * nSlots;
+        glGenBuffers( 1, &buffer );
+        glBindBuffer( GL_PIXEL_UNPACK_BUFFER, buffer );
+        glBufferStorage( GL_PIXEL_UNPACK_BUFFER, size, nullptr, mapFlags );
+        mapped = static_cast< uint8_t* >(
+                     glMapBufferRange( GL_PIXEL_UNPACK_BUFFER, 0, size, mapFlags ));
+        glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+
+        if( !mapped )
+        {
+            glDeleteBuffers( 1, &buffer );
+            LBTHROW( std::runtime_error( "Unable to map the pixel buffer, "
+                                         "error number: " +
+                                         std::to_string( glGetError( ))));
+        }
+
+        for( size_t i = 0; i < nSlots; ++i )
+            freeSlots.push_back( i );
+    }
+
+    ~Impl()
+    {
+        if( !GLContext::getCurrent( ))
+            return;
+
+        for( PendingSlot& pending: pendingSlots )
+            pending.second->wait();
+
+        glBindBuffer( GL_PIXEL_UNPACK_BUFFER, buffer );
+        glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER );
+        glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+        glDeleteBuffers( 1, &buffer );
+    }
+
+    size_t acquire()
+    {
+        ScopedLock lock( mutex );
+        for( ;; )
+        {
+            // The slots are reused in the order of their uploads
+            while( !pendingSlots.empty() &&
+                   pendingSlots.front().second->isSignaled( ))
+            {
+                freeSlots.push_back( pendingSlots.front().first );
+                pendingSlots.pop_front();
+            }
+
+            if( !freeSlots.empty( ))
+            {
+                const size_t slot = freeSlots.front();
+                freeSlots.pop_front();
+                return slot;
+            }
+
+            if( !pendingSlots.empty( ))
+            {
+                // The ring is full, wait for the oldest copy only
+                PendingSlot pending = std::move( pendingSlots.front( ));
+                pendingSlots.pop_front();
+                lock.unlock();
+                pending.second->wait();
+                return pending.first;
+            }
+
+            // All slots are being filled by other threads
+            condition.wait( lock );
+        }
+    }
+
+    void release( const size_t slot, std::unique_ptr< CommandFence > fence )
+    {
+        {
+            ScopedLock lock( mutex );
+            pendingSlots.emplace_back( slot, std::move( fence ));
+        }
+        condition.notify_one();
+    }
+
+    const size_t slotSize;
+    GLuint buffer;
+    uint8_t* mapped;
+
+    typedef std::pair< size_t, std::unique_ptr< CommandFence >> PendingSlot;
+
+    std::deque< size_t > freeSlots;
+    std::deque< PendingSlot > pendingSlots; // slots being copied to textures
+    boost::mutex mutex;
+    boost::condition_variable condition;
+};
+
+PixelBufferRing::PixelBufferRing( const size_t slotSize, const size_t nSlots )
+    : _impl( new Impl( slotSize, nSlots ))
+{}
+
+PixelBufferRing::~PixelBufferRing()
+{}
+
+bool PixelBufferRing::isSupported()
+{
+    return GLContext::getCurrent() && GLEW_ARB_buffer_storage && GLEW_ARB_sync;
+}
+
+bool PixelBufferRing::upload( const void* data, const size_t size,
+                              const Vector3ui& offset,
+                              const Vector3ui& dimensions, const uint32_t format,
+                              const uint32_t type )
+{
+    if( size > _impl->slotSize )
+        LBTHROW( std::runtime_error( "The data does not fit in a pixel buffer slot" ));
+
+    const size_t slot = _impl->acquire();
+    const size_t bufferOffset = slot * _impl->slotSize;
+
+    // The buffer is coherent, so the copy is visible to the commands after it
+    ::memcpy( _impl->mapped + bufferOffset, data, size );
+
+    glBindBuffer( GL_PIXEL_UNPACK_BUFFER, _impl->buffer );
+    glTexSubImage3D( GL_TEXTURE_3D, 0, offset[0], offset[1], offset[2],
+                     dimensions[0], dimensions[1], dimensions[2], format, type,
+                     reinterpret_cast< const GLvoid* >( bufferOffset ));
+    glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+    const GLenum glErr = glGetError();
+
+    // The slot is reused once the texture has been copied from it, without
+    // waiting for the copy here
+    _impl->release( slot, std::unique_ptr< CommandFence >( new CommandFence ));
+
+    if( glErr != GL_NO_ERROR )
+    {
+        LBERROR << "Error uploading the texture from the pixel buffer, error number: "
+                << glErr << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,86 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _PixelBufferRing_h_
+#define _PixelBufferRing_h_
+
+#include <livre/core/api.h>
+#include <livre/core/types.h>
+
+namespace livre
+{
+
+/**
+ * The PixelBufferRing class streams data to textures through a persistently
+ * mapped pixel unpack buffer, split in slots which are handed out in turn.
+ *
+ * Threads with shared GL contexts copy their data into their own slot in
+ * parallel, outside of the GL driver. A slot is reused once the fence after
+ * its copy to the texture has signaled, so the uploads only block when all
+ * slots are in use. The class is thread safe.
+ */
+class PixelBufferRing
+{
+public:
+    /**
+     * Allocates and maps the buffer in the current GL context.
+     * @param slotSize the maximum size of an upload in bytes
+     * @param nSlots the number of slots
+     * @throw std::runtime_error if the buffer can not be mapped
+     */
+    LIVRECORE_API PixelBufferRing( size_t slotSize, size_t nSlots );
+
+    /** Unmaps and deletes the buffer, if a GL context is current. */
+    LIVRECORE_API ~PixelBufferRing();
+
+    /**
+     * @return true if the current GL context supports persistently mapped
+     * buffers and fences.
+     */
+    LIVRECORE_API static bool isSupported();
+
+    /**
+     * Copies the data to the 3D texture bound in the current GL context,
+     * without waiting for the copy to complete on the GPU, see CommandFence.
+     * Waits for the oldest copy if all slots are in use.
+     * @param data the texture data
+     * @param size the size of the data in bytes
+     * @param offset the position of the data in the texture in texels
+     * @param dimensions the size of the data in texels
+     * @param format the OpenGL format of the data
+     * @param type the OpenGL type of the data
+     * @return false if the upload failed
+     * @throw std::runtime_error if the data does not fit in a slot
+     */
+    LIVRECORE_API bool upload( const void* data, size_t size,
+                               const Vector3ui& offset,
+                               const Vector3ui& dimensions, uint32_t format,
+                               uint32_t type );
+
+private:
+    PixelBufferRing( const PixelBufferRing& ) = delete;
+    PixelBufferRing& operator=( const PixelBufferRing& ) = delete;
+
+    struct Impl;
+    std::unique_ptr< Impl > _impl;
+};
+
+}
+
+#endif // _PixelBufferRing_h_
@@ -0,0 +1,114 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/render/RenderTimer.h>
+#include <livre/core/render/GLContext.h>
+
+#include <eq/gl.h>
+
+namespace livre
+{
+
+#define glewGetContext() GLContext::getCurrent()->glewGetContext()
+
+struct RenderTimer::Impl
+{
+    Impl()
+        : query( 0 )
+        , context( nullptr )
+        , isPending( false )
+        , queriedArea( 0.f )
+    {}
+
+    ~Impl()
+    {
+        // Query objects are not shared between contexts
+        if( query && GLContext::getCurrent() == context )
+            glDeleteQueries( 1, &query );
+    }
+
+    FrameCost takeMeasuredCost()
+    {
+        FrameCost frameCost;
+        if( !isPending )
+            return frameCost;
+
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv( query, GL_QUERY_RESULT_AVAILABLE, &available );
+        if( !available )
+            return frameCost;
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v( query, GL_QUERY_RESULT, &elapsed );
+        frameCost.renderTime = float( elapsed ) / 1000000.f; // ns to ms
+        frameCost.renderedArea = queriedArea;
+        isPending = false;
+        return frameCost;
+    }
+
+    bool begin()
+    {
+        if( isPending || !GLContext::getCurrent() || !GLEW_ARB_timer_query )
+            return false;
+
+        if( !query )
+        {
+            glGenQueries( 1, &query );
+            context = GLContext::getCurrent();
+        }
+        glBeginQuery( GL_TIME_ELAPSED, query );
+        return true;
+    }
+
+    void end( const float renderedArea )
+    {
+        glEndQuery( GL_TIME_ELAPSED );
+        isPending = true;
+        queriedArea = renderedArea;
+    }
+
+    GLuint query;
+    const GLContext* context;
+    bool isPending;
+    float queriedArea;
+};
+
+RenderTimer::RenderTimer()
+    : _impl( new Impl )
+{}
+
+RenderTimer::~RenderTimer()
+{}
+
+FrameCost RenderTimer::takeMeasuredCost()
+{
+    return _impl->takeMeasuredCost();
+}
+
+bool RenderTimer::begin()
+{
+    return _impl->begin();
+}
+
+void RenderTimer::end( const float renderedArea )
+{
+    _impl->end( renderedArea );
+}
+
+}
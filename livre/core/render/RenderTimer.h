@@ -0,0 +1,76 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _RenderTimer_h_
+#define _RenderTimer_h_
+
+#include <livre/core/api.h>
+#include <livre/core/types.h>
+#include <livre/core/render/BrickCost.h>
+
+namespace livre
+{
+
+/**
+ * The RenderTimer class measures the GPU time of the rendering of a renderer
+ * with a timer query, without waiting for the GPU.
+ *
+ * The query lives as long as the renderer, so a result which is not available
+ * at the end of a frame is read by a later frame. The timer is used by the
+ * rendering thread of the renderer only.
+ */
+class RenderTimer
+{
+public:
+    LIVRECORE_API RenderTimer();
+
+    /** Deletes the query, if the GL context it was created in is current. */
+    LIVRECORE_API ~RenderTimer();
+
+    /**
+     * @return the cost of the rendering measured last, once the GPU has
+     * finished it, or an empty cost if no result is available.
+     */
+    LIVRECORE_API FrameCost takeMeasuredCost();
+
+    /**
+     * Starts timing the GL commands of the current context.
+     * @return false if timer queries are not supported, or if the previous
+     * measurement is still pending.
+     */
+    LIVRECORE_API bool begin();
+
+    /**
+     * Stops timing the GL commands of the current context.
+     * @param renderedArea the sum of the viewport fractions of the rendered
+     * bricks
+     */
+    LIVRECORE_API void end( float renderedArea );
+
+private:
+    RenderTimer( const RenderTimer& ) = delete;
+    RenderTimer& operator=( const RenderTimer& ) = delete;
+
+    struct Impl;
+    std::unique_ptr< Impl > _impl;
+};
+
+}
+
+#endif // _RenderTimer_h_
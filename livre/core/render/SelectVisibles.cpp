@@ -20,9 +20,17 @@
 #include "SelectVisibles.h"
 
 #include <livre/core/types.h>
+#include <livre/core/data/DataSource.h>
 #include <livre/core/data/LODNode.h>
+#include <livre/core/data/VolumeInformation.h>
 #include <livre/core/visitor/VisitState.h>
+#include <livre/core/render/BoxCuller.h>
 #include <livre/core/render/ClipPlanes.h>
+#include <livre/core/render/LODCriterion.h>
+
+#include <numeric>
+#include <limits>
+#include <queue>
 
 //#define LIVRE_STATIC_DECOMPOSITION
 
@@ -47,100 +55,77 @@ struct SelectVisibles::Impl
     , _maxLOD( maxLOD )
     , _range( range )
     , _clipPlanes( clipPlanes )
+    , _criterion( frustum, windowHeight, screenSpaceError, minLOD, maxLOD,
+                  dataSource.getVolumeInfo().rootNode.getDepth(), clipPlanes )
+    , _children( dataSource.getVolumeInfo().rootNode.getDepth( ))
     {}
 
-    bool isLODVisible( const Vector3f& worldCoord, const float worldSpacePerVoxel ) const
+    void visit( const NodeId& nodeId, VisitState& state )
     {
-       const float t = _frustum.top();
-       const float b = _frustum.bottom();
-
-       const float worldSpacePerPixel = ( t - b ) / _windowHeight;
-       const float pixelPerVoxel = worldSpacePerVoxel / worldSpacePerPixel;
-
-       Vector4f hWorldCoord = worldCoord;
-       hWorldCoord[ 3 ] = 1.0f;
-       const float distance = std::abs( _frustum.getNearPlane().dot( hWorldCoord ));
-
-       const float n = _frustum.nearPlane();
-       const float pixelPerVoxelInDistance = pixelPerVoxel * n /  ( n + distance );
-
-       return pixelPerVoxelInDistance <= _screenSpaceError;
-    }
-
-    void visit( const LODNode& lodNode, VisitState& state )
-    {
-        const Boxf& worldBox = lodNode.getWorldBox();
-        if( !_frustum.isInFrustum( worldBox ) || _clipPlanes.isClipped( worldBox ))
+        // The children of a refined node are evaluated as a batch when the
+        // node is visited, the other nodes one by one
+        const uint32_t level = nodeId.getLevel();
+        LODNode lodNode;
+        LODVisibility visibility = LOD_REFINED;
+        const Children* children = level > 0 ? &_children[ level - 1 ] : nullptr;
+        if( children && children->parent == nodeId.getParent( ))
         {
-           state.setVisitChild( false );
-           return;
+            const Vector3ui& position = nodeId.getPosition();
+            const size_t index = (( position.x() & 1u ) << 2 ) |
+                                 (( position.y() & 1u ) << 1 ) |
+                                 ( position.z() & 1u );
+            lodNode = children->nodes[ index ];
+            visibility = children->visibilities[ index ];
+        }
+        else
+        {
+            lodNode = _dataSource.getNode( nodeId );
+            if( lodNode.isValid( ))
+                visibility = _criterion.evaluate( lodNode );
         }
 
-        Vector3f vmin, vmax;
-        const Plane& nearPlane = _frustum.getNearPlane();
-
-        worldBox.computeNearFar( nearPlane, vmin, vmax );
-
-        Vector4f hVmin = vmin;
-        hVmin[ 3 ] = 1.0f;
-
-        Vector4f hVmax = vmax;
-        hVmax[ 3 ] = 1.0f;
-
-        // The bounding box intersects the plane
-       if( _frustum.getNearPlane().dot( hVmin ) < 0 ||
-           _frustum.getNearPlane().dot( hVmax ) < 0 )
-       {
-           // Where eye direction intersects with near plane
-           vmin = _frustum.getEyePos() - _frustum.getViewDir() * _frustum.nearPlane();
-       }
-
-       const Vector3f& voxelBox = lodNode.getVoxelBox().getSize();
-       const Vector3f& worldSpacePerVoxel = worldBox.getSize() / voxelBox;
-
-       bool lodVisible = isLODVisible( vmin, worldSpacePerVoxel.find_min( ));
-
-       const VolumeInformation& volInfo = _dataSource.getVolumeInfo();
-       const uint32_t depth = volInfo.rootNode.getDepth();
-       lodVisible = ( lodVisible && lodNode.getRefLevel() >= _minLOD )
-                    || ( lodNode.getRefLevel() == _maxLOD )
-                    || ( lodNode.getRefLevel() == depth - 1 );
+        // Like DataSourceVisitor, the children of invalid nodes are visited
+        if( !lodNode.isValid( ))
+            return;
 
-       if( lodVisible )
-           _visibles.push_back( lodNode.getNodeId( ));
+        if( visibility == LOD_SELECTED )
+            _visibles.push_back( nodeId );
 
-       state.setVisitChild( !lodVisible );
+        state.setVisitChild( visibility == LOD_REFINED );
+        if( visibility == LOD_REFINED && level + 1 < _children.size( ))
+        {
+            Children& refined = _children[ level ];
+            size_t i = 0;
+            for( const NodeId& childId: nodeId.getChildRange( ))
+                refined.nodes[ i++ ] = _dataSource.getNode( childId );
+            _criterion.evaluate( refined.nodes, i, refined.visibilities );
+            refined.parent = nodeId;
+        }
     }
 
     void visitPre()
     {
         _visibles.clear();
+        for( Children& children: _children )
+            children.parent = NodeId();
     }
 
     void visitPost()
     {
-        // Sort-last range selection:
-    #ifndef LIVRE_STATIC_DECOMPOSITION
-        const size_t startIndex = _range[0] * _visibles.size();
-        const size_t endIndex = _range[1] * _visibles.size();
-    #endif
-        NodeIds selected;
-        for( size_t i = 0; i < _visibles.size(); ++i )
-        {
-    #ifdef LIVRE_STATIC_DECOMPOSITION
-            const Range& nodeRange =
-                _visibles[ i ].getRange();
-            const bool isInRange = nodeRange[ 1 ] > _range[0] &&
-                                   nodeRange[ 1 ] <= _range[1];
-    #else
-            const bool isInRange = i >= startIndex && i < endIndex;
-    #endif
-            if( isInRange )
-                selected.push_back( _visibles[i] );
-        }
-        _visibles.swap( selected );
+        // Z-order keeps the bricks spatially coherent for cache and upload
+        // locality, and makes the sort-last ranges contiguous regions
+        sortMorton( _visibles );
+        selectRange( _visibles, _range );
     }
 
+    // The children of the refined node at each level
+    struct Children
+    {
+        NodeId parent;
+        LODNode nodes[ BoxBatch::maxSize ];
+        LODVisibility visibilities[ BoxBatch::maxSize ];
+    };
+
     const DataSource& _dataSource;
     const Frustum _frustum;
     const uint32_t _windowHeight;
@@ -150,8 +135,184 @@ struct SelectVisibles::Impl
     const Range _range;
     NodeIds _visibles;
     const ClipPlanes _clipPlanes;
+    const LODCriterion _criterion;
+    std::vector< Children > _children;
+};
+
+void selectRange( NodeIds& visibles, const Range& range )
+{
+    // Sort-last range selection:
+#ifndef LIVRE_STATIC_DECOMPOSITION
+    const size_t startIndex = range[0] * visibles.size();
+    const size_t endIndex = range[1] * visibles.size();
+#endif
+    NodeIds selected;
+    for( size_t i = 0; i < visibles.size(); ++i )
+    {
+#ifdef LIVRE_STATIC_DECOMPOSITION
+        const Range& nodeRange = visibles[ i ].getRange();
+        const bool isInRange = nodeRange[ 1 ] > range[0] &&
+                               nodeRange[ 1 ] <= range[1];
+#else
+        const bool isInRange = i >= startIndex && i < endIndex;
+#endif
+        if( isInRange )
+            selected.push_back( visibles[i] );
+    }
+    visibles.swap( selected );
+}
+
+void selectRange( NodeIds& visibles, const Floats& costs, const Range& range )
+{
+#ifdef LIVRE_STATIC_DECOMPOSITION
+    selectRange( visibles, range );
+#else
+    LBASSERT( costs.size() == visibles.size( ));
+    const double total = std::accumulate( costs.begin(), costs.end(), 0.0 );
+    if( total <= 0.0 )
+    {
+        selectRange( visibles, range );
+        return;
+    }
+
+    NodeIds selected;
+    double accumulated = 0.0;
+    for( size_t i = 0; i < visibles.size(); ++i )
+    {
+        const double middle = ( accumulated + 0.5 * costs[ i ]) / total;
+        accumulated += costs[ i ];
+        if( middle >= range[0] && middle < range[1] )
+            selected.push_back( visibles[i] );
+    }
+    visibles.swap( selected );
+#endif
+}
+
+namespace
+{
+/** The nodes which replace a refined node in the budgeted selection */
+class Refinement
+{
+public:
+    Refinement( const DataSource& dataSource, const LODCriterion& criterion )
+        : _dataSource( dataSource )
+        , _criterion( criterion )
+        , _depth( dataSource.getVolumeInfo().rootNode.getDepth( ))
+    {}
+
+    struct Node
+    {
+        LODNode node;
+        LODVisibility visibility;
+    };
+    typedef std::vector< Node > Nodes;
+
+    /** Adds the visible node, or the visible descendants of an invalid one */
+    void add( const NodeId& nodeId, Nodes& nodes ) const
+    {
+        const LODNode& lodNode = _dataSource.getNode( nodeId );
+        if( !lodNode.isValid( ))
+        {
+            refine( nodeId, nodes );
+            return;
+        }
+
+        const LODVisibility visibility = _criterion.evaluate( lodNode );
+        if( visibility != LOD_CULLED )
+            nodes.push_back( { lodNode, visibility });
+    }
+
+    /** Adds the visible children of the node */
+    void refine( const NodeId& nodeId, Nodes& nodes ) const
+    {
+        if( nodeId.getLevel() + 1 >= _depth )
+            return;
+
+        LODNode children[ BoxBatch::maxSize ];
+        LODVisibility visibilities[ BoxBatch::maxSize ];
+        size_t nChildren = 0;
+        for( const NodeId& childId: nodeId.getChildRange( ))
+            children[ nChildren++ ] = _dataSource.getNode( childId );
+        _criterion.evaluate( children, nChildren, visibilities );
+
+        for( size_t i = 0; i < nChildren; ++i )
+        {
+            if( !children[ i ].isValid( ))
+                refine( nodeId.getChild( i ), nodes );
+            else if( visibilities[ i ] != LOD_CULLED )
+                nodes.push_back( { children[ i ], visibilities[ i ]});
+        }
+    }
+
+    /** @return the priority of a node to be refined */
+    float getPriority( const LODNode& node ) const
+    {
+        // Below the minimum LOD, nodes are refined regardless of their error
+        if( node.getRefLevel() < _criterion.getMinLOD( ))
+            return std::numeric_limits< float >::infinity();
+        return _criterion.getScreenSpaceError( node );
+    }
+
+private:
+    const DataSource& _dataSource;
+    const LODCriterion& _criterion;
+    const uint32_t _depth;
 };
+}
 
+NodeIds selectBudgeted( const DataSource& dataSource,
+                        const LODCriterion& criterion,
+                        const uint32_t timeStep, const size_t maxNodes )
+{
+    typedef std::pair< float, NodeId > Candidate;
+    const auto lessPriority = []( const Candidate& lhs, const Candidate& rhs )
+        { return lhs.first < rhs.first; };
+    std::priority_queue< Candidate, std::vector< Candidate >,
+                         decltype( lessPriority )> candidates( lessPriority );
+
+    NodeIds selected;
+    const Refinement refinement( dataSource, criterion );
+    const auto addNodes = [&]( const Refinement::Nodes& nodes )
+    {
+        for( const Refinement::Node& node: nodes )
+        {
+            if( node.visibility == LOD_SELECTED )
+                selected.push_back( node.node.getNodeId( ));
+            else
+                candidates.push( Candidate( refinement.getPriority( node.node ),
+                                            node.node.getNodeId( )));
+        }
+    };
+
+    const Vector3ui& blockSize = dataSource.getVolumeInfo().rootNode.getBlockSize();
+    Refinement::Nodes nodes;
+    for( uint32_t x = 0; x < blockSize.x(); ++x )
+        for( uint32_t y = 0; y < blockSize.y(); ++y )
+            for( uint32_t z = 0; z < blockSize.z(); ++z )
+                refinement.add( NodeId( 0, Vector3ui( x, y, z ), timeStep ), nodes );
+    addNodes( nodes );
+
+    // The refined nodes stay in the cut until they are replaced by their
+    // children, so the cut never exceeds the budget once the roots fit
+    while( !candidates.empty( ))
+    {
+        const NodeId nodeId = candidates.top().second;
+        candidates.pop();
+
+        nodes.clear();
+        refinement.refine( nodeId, nodes );
+        const size_t nNodes = selected.size() + candidates.size() + nodes.size();
+        if( nNodes > maxNodes )
+        {
+            selected.push_back( nodeId );
+            continue;
+        }
+        addNodes( nodes );
+    }
+
+    sortMorton( selected );
+    return selected;
+}
 
 SelectVisibles::SelectVisibles( const DataSource& dataSource,
                                 const Frustum& frustum,
@@ -161,8 +322,7 @@ SelectVisibles::SelectVisibles( const DataSource& dataSource,
                                 const uint32_t maxLOD,
                                 const Range& range,
                                 const ClipPlanes& clipPlanes )
-    : DataSourceVisitor( dataSource )
-    , _impl( new SelectVisibles::Impl( dataSource,
+    : _impl( new SelectVisibles::Impl( dataSource,
                                        frustum,
                                        windowHeight,
                                        screenSpaceError,
@@ -180,14 +340,40 @@ const NodeIds& SelectVisibles::getVisibles() const
     return _impl->_visibles;
 }
 
+NodeIds SelectVisibles::takeVisibles()
+{
+    return std::move( _impl->_visibles );
+}
+
+std::unique_ptr< NodeVisitor > SelectVisibles::fork() const
+{
+    return std::unique_ptr< NodeVisitor >(
+                new SelectVisibles( _impl->_dataSource,
+                                    _impl->_frustum,
+                                    _impl->_windowHeight,
+                                    _impl->_screenSpaceError,
+                                    _impl->_minLOD,
+                                    _impl->_maxLOD,
+                                    _impl->_range,
+                                    _impl->_clipPlanes ));
+}
+
+void SelectVisibles::join( NodeVisitor& forked )
+{
+    const NodeIds& visibles =
+            static_cast< SelectVisibles& >( forked )._impl->_visibles;
+    _impl->_visibles.insert( _impl->_visibles.end(), visibles.begin(),
+                             visibles.end( ));
+}
+
 void SelectVisibles::visitPre()
 {
     _impl->visitPre();
 }
 
-void SelectVisibles::visit( const LODNode& lodNode, VisitState& state )
+void SelectVisibles::visit( const NodeId& nodeId, VisitState& state )
 {
-    _impl->visit( lodNode, state );
+    _impl->visit( nodeId, state );
 }
 
 void SelectVisibles::visitPost()
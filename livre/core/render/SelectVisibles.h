@@ -21,13 +21,13 @@
 #define _SelectVisibles_h_
 
 #include <livre/core/types.h>
-#include <livre/core/visitor/DataSourceVisitor.h>
+#include <livre/core/visitor/NodeVisitor.h>
 #include <livre/core/render/Frustum.h>
 
 namespace livre
 {
 /** Selects all visible rendering nodes */
-class SelectVisibles : public DataSourceVisitor
+class SelectVisibles : public NodeVisitor
 {
 public:
     /**
@@ -57,10 +57,22 @@ public:
      */
     const NodeIds& getVisibles() const;
 
+    /**
+     * Moves the list of visibles out of the visitor.
+     * @return the list of visibles
+     */
+    NodeIds takeVisibles();
+
+    /** @copydoc NodeVisitor::fork */
+    std::unique_ptr< NodeVisitor > fork() const final;
+
+    /** @copydoc NodeVisitor::join */
+    void join( NodeVisitor& forked ) final;
+
 protected:
 
     void visitPre() final;
-    void visit( const LODNode& lodNode, VisitState& state ) final;
+    void visit( const NodeId& nodeId, VisitState& state ) final;
     void visitPost() final;
 
 private:
@@ -68,5 +80,45 @@ private:
     struct Impl;
     std::unique_ptr< Impl > _impl;
 };
+
+/**
+ * Keeps the part of the Morton ordered visibles within the sort-last range.
+ * @param visibles the visibles, returns the ones in the range
+ * @param range range of the data
+ */
+LIVRECORE_API void selectRange( NodeIds& visibles, const Range& range );
+
+/**
+ * Keeps the part of the Morton ordered visibles within the sort-last range,
+ * splitting them by their cost instead of their number. A node is in the
+ * range which contains the middle of its cost in the accumulated costs, so
+ * the ranges of the channels partition the visibles into contiguous regions
+ * of balanced cost. This only holds if all channels pass the same visibles
+ * and costs, i.e. select them from the same view without per-channel state
+ * and estimate the costs with the same model.
+ * @param visibles the visibles, returns the ones in the range
+ * @param costs the costs of the visibles
+ * @param range range of the accumulated costs
+ */
+LIVRECORE_API void selectRange( NodeIds& visibles, const Floats& costs,
+                                const Range& range );
+
+/**
+ * Selects the visible nodes with the most detail which fit in a budget.
+ *
+ * Starting from the roots, the node with the highest screen space error is
+ * refined first, until the criterion is met everywhere or refining a node
+ * would exceed the budget. Without a limit, the selection is the one of
+ * SelectVisibles.
+ * @param dataSource data source
+ * @param criterion the LOD criterion of the view
+ * @param timeStep the temporal position of the node tree
+ * @param maxNodes the maximum number of selected nodes, which is exceeded
+ *        only if the visible root nodes do not fit
+ * @return the selected nodes in Morton order
+ */
+LIVRECORE_API NodeIds selectBudgeted( const DataSource& dataSource,
+                                      const LODCriterion& criterion,
+                                      uint32_t timeStep, size_t maxNodes );
 }
 #endif //_SelectVisibles_h_
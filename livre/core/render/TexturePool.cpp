@@ -21,21 +21,46 @@
 
 #include <livre/core/defines.h>
 #include <livre/core/render/GLContext.h>
+#include <livre/core/render/PixelBufferRing.h>
 
 #include <livre/core/data/DataSource.h>
 
 #include <eq/gl.h>
 
+#include <cmath>
+
 namespace livre
 {
 
 #define glewGetContext() GLContext::glewGetContext()
 
-TexturePool::TexturePool( const DataSource& dataSource )
+namespace
+{
+/** @return the largest integer whose given power does not exceed the value */
+uint32_t floorRoot( const uint32_t value, const int degree )
+{
+    uint32_t root = std::round( std::pow( double( value ), 1.0 / degree ));
+    while( root > 0 && std::pow( double( root ), degree ) > value )
+        --root;
+    return root;
+}
+}
+
+TexturePool::TexturePool( const DataSource& dataSource,
+                          const size_t uploadBufferSize,
+                          const size_t atlasSize )
     : _maxBlockSize( dataSource.getVolumeInfo().maximumBlockSize )
     , _internalTextureFormat( 0 )
     , _format( 0 )
     , _textureType( 0 )
+    , _bytesPerVoxel( dataSource.getVolumeInfo().getBytesPerVoxel( ))
+    , _blockMemSize( dataSource.getVolumeInfo().getBlockMemSize( ))
+    , _uploadBufferSize( uploadBufferSize )
+    , _pixelBufferChecked( false )
+    , _atlasSize( atlasSize )
+    , _atlasTexture( INVALID_TEXTURE_ID )
+    , _atlasSlots( 0u )
+    , _atlasChecked( false )
 {
     if( dataSource.getVolumeInfo().compCount != 1 )
         LBTHROW( std::runtime_error( "Unsupported number of channels." ));
@@ -91,7 +116,25 @@ void TexturePool::generateTexture( TextureState& textureState )
 {
     ScopedLock lock( _mutex );
     LBASSERT( textureState.textureId == INVALID_TEXTURE_ID );
-    if( !_textureStack.empty() )
+    if( !_atlasChecked )
+    {
+        _atlasChecked = true;
+        if( _atlasSize > 0 )
+            _createAtlas();
+    }
+
+    if( !_freeAtlasSlots.empty( ))
+    {
+        const uint32_t slot = _freeAtlasSlots.back();
+        _freeAtlasSlots.pop_back();
+        textureState.textureId = _atlasTexture;
+        textureState.slotOffset =
+                Vector3ui( slot % _atlasSlots[ 0 ],
+                           slot / _atlasSlots[ 0 ] % _atlasSlots[ 1 ],
+                           slot / ( _atlasSlots[ 0 ] * _atlasSlots[ 1 ] )) *
+                _maxBlockSize;
+    }
+    else if( !_textureStack.empty() )
     {
         textureState.textureId = _textureStack.back();
         _textureStack.pop_back();
@@ -123,7 +166,127 @@ void TexturePool::releaseTexture( TextureState& textureState )
 {
     ScopedLock lock( _mutex );
     LBASSERT( textureState.textureId );
-    _textureStack.push_back( textureState.textureId );
+    if( textureState.textureId != _atlasTexture )
+    {
+        _textureStack.push_back( textureState.textureId );
+        return;
+    }
+
+    const Vector3ui& slot = textureState.slotOffset / _maxBlockSize;
+    _freeAtlasSlots.push_back( slot[ 0 ] + _atlasSlots[ 0 ] *
+                               ( slot[ 1 ] + _atlasSlots[ 1 ] * slot[ 2 ] ));
+}
+
+Vector3f TexturePool::getTextureCoords( const TextureState& textureState,
+                                        const Vector3f& blockCoords ) const
+{
+    if( textureState.textureId != _atlasTexture )
+        return blockCoords;
+
+    const Vector3f blockSize( _maxBlockSize );
+    const Vector3f atlasSize = Vector3f( _atlasSlots ) * blockSize;
+    return ( Vector3f( textureState.slotOffset ) + blockCoords * blockSize ) /
+           atlasSize;
+}
+
+void TexturePool::_createAtlas()
+{
+    const uint32_t nSlots = _atlasSize / _blockMemSize;
+    GLint maxTextureSize = 0;
+    glGetIntegerv( GL_MAX_3D_TEXTURE_SIZE, &maxTextureSize );
+    const Vector3ui maxSlots = Vector3ui( uint32_t( maxTextureSize )) / _maxBlockSize;
+
+    // The slots fill a grid as close to a cube as the texture size permits.
+    // Every side is rounded down, so the atlas never exceeds its memory budget
+    Vector3ui slots;
+    slots[ 0 ] = std::min( floorRoot( nSlots, 3 ), maxSlots[ 0 ]);
+    slots[ 1 ] = std::min( floorRoot( nSlots / std::max( slots[ 0 ], 1u ), 2 ),
+                           maxSlots[ 1 ]);
+    slots[ 2 ] = std::min( nSlots / std::max( slots[ 0 ] * slots[ 1 ], 1u ),
+                           maxSlots[ 2 ]);
+    LBASSERT( slots.product() <= nSlots );
+    if( slots.product() == 0 )
+        return;
+
+    GLuint texture = 0;
+    glGenTextures( 1, &texture );
+    glBindTexture( GL_TEXTURE_3D, texture );
+    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE );
+
+    const Vector3ui size = slots * _maxBlockSize;
+    glTexImage3D( GL_TEXTURE_3D, 0, _internalTextureFormat,
+                  size[ 0 ], size[ 1 ], size[ 2 ], 0,
+                  _format, _textureType, (GLvoid *)NULL );
+
+    const GLenum glErr = glGetError();
+    if( glErr != GL_NO_ERROR )
+    {
+        LBWARN << "Error allocating the texture atlas of " << size
+               << " voxels, error number: " << glErr
+               << ", allocating a texture per block" << std::endl;
+        glDeleteTextures( 1, &texture );
+        return;
+    }
+
+    _atlasTexture = texture;
+    _atlasSlots = slots;
+
+    // The first slots are handed out first
+    const uint32_t nAtlasSlots = slots.product();
+    _freeAtlasSlots.reserve( nAtlasSlots );
+    for( uint32_t i = nAtlasSlots; i > 0; --i )
+        _freeAtlasSlots.push_back( i - 1 );
+}
+
+bool TexturePool::uploadTexture( const TextureState& textureState,
+                                 const void* data,
+                                 const Vector3ui& size )
+{
+    {
+        ScopedLock lock( _mutex );
+        if( !_pixelBufferChecked )
+        {
+            _pixelBufferChecked = true;
+            if( _uploadBufferSize > 0 && PixelBufferRing::isSupported( ))
+            {
+                const size_t nSlots = std::max( _uploadBufferSize / _blockMemSize,
+                                                size_t( 1 ));
+                try
+                {
+                    _pixelBuffer.reset( new PixelBufferRing( _blockMemSize,
+                                                             nSlots ));
+                }
+                catch( const std::runtime_error& error )
+                {
+                    LBWARN << error.what() << ", uploading directly" << std::endl;
+                }
+            }
+        }
+    }
+
+    textureState.bind();
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+    const Vector3ui& offset = textureState.slotOffset;
+    if( _pixelBuffer )
+        return _pixelBuffer->upload( data, size.product() * _bytesPerVoxel,
+                                     offset, size, _format, _textureType );
+
+    glTexSubImage3D( GL_TEXTURE_3D, 0, offset[0], offset[1], offset[2],
+                     size[0], size[1], size[2], _format, _textureType, data );
+
+    const GLenum glErr = glGetError();
+    if( glErr != GL_NO_ERROR )
+    {
+        LBERROR << "Error loading the texture into GPU, error number : "
+                << glErr << std::endl;
+        return false;
+    }
+    return true;
 }
 
 }
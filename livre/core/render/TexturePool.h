@@ -29,7 +29,11 @@ namespace livre
 
 /**
  * The TexturePool class is responsible for allocating texture slots and copying
- * textures into the texture slots. The methods are not thread safe.
+ * textures into the texture slots.
+ *
+ * The slots are either 3D textures of their own, or the slots of a texture
+ * atlas: one 3D texture subdivided in a grid of maximum block sized slots. When
+ * the atlas is full, further slots get textures of their own.
  */
 class TexturePool
 {
@@ -38,9 +42,15 @@ public:
     /**
      * Constructor.
      * @param dataSource the data source
+     * @param uploadBufferSize the size in bytes of the pixel buffer used for
+     * streaming the uploads, 0 to upload directly from the client memory
+     * @param atlasSize the size in bytes of the texture atlas, 0 to allocate a
+     * texture for each slot
      * @throws std::runtime_error if data has multiple channels
      */
-    LIVRECORE_API TexturePool( const DataSource& dataSource );
+    LIVRECORE_API TexturePool( const DataSource& dataSource,
+                               size_t uploadBufferSize = 0,
+                               size_t atlasSize = 0 );
     LIVRECORE_API ~TexturePool();
 
     /** @return The OpenGL GPU internal format of the texture data. */
@@ -64,14 +74,50 @@ public:
      */
     LIVRECORE_API void releaseTexture( TextureState& textureState );
 
+    /**
+     * @param textureState a texture slot
+     * @param blockCoords texture coordinates in the maximum texture block
+     * @return the texture coordinates in the texture of the slot
+     */
+    LIVRECORE_API Vector3f getTextureCoords( const TextureState& textureState,
+                                             const Vector3f& blockCoords ) const;
+
+    /**
+     * Copies the data into the texture slot, through the pixel buffer if it is
+     * supported by the current GL context. Returns without waiting for the
+     * copy to complete on the GPU: the texture can be used from the other
+     * shared contexts once a CommandFence inserted after it has signaled.
+     * @param textureState the destination texture slot
+     * @param data the texture data
+     * @param size the size of the data in voxels
+     * @return false if the upload failed
+     */
+    LIVRECORE_API bool uploadTexture( const TextureState& textureState,
+                                      const void* data,
+                                      const Vector3ui& size );
+
 private:
 
+    void _createAtlas();
+
     UInt32s _textureStack;
 
     const Vector3ui _maxBlockSize;
     int32_t _internalTextureFormat;
     uint32_t _format;
     uint32_t _textureType;
+    const size_t _bytesPerVoxel;
+    const size_t _blockMemSize;
+    const size_t _uploadBufferSize;
+
+    std::unique_ptr< PixelBufferRing > _pixelBuffer;
+    bool _pixelBufferChecked;
+
+    const size_t _atlasSize;
+    uint32_t _atlasTexture;
+    Vector3ui _atlasSlots; // slots along each axis
+    UInt32s _freeAtlasSlots;
+    bool _atlasChecked;
 
     boost::mutex _mutex;
 };
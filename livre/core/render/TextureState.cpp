@@ -32,6 +32,7 @@ TextureState::TextureState( TexturePool& texturePool )
     : textureCoordsMin( 0.0f )
     , textureCoordsMax( 0.0f )
     , textureSize( 0.0f )
+    , slotOffset( 0u )
     , textureId( INVALID_TEXTURE_ID )
     , _texturePool( texturePool )
 {
@@ -49,6 +49,7 @@ public:
     Vector3f textureCoordsMin; //!< Minimum texture coordinates in the maximum texture block.
     Vector3f textureCoordsMax; //!< Maximum texture coordinates in the maximum texture block.
     Vector3f textureSize; //!< The texture size.
+    Vector3ui slotOffset; //!< The voxel position of the slot in the texture atlas.
     uint32_t textureId; //!< The OpenGL texture id.
 
 private:
@@ -60,15 +60,21 @@ class CacheStatistics;
 class ClipPlanes;
 class Configuration;
 class Frustum;
+class FrustumPredictor;
 class GLContext;
 class GLSLShaders;
 class Histogram;
+class LODCriterion;
+class LODCut;
 class LODNode;
 class MemoryUnit;
 class NodeId;
 class NodeVisitor;
 class Parameter;
+class PixelBufferRing;
+class PrefetchStatistics;
 class Renderer;
+class RenderTimer;
 class RootNode;
 class TexturePool;
 class VisitState;
@@ -80,6 +86,7 @@ class DataSourcePluginData;
 class AsyncData;
 class Executor;
 class Executable;
+class CancellationToken;
 class Filter;
 class Future;
 class FutureMap;
@@ -123,6 +130,11 @@ typedef std::shared_ptr< CacheObject > CacheObjectPtr;
 typedef std::shared_ptr< const CacheObject > ConstCacheObjectPtr;
 typedef std::shared_ptr< PortData > PortDataPtr;
 typedef std::shared_ptr< Executable > ExecutablePtr;
+typedef std::shared_ptr< Workers > WorkersPtr;
+typedef std::shared_ptr< LODCut > LODCutPtr;
+typedef std::shared_ptr< PrefetchStatistics > PrefetchStatisticsPtr;
+typedef std::shared_ptr< const PrefetchStatistics > ConstPrefetchStatisticsPtr;
+typedef std::shared_ptr< RenderTimer > RenderTimerPtr;
 
 typedef std::unique_ptr< Filter > FilterPtr;
 
@@ -191,6 +203,14 @@ enum AccessMode
     MODE_WRITE = 1u
 };
 
+/** The order in which the workers pick up scheduled executables */
+enum ExecutionPriority
+{
+    PRIORITY_BACKGROUND = 0u, //!< Only executed when no other work is pending
+    PRIORITY_NORMAL = 1u,
+    PRIORITY_HIGH = 2u //!< Executed before any other pending work
+};
+
 // Constants
 const uint32_t INVALID_TEXTURE_ID = -1; //!< Invalid OpenGL texture id.
 const Identifier INVALID_CACHE_ID = -1; //!< Invalid cache id.
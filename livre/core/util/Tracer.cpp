@@ -0,0 +1,255 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/util/Tracer.h>
+
+#include <lunchbox/clock.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace livre
+{
+
+namespace
+{
+const size_t maxNameLength = 48;
+
+struct Event
+{
+    char name[ maxNameLength ];
+    const char* category;
+    uint32_t frame;
+    double start;
+    double duration;
+    double queueWait;
+};
+
+/**
+ * Ring buffer of a thread. Only the owning thread writes, the mutex is
+ * contended only while the trace is written.
+ */
+struct Buffer
+{
+    explicit Buffer( const uint32_t thread_ )
+        : events( Tracer::bufferSize )
+        , written( 0 )
+        , thread( thread_ )
+    {}
+
+    std::mutex mutex;
+    std::vector< Event > events;
+    size_t written;
+    const uint32_t thread;
+};
+
+typedef std::shared_ptr< Buffer > BufferPtr;
+
+struct State
+{
+    State()
+        : enabled( false )
+        , frame( 0 )
+        , nFrames( 0 )
+    {}
+
+    // The per thread clocks of ThreadClock do not share an epoch
+    const lunchbox::Clock clock;
+    std::atomic< bool > enabled;
+    std::atomic< uint32_t > frame;
+    uint32_t nFrames;
+
+    std::mutex mutex; // protects buffers
+    std::vector< BufferPtr > buffers;
+};
+
+State& getState()
+{
+    static State state;
+    return state;
+}
+
+thread_local Buffer* _buffer = nullptr;
+thread_local double _pendingQueueWait = 0.0;
+
+Buffer& getBuffer()
+{
+    if( !_buffer )
+    {
+        State& state = getState();
+        std::lock_guard< std::mutex > lock( state.mutex );
+        state.buffers.emplace_back(
+            std::make_shared< Buffer >( uint32_t( state.buffers.size( ))));
+        _buffer = state.buffers.back().get();
+    }
+    return *_buffer;
+}
+
+double takeQueueWait()
+{
+    const double queueWait = _pendingQueueWait;
+    _pendingQueueWait = 0.0;
+    return queueWait;
+}
+
+void writeEscaped( std::ostream& os, const char* str )
+{
+    for( ; *str; ++str )
+    {
+        if( *str == '"' || *str == '\\' )
+            os << '\\';
+        os << *str;
+    }
+}
+}
+
+Tracer::Scope::Scope( const char* category, const std::string& name )
+    : _enabled( Tracer::isEnabled( ))
+    , _category( category )
+    , _name( _enabled ? name : std::string( ))
+    , _start( _enabled ? Tracer::getTime() : 0.0 )
+    , _queueWait( takeQueueWait( ))
+{}
+
+Tracer::Scope::~Scope()
+{
+    if( _enabled )
+        Tracer::record( _category, _name, _start, Tracer::getTime() - _start,
+                        _queueWait );
+}
+
+void Tracer::start( const uint32_t nFrames )
+{
+    State& state = getState();
+    {
+        std::lock_guard< std::mutex > lock( state.mutex );
+        for( const BufferPtr& buffer: state.buffers )
+        {
+            std::lock_guard< std::mutex > bufferLock( buffer->mutex );
+            buffer->written = 0;
+        }
+        state.nFrames = nFrames;
+    }
+    state.frame = 0;
+    state.enabled = true;
+}
+
+void Tracer::stop()
+{
+    getState().enabled = false;
+}
+
+bool Tracer::isEnabled()
+{
+    return getState().enabled.load( std::memory_order_relaxed );
+}
+
+bool Tracer::frame()
+{
+    State& state = getState();
+    if( !state.enabled )
+        return false;
+
+    if( ++state.frame < state.nFrames )
+        return false;
+
+    // Only the caller which disables tracing reports completion
+    bool enabled = true;
+    return state.enabled.compare_exchange_strong( enabled, false );
+}
+
+double Tracer::getTime()
+{
+    return getState().clock.getTimed() * 1000.0;
+}
+
+void Tracer::setQueueWait( const double queueWait )
+{
+    _pendingQueueWait = queueWait;
+}
+
+void Tracer::record( const char* category, const std::string& name,
+                     const double start, const double duration,
+                     const double queueWait )
+{
+    if( !isEnabled( ))
+        return;
+
+    Buffer& buffer = getBuffer();
+    std::lock_guard< std::mutex > lock( buffer.mutex );
+    Event& event = buffer.events[ buffer.written % bufferSize ];
+    ++buffer.written;
+
+    const size_t length = std::min( name.size(), maxNameLength - 1 );
+    std::memcpy( event.name, name.data(), length );
+    event.name[ length ] = '\0';
+    event.category = category;
+    event.frame = getState().frame.load( std::memory_order_relaxed );
+    event.start = start;
+    event.duration = duration;
+    event.queueWait = queueWait;
+}
+
+void Tracer::writeChromeTrace( std::ostream& os )
+{
+    State& state = getState();
+    std::lock_guard< std::mutex > lock( state.mutex );
+
+    const std::ios::fmtflags flags = os.flags();
+    const std::streamsize precision = os.precision();
+    os << std::fixed << std::setprecision( 3 );
+
+    os << "{\"traceEvents\":[";
+    bool first = true;
+    for( const BufferPtr& buffer: state.buffers )
+    {
+        std::lock_guard< std::mutex > bufferLock( buffer->mutex );
+        if( buffer->written == 0 )
+            continue;
+
+        os << ( first ? "" : "," ) << "\n{\"name\":\"thread_name\",\"ph\":\"M\","
+           << "\"pid\":0,\"tid\":" << buffer->thread << ","
+           << "\"args\":{\"name\":\"Thread " << buffer->thread << "\"}}";
+        first = false;
+
+        const size_t count = std::min( buffer->written, bufferSize );
+        for( size_t i = buffer->written - count; i < buffer->written; ++i )
+        {
+            const Event& event = buffer->events[ i % bufferSize ];
+            os << ",\n{\"name\":\"";
+            writeEscaped( os, event.name );
+            os << "\",\"cat\":\"" << event.category << "\",\"ph\":\"X\","
+               << "\"pid\":0,\"tid\":" << buffer->thread << ","
+               << "\"ts\":" << event.start << ",\"dur\":" << event.duration
+               << ",\"args\":{\"frame\":" << event.frame
+               << ",\"queueWait\":" << event.queueWait << "}}";
+        }
+    }
+    os << "\n]}\n";
+    os.flags( flags );
+    os.precision( precision );
+}
+
+}
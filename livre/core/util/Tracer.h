@@ -0,0 +1,122 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _Tracer_h_
+#define _Tracer_h_
+
+#include <livre/core/api.h>
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace livre
+{
+
+/**
+ * The Tracer class records where the time of a frame goes across the threads
+ * of the pipeline. Events are kept in fixed size per thread ring buffers and
+ * can be written in the Chrome trace event format, which can be opened with
+ * about:tracing or https://ui.perfetto.dev.
+ *
+ * Tracing is disabled by default, in which case an instrumentation point
+ * only reads an atomic flag.
+ */
+class Tracer
+{
+public:
+    /** Number of events kept per thread, older events are overwritten. */
+    static const size_t bufferSize = 16384;
+
+    /**
+     * Records a scope as a trace event, if tracing is enabled on construction.
+     * A queue wait set by Workers before executing is attributed to it.
+     */
+    class Scope
+    {
+    public:
+        /**
+         * @param category of the event, has to be a string literal.
+         * @param name of the event, truncated to 47 characters.
+         */
+        LIVRECORE_API Scope( const char* category, const std::string& name );
+        LIVRECORE_API ~Scope();
+
+    private:
+        Scope( const Scope& ) = delete;
+        Scope& operator=( const Scope& ) = delete;
+
+        const bool _enabled;
+        const char* _category;
+        const std::string _name;
+        const double _start;
+        const double _queueWait;
+    };
+
+    /**
+     * Clears the recorded events and starts tracing.
+     * @param nFrames number of frames to trace, counted by frame()
+     */
+    LIVRECORE_API static void start( uint32_t nFrames );
+
+    /** Stops tracing, the recorded events are kept. */
+    LIVRECORE_API static void stop();
+
+    /** @return true if events are recorded. */
+    LIVRECORE_API static bool isEnabled();
+
+    /**
+     * Marks the end of a frame.
+     * @return true once the traced frames are complete, tracing is then
+     * stopped and the events can be written.
+     */
+    LIVRECORE_API static bool frame();
+
+    /** @return the time in microseconds, on a process wide time base. */
+    LIVRECORE_API static double getTime();
+
+    /**
+     * Sets the time the next event of the calling thread waited in a queue.
+     * @param queueWait the wait time in microseconds
+     */
+    LIVRECORE_API static void setQueueWait( double queueWait );
+
+    /**
+     * Records an event for the calling thread.
+     * @param category of the event, has to be a string literal.
+     * @param name of the event.
+     * @param start time in microseconds, see getTime()
+     * @param duration in microseconds
+     * @param queueWait time waited in a queue before starting, in microseconds
+     */
+    LIVRECORE_API static void record( const char* category,
+                                      const std::string& name,
+                                      double start, double duration,
+                                      double queueWait );
+
+    /**
+     * Writes the recorded events of all threads as Chrome trace JSON.
+     * @param os the output stream
+     */
+    LIVRECORE_API static void writeChromeTrace( std::ostream& os );
+};
+
+}
+
+#endif // _Tracer_h_
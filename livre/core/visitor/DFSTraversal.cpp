@@ -29,6 +29,10 @@ namespace livre
 struct DFSTraversal::Impl
 {
 public:
+    Impl()
+        : _subtrees( nullptr )
+        , _taskLevel( 0 )
+    {}
 
     bool traverse( const NodeId& nodeId,
                    const uint32_t depth,
@@ -37,6 +41,12 @@ public:
         if( depth == 0 || _state.getBreakTraversal() )
             return false;
 
+        if( _subtrees && nodeId.getLevel() == _taskLevel )
+        {
+            _subtrees->push_back( nodeId );
+            return false;
+        }
+
         _state = VisitState();
 
         if( _state.getBreakTraversal( ) )
@@ -50,8 +60,7 @@ public:
             return false;
         }
 
-        const NodeIds& nodeIds = nodeId.getChildren();
-        for( const NodeId& childNodeId: nodeIds )
+        for( const NodeId& childNodeId: nodeId.getChildRange( ))
         {
             traverse( childNodeId, depth - 1, visitor );
             if( !_state.getVisitNeighbours() )
@@ -67,6 +76,8 @@ public:
     }
 
     VisitState _state; //!< Status of the travel
+    NodeIds* _subtrees; //!< If set, collects the nodes at the task level
+    uint32_t _taskLevel;
 };
 
 DFSTraversal::DFSTraversal( )
@@ -103,5 +114,54 @@ void DFSTraversal::traverse( const RootNode& rootNode, NodeVisitor& visitor,
     visitor.visitPost();
 }
 
+void DFSTraversal::traverse( const RootNode& rootNode, NodeVisitor& visitor,
+                             const uint32_t timeStep, const uint32_t taskLevel,
+                             const size_t nThreads )
+{
+    visitor.visitPre();
+
+    NodeIds subtrees;
+    _impl->_subtrees = &subtrees;
+    _impl->_taskLevel = taskLevel;
+    const Vector3ui& blockSize = rootNode.getBlockSize();
+    for( uint32_t x = 0; x < blockSize.x(); ++x )
+        for( uint32_t y = 0; y < blockSize.y(); ++y )
+            for( uint32_t z = 0; z < blockSize.z(); ++z )
+            {
+                _impl->traverse( NodeId( 0, Vector3ui( x, y, z ), timeStep ),
+                                 rootNode.getDepth(), visitor );
+            }
+    _impl->_subtrees = nullptr;
+
+    const uint32_t depth = rootNode.getDepth() - taskLevel;
+    std::vector< std::unique_ptr< NodeVisitor >> forks;
+    if( nThreads > 1 )
+    {
+        forks.reserve( subtrees.size( ));
+        for( size_t i = 0; i < subtrees.size(); ++i )
+            forks.push_back( visitor.fork( ));
+    }
+
+    if( forks.empty() || !forks.front( ))
+    {
+        for( const NodeId& subtree: subtrees )
+            _impl->traverse( subtree, depth, visitor );
+    }
+    else
+    {
+        #pragma omp parallel for schedule( dynamic ) num_threads( nThreads ) \
+                                 if( subtrees.size() > 1 )
+        for( int64_t i = 0; i < int64_t( subtrees.size( )); ++i )
+        {
+            Impl task;
+            task.traverse( subtrees[ i ], depth, *forks[ i ]);
+        }
+
+        for( const std::unique_ptr< NodeVisitor >& fork: forks )
+            visitor.join( *fork );
+    }
+    visitor.visitPost();
+}
+
 
 }
@@ -55,6 +55,27 @@ public:
                              NodeVisitor& visitor,
                              const uint32_t timeStep );
 
+    /**
+     * Traverse the node tree starting from the root, with the subtrees at the
+     * given level traversed in parallel. The calling thread visits the nodes
+     * above the task level first. Each subtree rooted at the task level is
+     * then traversed as a task with its own visitor from NodeVisitor::fork(),
+     * and the forked visitors are joined in subtree order. If the visitor can
+     * not be forked, or only one thread is given, the subtrees are traversed
+     * sequentially.
+     * @param rootNode  The tree root information.
+     * @param visitor Visitor object.
+     * @param timeStep The temporal position of the node tree.
+     * @param taskLevel The level of the roots of the parallel subtrees.
+     * @param nThreads The maximum number of threads traversing the subtrees,
+     *        including the calling thread.
+     */
+    LIVRE_API void traverse( const RootNode& rootNode,
+                             NodeVisitor& visitor,
+                             const uint32_t timeStep,
+                             const uint32_t taskLevel,
+                             const size_t nThreads );
+
 private:
 
     struct Impl;
@@ -48,6 +48,25 @@ public:
 
     /** Called after all traversal. */
     virtual void visitPost() {};
+
+    /**
+     * Creates a visitor for a subtree which is traversed in parallel to this
+     * visitor. The forked visitor is not called with visitPre() and
+     * visitPost().
+     * @return the new visitor, or an empty pointer if the visitor can only be
+     * used sequentially.
+     */
+    virtual std::unique_ptr< NodeVisitor > fork() const
+    {
+        return std::unique_ptr< NodeVisitor >();
+    }
+
+    /**
+     * Merges the results of a visitor created by fork(). The forked visitors
+     * are joined in the order of their subtrees.
+     * @param forked the visitor which has traversed a subtree
+     */
+    virtual void join( NodeVisitor& forked LB_UNUSED ) {}
 };
 
 }
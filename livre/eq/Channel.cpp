@@ -42,6 +42,7 @@
 
 #include <livre/core/cache/Cache.h>
 #include <livre/core/cache/CacheStatistics.h>
+#include <livre/core/cache/PrefetchStatistics.h>
 #include <livre/core/data/DataSource.h>
 #include <livre/core/data/Histogram.h>
 #include <livre/core/render/FrameInfo.h>
@@ -107,7 +108,7 @@ struct SendHistogramFilter : public Filter
         const auto frameCounter =  inputs.get< uint32_t >( "Id" ).front();
 
         Histogram histogramAccumulated;
-        for( const auto& histogram: inputs.get< Histogram >( "Histogram" ))
+        for( const Histogram& histogram: inputs.getRefs< Histogram >( "Histogram" ))
                 histogramAccumulated += histogram;
 
         const_cast< eq::Config *>( _channel ->getConfig())->sendEvent( HISTOGRAM_DATA )
@@ -297,11 +298,29 @@ public:
                                  PixelViewport( pixVp.x, pixVp.y, pixVp.w, pixVp.h ),
                                  Viewport( vp.x, vp.y, vp.w, vp.h ),
                                  getFrameData().getRenderSettings().getClipPlanes(),
+                                 getFrameData().getRenderSettings().getBrickCost(),
                                },
-                               PipeFilterT< RedrawFilter >( "RedrawFilter", _channel ),
-                               PipeFilterT< SendHistogramFilter >( "SendHistogramFilter", _channel ),
+                               [this] { return PipeFilterT< RedrawFilter >(
+                                            "RedrawFilter", _channel ); },
+                               [this] { return PipeFilterT< SendHistogramFilter >(
+                                            "SendHistogramFilter", _channel ); },
                                *_renderer,
                                _availability );
+        sendFrameCost( renderPipeline.getFrameCost( *_renderer ));
+    }
+
+    /** Sends the measured costs of sort-last channels to the brick cost model */
+    void sendFrameCost( const FrameCost& frameCost ) const
+    {
+        if( _drawRange == eq::Range::ALL ||
+            ( frameCost.renderTime <= 0.f && frameCost.uploadTime <= 0.f ))
+        {
+            return;
+        }
+
+        const_cast< eq::Config* >( _channel->getConfig( ))->sendEvent( BRICK_COST )
+                << frameCost.renderTime << frameCost.renderedArea
+                << frameCost.uploadTime << frameCost.uploadedBytes;
     }
 
     void applyCamera()
@@ -318,6 +337,12 @@ public:
 
     void configExit()
     {
+        if( _renderer )
+        {
+            const livre::Window* window =
+                    static_cast< const livre::Window* >( _channel->getWindow( ));
+            window->getRenderPipeline().release( *_renderer );
+        }
         _frame.getFrameData()->flush();
     }
 
@@ -419,6 +444,21 @@ public:
            << int( 100.f * done + .5f ) << "% loaded" << std::endl
            << window->getTextureCache().getStatistics();
 
+        const FrameCost frameCost =
+                window->getRenderPipeline().getFrameCost( *_renderer );
+        if( frameCost.uploadTime > 0.f )
+        {
+            const float throughput = float( frameCost.uploadedBytes ) /
+                                     float( LB_1MB ) /
+                                     ( frameCost.uploadTime / 1000.f );
+            os << int( throughput + .5f ) << " MB/s uploaded" << std::endl;
+        }
+
+        const ConstPrefetchStatisticsPtr prefetchStatistics =
+                window->getRenderPipeline().getPrefetchStatistics( *_renderer );
+        if( prefetchStatistics )
+            os << *prefetchStatistics;
+
         float y = 260.f;
         std::string text = os.str();
         const eq::util::BitmapFont* font = _channel->getWindow()->getSmallFont();
@@ -68,7 +68,21 @@ public:
 
         ViewHistogram& operator+=( const ViewHistogram& hist )
         {
-            histogram += hist.histogram;
+            if( histogram.isCompatible( hist.histogram ))
+                histogram += hist.histogram;
+            else
+            {
+                // Rebin both to the combined range, the ranges of the
+                // rendering clients converge over the next frames
+                const Vector2f range( std::min( histogram.getMin(),
+                                                hist.histogram.getMin( )),
+                                      std::max( histogram.getMax(),
+                                                hist.histogram.getMax( )));
+                const size_t binCount = std::max( histogram.getBins().size(),
+                                                  hist.histogram.getBins().size( ));
+                histogram = histogram.rebin( range, binCount );
+                histogram += hist.histogram.rebin( range, binCount );
+            }
             area += hist.area;
             return *this;
         }
@@ -118,20 +132,8 @@ public:
 
             if( currentId == it->id )
             {
-                try
-                {
-                    *it += viewHistogram;
-                    dataMerged = true;
-                }
-                catch( std::runtime_error& )
-                {
-                    // Only compatible histograms can be added.( i.e same data
-                    // range and number of bins.) Until data range converges to
-                    // the full data range combined from all rendering clients,
-                    // the histograms are thrown away
-                    histogramQueue.erase( it, histogramQueue.end( ));
-                    return;
-                }
+                *it += viewHistogram;
+                dataMerged = true;
             }
             else if( currentId > it->id )
             {
@@ -374,6 +374,15 @@ bool EventHandler< C >::handleEvent( eq::EventICommand command )
         return false;
     }
 
+    case BRICK_COST:
+    {
+        FrameCost frameCost;
+        command >> frameCost.renderTime >> frameCost.renderedArea
+                >> frameCost.uploadTime >> frameCost.uploadedBytes;
+        _impl->config.getFrameData().getRenderSettings().addFrameCost( frameCost );
+        return false;
+    }
+
     case VOLUME_INFO:
         command >> _impl->config.getVolumeInformation();
         return false;
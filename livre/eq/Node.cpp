@@ -37,10 +37,13 @@
 
 #include <livre/core/data/DataSource.h>
 #include <livre/core/cache/Cache.h>
+#include <livre/core/util/Tracer.h>
 
 #include <eq/eq.h>
 #include <eq/gl.h>
 
+#include <fstream>
+
 namespace livre
 {
 struct Node::Impl
@@ -49,6 +52,7 @@ public:
     explicit Impl( livre::Node* node )
         : _node( node )
         , _config( static_cast< livre::Config* >( node->getConfig( )))
+        , _traceStarted( false )
     {}
 
     void initializeCache()
@@ -71,6 +75,24 @@ public:
             const VolumeSettings& volumeSettings = _config->getFrameData().getVolumeSettings();
             const lunchbox::URI& uri = lunchbox::URI( volumeSettings.getURI( ));
             _dataSource.reset( new livre::DataSource( uri ));
+
+            const uint32_t quantization =
+                    _config->getFrameData().getVRParameters().getQuantization();
+            switch( quantization )
+            {
+            case 0:
+                break;
+            case 8:
+                _dataSource->setQuantization( DT_UINT8 );
+                break;
+            case 16:
+                _dataSource->setQuantization( DT_UINT16 );
+                break;
+            default:
+                LBTHROW( std::runtime_error( "Unsupported quantization: " +
+                                             std::to_string( quantization ) +
+                                             " bits, use 8 or 16" ));
+            }
         }
         catch( const std::runtime_error& err )
         {
@@ -97,6 +119,31 @@ public:
     {
         if( !_node->isApplicationNode( ))
             _config->getFrameData().sync( frameId );
+        trace();
+    }
+
+    void trace()
+    {
+        if( !_traceStarted )
+        {
+            const uint32_t traceFrames =
+                    _config->getFrameData().getVRParameters().getTraceFrames();
+            if( traceFrames == 0 )
+                return;
+
+            _traceStarted = true;
+            Tracer::start( traceFrames );
+            return;
+        }
+
+        if( !Tracer::frame( ))
+            return;
+
+        const std::string filename = "livre-trace-" +
+                                     _node->getID().getShortString() + ".json";
+        std::ofstream file( filename );
+        Tracer::writeChromeTrace( file );
+        LBINFO << "Wrote pipeline trace to " << filename << std::endl;
     }
 
     void updateDataSource()
@@ -113,6 +160,7 @@ public:
     std::unique_ptr< DataSource > _dataSource;
     std::unique_ptr< Cache > _dataCache;
     std::unique_ptr< Cache > _histogramCache;
+    bool _traceStarted;
 };
 
 Node::Node( eq::Config* parent )
@@ -69,16 +69,21 @@ public:
 
         Node* node = static_cast< Node* >( _window->getNode( ));
         Pipe* pipe = static_cast< Pipe* >( _window->getPipe( ));
-        const size_t maxGpuMemory =
-                        pipe->getFrameData().getVRParameters().getMaxGPUCacheMemoryMB();
-
-        _texturePool.reset( new TexturePool( node->getDataSource( )));
+        const VolumeRendererParameters& vrParams = pipe->getFrameData().getVRParameters();
+        const size_t maxGpuMemory = vrParams.getMaxGPUCacheMemoryMB();
+
+        const size_t atlasSize = vrParams.getTextureAtlas() ?
+                                     maxGpuMemory * LB_1MB : 0;
+        _texturePool.reset( new TexturePool( node->getDataSource(),
+                                vrParams.getUploadBufferMemoryMB() * LB_1MB,
+                                atlasSize ));
         _textureCache.reset( new CacheT< TextureObject >( "TextureCache", maxGpuMemory * LB_1MB ));
         Caches caches = { node->getDataCache(), *_textureCache, node->getHistogramCache() };
         _renderPipeline.reset( new RenderPipeline( node->getDataSource(),
                                                    caches,
                                                    *_texturePool,
-                                                   _glContext ));
+                                                   _glContext,
+                                                   vrParams ));
     }
 
     void shareGLContexts()
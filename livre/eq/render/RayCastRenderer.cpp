@@ -31,6 +31,7 @@
 #include <livre/core/cache/Cache.h>
 #include <livre/core/data/DataSource.h>
 #include <livre/core/data/VolumeInformation.h>
+#include <livre/core/render/BrickOrder.h>
 #include <livre/core/render/GLSLShaders.h>
 #include <livre/core/render/Frustum.h>
 #include <livre/core/render/TransferFunction1D.h>
@@ -40,6 +41,8 @@
 #include <eq/eq.h>
 #include <eq/gl.h>
 
+#include <limits>
+
 namespace livre
 {
 namespace
@@ -49,31 +52,6 @@ const uint32_t SH_INT   = 1u;
 const uint32_t SH_FLOAT = 2u;
 }
 
-// Sort helper function for sorting the textures with their distances to viewpoint
-struct DistanceOperator
-{
-    explicit DistanceOperator( const DataSource& dataSource, const Frustum& frustum )
-        : _frustum( frustum )
-        , _dataSource( dataSource )
-    { }
-
-    bool operator()( const NodeId& rb1,
-                     const NodeId& rb2 )
-    {
-        const LODNode& lodNode1 = _dataSource.getNode( rb1 );
-        const LODNode& lodNode2 = _dataSource.getNode( rb2 );
-
-        const float distance1 = ( _frustum.getMVMatrix() *
-                                  lodNode1.getWorldBox().getCenter() ).length();
-        const float distance2 = ( _frustum.getMVMatrix() *
-                                  lodNode2.getWorldBox().getCenter() ).length();
-        return  distance1 < distance2;
-    }
-    const Frustum& _frustum;
-    const DataSource& _dataSource;
-};
-
-
 #define glewGetContext() GLContext::getCurrent()->glewGetContext()
 
 namespace
@@ -85,6 +63,8 @@ std::string where( const char* file, const int line )
 }
 
 const uint32_t maxSamplesPerRay = 32;
+// Cells of the page table above which the bricks are rendered one by one
+const size_t maxPageTableCells = 1u << 21;
 const uint32_t minSamplesPerRay = 512;
 const size_t nVerticesRenderBrick = 36;
 const GLfloat fullScreenQuad[] = { -1.0f, -1.0f, 0.0f,
@@ -110,6 +90,9 @@ struct RayCastRenderer::Impl
         , _textureCache( textureCache )
         , _dataSource( dataSource )
         , _volInfo( _dataSource.getVolumeInfo( ))
+        , _pageTableTexture( 0 )
+        , _brickTableTexture( 0 )
+        , _brickTableBuffer( 0 )
     {
         TransferFunction1D transferFunction;
         initTransferFunction( transferFunction );
@@ -140,14 +123,14 @@ struct RayCastRenderer::Impl
     {
         _renderTexture.flush();
         glDeleteBuffers( 1, &_quadVBO );
+        glDeleteTextures( 1, &_pageTableTexture );
+        glDeleteTextures( 1, &_brickTableTexture );
+        glDeleteBuffers( 1, &_brickTableBuffer );
     }
 
     NodeIds order( const NodeIds& bricks, const Frustum& frustum ) const
     {
-        NodeIds rbs = bricks;
-        DistanceOperator distanceOp( _dataSource, frustum );
-        std::sort( rbs.begin(), rbs.end(), distanceOp );
-        return rbs;
+        return orderFrontToBack( _dataSource, bricks, frustum );
     }
 
     void update( const FrameData& frameData )
@@ -308,7 +291,10 @@ struct RayCastRenderer::Impl
         glUniform1ui( tParamNameGL, getShaderDataType( ));
 
         // This is temporary. In the future it will be given by the gui.
+        // Quantized volumes map their data range to the range of their type.
         Vector2f dataSourceRange( 0.0f, 255.0f );
+        if( _dataSource.isQuantized( ))
+            dataSourceRange = _volInfo.dataRange;
         tParamNameGL = glGetUniformLocation( program, "dataSourceRange" );
         glUniform2fv( tParamNameGL, 1, dataSourceRange.array );
 
@@ -344,6 +330,15 @@ struct RayCastRenderer::Impl
         tParamNameGL = glGetUniformLocation( program, "transferFnTex" );
         glUniform1i( tParamNameGL, 1 );
 
+        tParamNameGL = glGetUniformLocation( program, "pageTable" );
+        glUniform1i( tParamNameGL, 2 );
+
+        tParamNameGL = glGetUniformLocation( program, "brickTable" );
+        glUniform1i( tParamNameGL, 3 );
+
+        tParamNameGL = glGetUniformLocation( program, "singlePass" );
+        glUniform1i( tParamNameGL, GL_FALSE );
+
         // Disable shader
         glUseProgram( 0 );
     }
@@ -355,7 +350,7 @@ struct RayCastRenderer::Impl
         for( const NodeId& rb: renderBricks )
         {
             const LODNode& lodNode = _dataSource.getNode( rb );
-            createBrick( lodNode, positions );
+            createBrick( lodNode.getWorldBox(), positions );
         }
 
         GLuint posVBO;
@@ -367,9 +362,8 @@ struct RayCastRenderer::Impl
         return posVBO;
     }
 
-    void createBrick( const LODNode& lodNode, Vector3fs& positions ) const
+    void createBrick( const Boxf& worldBox, Vector3fs& positions ) const
     {
-        const Boxf& worldBox = lodNode.getWorldBox();
         const Vector3f& minPos = worldBox.getMin();
         const Vector3f& maxPos = worldBox.getMax();
 
@@ -430,18 +424,193 @@ struct RayCastRenderer::Impl
 
     void onFrameRender( const NodeIds& bricks )
     {
-        const GLuint posVBO = createAndFillVertexBuffer( bricks );
+        if( !renderSinglePass( bricks ))
+        {
+            const GLuint posVBO = createAndFillVertexBuffer( bricks );
 
-        size_t index = 0;
-        for( const NodeId& brick: bricks )
-            renderBrick( brick, index++, posVBO );
+            size_t index = 0;
+            for( const NodeId& brick: bricks )
+                renderBrick( brick, index++, posVBO );
 
-        glDeleteBuffers( 1, &posVBO );
+            glDeleteBuffers( 1, &posVBO );
+        }
 
         // The flush is needed because the textures are loaded asynchronously by a thread pool.
         glFlush();
     }
 
+    /**
+     * Ray casts all bricks in one pass, if their textures are slots of one
+     * texture atlas. A page table maps the cells of the finest level of the
+     * bricks to the brick covering them.
+     * @return false if the bricks have to be rendered one by one
+     */
+    bool renderSinglePass( const NodeIds& bricks )
+    {
+        if( bricks.empty() || !_dataSource.hasRegularTree( ))
+            return false;
+
+        std::vector< const TextureState* > textureStates;
+        textureStates.reserve( bricks.size( ));
+        uint32_t maxLevel = 0;
+        for( const NodeId& brick: bricks )
+        {
+            const ConstTextureObjectPtr textureObj =
+                    std::static_pointer_cast< const TextureObject >(
+                        _textureCache.get( brick.getId( )));
+            if( !textureObj )
+                return false;
+
+            const TextureState& texState = textureObj->getTextureState();
+            if( texState.textureId == INVALID_TEXTURE_ID ||
+                ( !textureStates.empty() &&
+                  texState.textureId != textureStates.front()->textureId ))
+            {
+                return false;
+            }
+            textureStates.push_back( &texState );
+            maxLevel = std::max( maxLevel, brick.getLevel( ));
+        }
+
+        Vector3ui cellMin( std::numeric_limits< uint32_t >::max( ));
+        Vector3ui cellMax( 0u );
+        for( const NodeId& brick: bricks )
+        {
+            const uint32_t shift = maxLevel - brick.getLevel();
+            const Vector3ui& position = brick.getPosition();
+            for( size_t i = 0; i < 3; ++i )
+            {
+                cellMin[ i ] = std::min( cellMin[ i ], position[ i ] << shift );
+                cellMax[ i ] = std::max( cellMax[ i ],
+                                         ( position[ i ] + 1 ) << shift );
+            }
+        }
+
+        const Vector3ui cells = cellMax - cellMin;
+        const size_t nCells = size_t( cells[ 0 ]) * cells[ 1 ] * cells[ 2 ];
+        if( nCells > maxPageTableCells )
+            return false;
+
+        UInt32s pageTable( nCells, 0 );
+        Floats brickTable;
+        brickTable.reserve( 16 * bricks.size( ));
+        const auto appendTexel = [&brickTable]( const Vector3f& value )
+        {
+            brickTable.insert( brickTable.end(), value.array, value.array + 3 );
+            brickTable.push_back( 0.f );
+        };
+
+        for( size_t i = 0; i < bricks.size(); ++i )
+        {
+            const NodeId& brick = bricks[ i ];
+            const uint32_t shift = maxLevel - brick.getLevel();
+            const Vector3ui& position = brick.getPosition();
+            Vector3ui begin;
+            for( size_t j = 0; j < 3; ++j )
+                begin[ j ] = ( position[ j ] << shift ) - cellMin[ j ];
+            const uint32_t side = 1u << shift;
+
+            for( uint32_t z = begin[ 2 ]; z < begin[ 2 ] + side; ++z )
+                for( uint32_t y = begin[ 1 ]; y < begin[ 1 ] + side; ++y )
+                    std::fill_n( pageTable.begin() + begin[ 0 ] +
+                                 cells[ 0 ] * ( y + size_t( cells[ 1 ]) * z ),
+                                 side, uint32_t( i + 1 ));
+
+            const Boxf& worldBox = _dataSource.getNode( brick ).getWorldBox();
+            const TextureState& texState = *textureStates[ i ];
+            appendTexel( worldBox.getMin( ));
+            appendTexel( worldBox.getMax( ));
+            appendTexel( texState.textureCoordsMin );
+            appendTexel( texState.textureCoordsMax );
+            _usedTextures[1].push_back( texState.textureId );
+        }
+
+        uploadPageTable( cells, pageTable, brickTable );
+
+        // The cells have the world size of the blocks at the finest level, see
+        // DataSourcePlugin::internalNodeToLODNode()
+        const float cellsPerWorld =
+                _volInfo.rootNode.getBlockSize( maxLevel ).find_max();
+        const Vector3f halfWorldSize = _volInfo.worldSize * 0.5f;
+        const Boxf bounds( Vector3f( cellMin ) / cellsPerWorld - halfWorldSize,
+                           Vector3f( cellMax ) / cellsPerWorld - halfWorldSize );
+
+        GLSLShaders::Handle program = _rayCastShaders.getProgram( );
+        LBASSERT( program );
+        glUseProgram( program );
+
+        GLint tParamNameGL = glGetUniformLocation( program, "singlePass" );
+        glUniform1i( tParamNameGL, GL_TRUE );
+
+        tParamNameGL = glGetUniformLocation( program, "aabbMin" );
+        glUniform3fv( tParamNameGL, 1, bounds.getMin().array );
+
+        tParamNameGL = glGetUniformLocation( program, "aabbMax" );
+        glUniform3fv( tParamNameGL, 1, bounds.getMax().array );
+
+        tParamNameGL = glGetUniformLocation( program, "pageTableMin" );
+        glUniform3fv( tParamNameGL, 1, bounds.getMin().array );
+
+        tParamNameGL = glGetUniformLocation( program, "cellsPerWorld" );
+        glUniform1f( tParamNameGL, cellsPerWorld );
+
+        glActiveTexture( GL_TEXTURE0 );
+        textureStates.front()->bind();
+        tParamNameGL = glGetUniformLocation( program, "volumeTexFloat" );
+        glUniform1i( tParamNameGL, 0 );
+
+        Vector3fs positions;
+        positions.reserve( nVerticesRenderBrick );
+        createBrick( bounds, positions );
+
+        GLuint posVBO;
+        glGenBuffers( 1, &posVBO );
+        glBindBuffer( GL_ARRAY_BUFFER, posVBO );
+        glBufferData( GL_ARRAY_BUFFER, positions.size() * 3 * sizeof( float ),
+                      positions.data(), GL_STREAM_DRAW );
+
+        renderBrickVBO( 0, posVBO, false /* draw front */, true /* cull back */ );
+        glMemoryBarrier( GL_SHADER_IMAGE_ACCESS_BARRIER_BIT );
+        glDeleteBuffers( 1, &posVBO );
+
+        tParamNameGL = glGetUniformLocation( program, "singlePass" );
+        glUniform1i( tParamNameGL, GL_FALSE );
+        glUseProgram( 0 );
+        return true;
+    }
+
+    void uploadPageTable( const Vector3ui& cells, const UInt32s& pageTable,
+                          const Floats& brickTable )
+    {
+        if( _pageTableTexture == 0 )
+        {
+            glGenTextures( 1, &_pageTableTexture );
+            glBindTexture( GL_TEXTURE_3D, _pageTableTexture );
+            glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+            glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+            glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+            glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+            glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE );
+
+            glGenBuffers( 1, &_brickTableBuffer );
+            glGenTextures( 1, &_brickTableTexture );
+        }
+
+        glActiveTexture( GL_TEXTURE2 );
+        glBindTexture( GL_TEXTURE_3D, _pageTableTexture );
+        glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+        glTexImage3D( GL_TEXTURE_3D, 0, GL_R32UI, cells[ 0 ], cells[ 1 ], cells[ 2 ],
+                      0, GL_RED_INTEGER, GL_UNSIGNED_INT, pageTable.data( ));
+
+        glBindBuffer( GL_TEXTURE_BUFFER, _brickTableBuffer );
+        glBufferData( GL_TEXTURE_BUFFER, brickTable.size() * sizeof( float ),
+                      brickTable.data(), GL_STREAM_DRAW );
+        glActiveTexture( GL_TEXTURE3 );
+        glBindTexture( GL_TEXTURE_BUFFER, _brickTableTexture );
+        glTexBuffer( GL_TEXTURE_BUFFER, GL_RGBA32F, _brickTableBuffer );
+        glBindBuffer( GL_TEXTURE_BUFFER, 0 );
+    }
+
     void renderBrickVBO( const size_t index, const GLuint posVBO, bool front, bool back )
     {
         if( !front && !back )
@@ -570,6 +739,9 @@ struct RayCastRenderer::Impl
     const VolumeInformation& _volInfo;
     GLuint _quadVBO;
     GLint _drawBuffer;
+    GLuint _pageTableTexture;
+    GLuint _brickTableTexture;
+    GLuint _brickTableBuffer;
 };
 
 RayCastRenderer::RayCastRenderer( const DataSource& dataSource,
@@ -29,6 +29,7 @@
 #include <livre/core/cache/Cache.h>
 #include <livre/core/data/DataSource.h>
 #include <livre/core/data/VolumeInformation.h>
+#include <livre/core/render/BrickOrder.h>
 #include <livre/core/render/GLSLShaders.h>
 #include <livre/core/render/Frustum.h>
 #include <livre/core/render/TransferFunction1D.h>
@@ -47,31 +48,6 @@ const int32_t SH_INT   = 1;
 const int32_t SH_FLOAT = 2;
 }
 
-// Sort helper function for sorting the textures with their distances to viewpoint
-struct DistanceOperator
-{
-    explicit DistanceOperator( const DataSource& dataSource, const Frustum& frustum )
-        : _frustum( frustum )
-        , _dataSource( dataSource )
-    {}
-
-    bool operator()( const NodeId& rb1,
-                     const NodeId& rb2 )
-    {
-        const LODNode& lodNode1 = _dataSource.getNode( rb1 );
-        const LODNode& lodNode2 = _dataSource.getNode( rb2 );
-
-        const float distance1 = ( _frustum.getMVMatrix() *
-                                  lodNode1.getWorldBox().getCenter() ).length();
-        const float distance2 = ( _frustum.getMVMatrix() *
-                                  lodNode2.getWorldBox().getCenter() ).length();
-        return  distance1 < distance2;
-    }
-    const Frustum& _frustum;
-    const DataSource& _dataSource;
-};
-
-
 #define glewGetContext() GLContext::getCurrent()->glewGetContext()
 
 namespace
@@ -122,10 +98,7 @@ struct RayCastRenderer::Impl
     NodeIds order( const NodeIds& bricks,
                    const Frustum& frustum ) const
     {
-        NodeIds rbs = bricks;
-        DistanceOperator distanceOp( _dataSource, frustum );
-        std::sort( rbs.begin(), rbs.end(), distanceOp );
-        return rbs;
+        return orderFrontToBack( _dataSource, bricks, frustum );
     }
 
     void update( const FrameData& frameData )
@@ -276,7 +249,10 @@ struct RayCastRenderer::Impl
         }
 
         // This is temporary. In the future it will be given by the gui.
+        // Quantized volumes map their data range to the range of their type.
         Vector2f dataSourceRange( 0.0f, 255.0f );
+        if( _dataSource.isQuantized( ))
+            dataSourceRange = _volInfo.dataRange;
         tParamNameGL = glGetUniformLocation( program, "dataSourceRange" );
         glUniform2fv( tParamNameGL, 1, dataSourceRange.array );
 
@@ -19,6 +19,15 @@ uniform sampler3D volumeTexFloat;
 uniform usampler3D volumeTexUint;
 uniform isampler3D volumeTexInt;
 
+// Single pass over all bricks in a texture atlas: the page table has the brick
+// index + 1 of each cell at the finest level, the brick table the world box and
+// texture coordinates of each brick.
+uniform bool singlePass;
+uniform usampler3D pageTable;
+uniform samplerBuffer brickTable;
+uniform vec3 pageTableMin;
+uniform float cellsPerWorld;
+
 uniform vec2 dataSourceRange;
 
 uniform sampler1D transferFnTex;
@@ -88,6 +97,42 @@ vec3 calcTexturePositionFromAABBPos( vec3 pos )
     return ( pos - aabbMin ) / ( aabbMax - aabbMin ) * ( textureMax - textureMin ) + textureMin;
 }
 
+// Compute texture position in the brick covering the position, false if none.
+bool calcTexturePositionFromPageTable( vec3 pos, vec3 halfTexel, out vec3 texPos )
+{
+    ivec3 cell = ivec3( floor(( pos - pageTableMin ) * cellsPerWorld ));
+    if( any( lessThan( cell, ivec3( 0 ))) ||
+        any( greaterThanEqual( cell, textureSize( pageTable, 0 ))))
+    {
+        return false;
+    }
+
+    uint brick = texelFetch( pageTable, cell, 0 ).r;
+    if( brick == 0u )
+        return false;
+
+    int index = int( brick - 1u ) * 4;
+    vec3 brickMin = texelFetch( brickTable, index ).xyz;
+    vec3 brickMax = texelFetch( brickTable, index + 1 ).xyz;
+    vec3 brickTextureMin = texelFetch( brickTable, index + 2 ).xyz;
+    vec3 brickTextureMax = texelFetch( brickTable, index + 3 ).xyz;
+
+    texPos = ( pos - brickMin ) / ( brickMax - brickMin ) *
+             ( brickTextureMax - brickTextureMin ) + brickTextureMin;
+    texPos = clamp( texPos, brickTextureMin, brickTextureMax - halfTexel );
+    return true;
+}
+
+// Half the size of a texel, which keeps the samples inside the texture slot.
+vec3 calcHalfTexel()
+{
+    if( datatype == SH_UINT )
+        return 0.5 / vec3( textureSize( volumeTexUint, 0 ));
+    if( datatype == SH_INT )
+        return 0.5 / vec3( textureSize( volumeTexInt, 0 ));
+    return 0.5 / vec3( textureSize( volumeTexFloat, 0 ));
+}
+
 // AABB-Ray intersection ( http://prideout.net/blog/?p=64 ).
 bool intersectBox( Ray r, AABB aabb, out float t0, out float t1 )
 {
@@ -199,10 +244,20 @@ void main( void )
         const float multiplyer = 1 / ( dataSourceRange.g - dataSourceRange.r );
         const float addedValue = -dataSourceRange.r / ( dataSourceRange.g - dataSourceRange.r );
 
+        vec3 halfTexel = calcHalfTexel();
+
         // Front-to-back absorption-emission integrator
         for ( float travel = distance( rayStop, rayStart ); travel > 0.0; pos += step, travel -= stepSize )
         {
-            vec3 texPos = calcTexturePositionFromAABBPos( pos );
+            vec3 texPos;
+            if( singlePass )
+            {
+                if( !calcTexturePositionFromPageTable( pos, halfTexel, texPos ))
+                    continue;
+            }
+            else
+                texPos = clamp( calcTexturePositionFromAABBPos( pos ),
+                                textureMin, textureMax - halfTexel );
 
             float density = 0;
             if( datatype == SH_UINT )
@@ -32,8 +32,8 @@ namespace livre
 inline co::DataOStream& operator << ( co::DataOStream& os,
                                       const VolumeInformation& info )
 {
-    os << info.bigEndian << info.compCount << info.dataType << info.overlap
-       << info.maximumBlockSize << info.voxels << info.worldSize
+    os << info.bigEndian << info.compCount << info.dataType << info.dataRange
+       << info.overlap << info.maximumBlockSize << info.voxels << info.worldSize
        << info.dataToLivreTransform << info.resolution
        << info.worldSpacePerVoxel << info.meterToDataUnitRatio
        << info.rootNode.getDepth() << info.rootNode.getBlockSize()
@@ -46,8 +46,8 @@ inline co::DataIStream& operator >> ( co::DataIStream& is,
 {
     uint32_t depth;
     Vector3ui blockSize;
-    is >> info.bigEndian >> info.compCount >> info.dataType >> info.overlap
-       >> info.maximumBlockSize >> info.voxels >> info.worldSize
+    is >> info.bigEndian >> info.compCount >> info.dataType >> info.dataRange
+       >> info.overlap >> info.maximumBlockSize >> info.voxels >> info.worldSize
        >> info.dataToLivreTransform >> info.resolution
        >> info.worldSpacePerVoxel >> info.meterToDataUnitRatio >> depth
        >> blockSize >> info.frameRange >> info.description;
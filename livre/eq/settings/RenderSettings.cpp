@@ -55,6 +55,12 @@ void RenderSettings::setClipPlanes( const ClipPlanes& clipPlanes )
     setDirty( DIRTY_CLIPPLANES );
 }
 
+void RenderSettings::addFrameCost( const FrameCost& frameCost )
+{
+    _brickCost.addFrame( frameCost );
+    setDirty( DIRTY_BRICKCOST );
+}
+
 void RenderSettings::serialize( co::DataOStream& os, const uint64_t dirtyBits )
 {
     if( dirtyBits & DIRTY_TF )
@@ -66,6 +72,9 @@ void RenderSettings::serialize( co::DataOStream& os, const uint64_t dirtyBits )
     if( dirtyBits & DIRTY_CLIPPLANES )
         os << _clipPlanes;
 
+    if( dirtyBits & DIRTY_BRICKCOST )
+        os << _brickCost.getRenderCost() << _brickCost.getUploadCost();
+
     co::Serializable::serialize( os, dirtyBits );
 }
 
@@ -80,6 +89,13 @@ void RenderSettings::deserialize( co::DataIStream& is, const uint64_t dirtyBits
     if( dirtyBits & DIRTY_CLIPPLANES )
         is >> _clipPlanes;
 
+    if( dirtyBits & DIRTY_BRICKCOST )
+    {
+        float renderCost, uploadCost;
+        is >> renderCost >> uploadCost;
+        _brickCost = BrickCostModel( renderCost, uploadCost );
+    }
+
     co::Serializable::deserialize( is, dirtyBits );
 }
 
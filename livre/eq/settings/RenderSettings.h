@@ -24,6 +24,7 @@
 
 #include <livre/lib/types.h>
 
+#include <livre/core/render/BrickCost.h>
 #include <livre/core/render/TransferFunction1D.h>
 #include <livre/core/render/ClipPlanes.h>
 
@@ -71,6 +72,18 @@ public:
     ClipPlanes& getClipPlanes() { return _clipPlanes; }
     const ClipPlanes& getClipPlanes( ) const { return _clipPlanes; }
 
+    /**
+     * Adds the measured costs of a frame to the brick cost model shared by
+     * the sort-last channels.
+     * @param frameCost the measured costs
+     */
+    void addFrameCost( const FrameCost& frameCost );
+
+    /**
+     * @return the brick cost model.
+     */
+    const BrickCostModel& getBrickCost() const { return _brickCost; }
+
     /**
      * @brief adjustQuality Adjusts the quality.
      * @param delta The adjustment factor.
@@ -94,13 +107,15 @@ private:
     TransferFunction1D _transferFunction;
     ClipPlanes _clipPlanes;
     uint8_t _depth;
+    BrickCostModel _brickCost;
 
     /** The changed parts of the data since the last pack(). */
     enum DirtyBits
     {
         DIRTY_TF = co::Serializable::DIRTY_CUSTOM << 0u,
         DIRTY_DEPTH = co::Serializable::DIRTY_CUSTOM << 1u,
-        DIRTY_CLIPPLANES = co::Serializable::DIRTY_CUSTOM << 2u
+        DIRTY_CLIPPLANES = co::Serializable::DIRTY_CUSTOM << 2u,
+        DIRTY_BRICKCOST = co::Serializable::DIRTY_CUSTOM << 3u
     };
 };
 
@@ -28,94 +28,314 @@
 
 #include <eq/gl.h>
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 namespace livre
 {
 namespace
 {
+// Histograms are binned from pipeline workers, which already keep the cores
+// busy with one brick each. Only bricks far larger than the usual block sizes
+// (256^3 voxels and up) spread over OpenMP threads, the others are binned by
+// the calling thread only.
+const size_t minParallelVoxels = 1u << 24;
+
+/** The rows of a brick without its overlap, contiguous in memory. */
+struct BrickRows
+{
+    BrickRows( const Vector3ui& blockSize_, const Vector3ui& padding_,
+               const size_t compCount_ )
+        : blockSize( blockSize_ )
+        , padding( padding_ )
+        , dataBlockSize( blockSize_ + padding_ * 2 )
+        , compCount( compCount_ )
+        , nRows( size_t( blockSize_.x( )) * blockSize_.y( ))
+        , length( blockSize_.z() * compCount_ )
+    {}
+
+    template< class T >
+    const T* get( const T* data, const size_t row ) const
+    {
+        const size_t i = row / blockSize.y() + padding.x();
+        const size_t j = row % blockSize.y() + padding.y();
+        return data + compCount * ( i * dataBlockSize.y() * dataBlockSize.z() +
+                                    j * dataBlockSize.z() + padding.z( ));
+    }
+
+    const Vector3ui blockSize;
+    const Vector3ui padding;
+    const Vector3ui dataBlockSize;
+    const size_t compCount;
+    const size_t nRows; //!< Number of rows
+    const size_t length; //!< Number of values per row
+};
 
 template< class SRC_TYPE >
-void binData( const SRC_TYPE* rawData,
-              Histogram& histogram,
-              const Vector3ui& blockSize,
-              const Vector3ui& padding,
-              const size_t compCount,
-              const uint64_t scaleFactor )
+size_t getBinCount()
 {
-    const size_t binCount = histogram.getBins().size();
-    uint64_t* dstData = histogram.getBins().data();
+    return sizeof( SRC_TYPE ) == 1 ? 256 : sizeof( SRC_TYPE ) == 2 ? 1024 : 4096;
+}
 
-    if( std::is_integral< SRC_TYPE >::value )
+/** Bins the 8 and 16 bit types through a table indexed by value - min. */
+template< class SRC_TYPE >
+class LUTBinner
+{
+public:
+    LUTBinner()
     {
-        histogram.setMin( std::numeric_limits< SRC_TYPE >::min( ));
-        histogram.setMax( std::numeric_limits< SRC_TYPE >::max( ));
+        static_assert( sizeof( SRC_TYPE ) <= 2, "Lookup table is too large" );
+        const size_t range = size_t( 1 ) << ( sizeof( SRC_TYPE ) * 8 );
+        const size_t perBinCount = range / getBinCount< SRC_TYPE >();
+        _lut.resize( range );
+        for( size_t i = 0; i < range; ++i )
+            _lut[ i ] = uint16_t( i / perBinCount );
     }
-    else
+
+    void operator()( const SRC_TYPE* data, const size_t count,
+                     uint64_t* bins ) const
     {
-        double minVal = histogram.getMin();
-        double maxVal = histogram.getMax();
+        const int32_t min = std::numeric_limits< SRC_TYPE >::min();
+        const uint16_t* lut = _lut.data();
+        for( size_t i = 0; i < count; ++i )
+            ++bins[ lut[ int32_t( data[ i ]) - min ]];
+    }
 
-        const Vector3ui dataBlockSize = blockSize + padding * 2;
-        for( size_t i = padding.x(); i < dataBlockSize.x() - padding.x(); ++i )
-            for( size_t j = padding.y(); j < dataBlockSize.y() - padding.y(); ++j )
-                for( size_t k = padding.z(); k < dataBlockSize.z() - padding.z(); ++k )
-                    for( size_t c = 0; c < compCount; ++c )
-                    {
-                        const size_t index = compCount * i * dataBlockSize.y() * dataBlockSize.z() +
-                                             compCount * j * dataBlockSize.z() +
-                                             compCount * k + c;
-                        const double data = rawData[ index ];
-                        if( data < minVal )
-                            minVal = data;
-                        if( data > maxVal )
-                            maxVal = data;
-                    }
-
-        histogram.setMin( minVal );
-        histogram.setMax( maxVal );
-
-        if(( maxVal - minVal ) == 0.0f )
+private:
+    std::vector< uint16_t > _lut;
+};
+
+/** Bins the 32 bit integer types, shifting if bins are a power of two wide. */
+template< class SRC_TYPE >
+class IntegerBinner
+{
+public:
+    IntegerBinner()
+        : _perBinCount( ( uint64_t( 1 ) << 32 ) / getBinCount< SRC_TYPE >( ))
+        , _shift( 0 )
+    {
+        if( ( _perBinCount & ( _perBinCount - 1 )) == 0 )
+            while(( uint64_t( 1 ) << _shift ) < _perBinCount )
+                ++_shift;
+    }
+
+    void operator()( const SRC_TYPE* data, const size_t count,
+                     uint64_t* bins ) const
+    {
+        const int64_t min = std::numeric_limits< SRC_TYPE >::min();
+        if( _shift > 0 )
         {
-            histogram.getBins().clear();
-            const size_t bins = ( dataBlockSize - padding ).product() * scaleFactor * compCount;
-            histogram.getBins().push_back( bins );
+            for( size_t i = 0; i < count; ++i )
+                ++bins[ uint64_t( int64_t( data[ i ]) - min ) >> _shift ];
             return;
         }
+        for( size_t i = 0; i < count; ++i )
+            ++bins[ uint64_t( int64_t( data[ i ]) - min ) / _perBinCount ];
+    }
+
+private:
+    const uint64_t _perBinCount;
+    uint32_t _shift;
+};
+
+/** Bins floats linearly between min and max, clamping to the outer bins. */
+class FloatBinner
+{
+public:
+    FloatBinner( const float min, const float max, const size_t binCount )
+        : _min( min )
+        , _scale( float( binCount ) / ( max - min ))
+        , _lastBin( float( binCount - 1 ))
+    {}
+
+    void operator()( const float* data, const size_t count,
+                     uint64_t* bins ) const
+    {
+        size_t i = 0;
+#ifdef __SSE2__
+        const __m128 min = _mm_set1_ps( _min );
+        const __m128 scale = _mm_set1_ps( _scale );
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 lastBin = _mm_set1_ps( _lastBin );
+        alignas( 16 ) int32_t indices[ 4 ];
+        for( ; i + 4 <= count; i += 4 )
+        {
+            __m128 bin = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( data + i ), min ),
+                                     scale );
+            bin = _mm_min_ps( _mm_max_ps( bin, zero ), lastBin );
+            _mm_store_si128( (__m128i*)indices, _mm_cvttps_epi32( bin ));
+            ++bins[ indices[ 0 ]];
+            ++bins[ indices[ 1 ]];
+            ++bins[ indices[ 2 ]];
+            ++bins[ indices[ 3 ]];
+        }
+#endif
+        for( ; i < count; ++i )
+        {
+            // NaN fails every comparison and goes to the first bin, as in
+            // the vectorized loop above
+            const float bin = ( data[ i ] - _min ) * _scale;
+            ++bins[ size_t( !( bin > 0.f ) ? 0.f : std::min( bin, _lastBin ))];
+        }
+    }
+
+private:
+    const float _min;
+    const float _scale;
+    const float _lastBin;
+};
+
+/** Extends [minVal, maxVal] with the values of the given row. NaNs are ignored. */
+void minMax( const float* data, const size_t count, float& minVal, float& maxVal )
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    if( count >= 4 )
+    {
+        __m128 mins = _mm_set1_ps( minVal );
+        __m128 maxs = _mm_set1_ps( maxVal );
+        for( ; i + 4 <= count; i += 4 )
+        {
+            const __m128 values = _mm_loadu_ps( data + i );
+            mins = _mm_min_ps( values, mins );
+            maxs = _mm_max_ps( values, maxs );
+        }
+
+        float minArray[ 4 ], maxArray[ 4 ];
+        _mm_storeu_ps( minArray, mins );
+        _mm_storeu_ps( maxArray, maxs );
+        for( size_t j = 0; j < 4; ++j )
+        {
+            minVal = std::min( minVal, minArray[ j ]);
+            maxVal = std::max( maxVal, maxArray[ j ]);
+        }
     }
+#endif
+    for( ; i < count; ++i )
+    {
+        if( data[ i ] < minVal )
+            minVal = data[ i ];
+        if( data[ i ] > maxVal )
+            maxVal = data[ i ];
+    }
+}
 
+void minMax( const float* rawData, const BrickRows& rows,
+             float& minVal, float& maxVal )
+{
+    const size_t nVoxels = rows.nRows * rows.length;
+    #pragma omp parallel if( nVoxels >= minParallelVoxels )
+    {
+        float localMin = minVal;
+        float localMax = maxVal;
+
+        #pragma omp for schedule( static )
+        for( int64_t row = 0; row < int64_t( rows.nRows ); ++row )
+            minMax( rows.get( rawData, row ), rows.length, localMin, localMax );
 
-    const Vector3ui dataBlockSize = blockSize + padding * 2;
-    for( size_t i = padding.x(); i < dataBlockSize.x() - padding.x(); ++i )
-        for( size_t j = padding.y(); j < dataBlockSize.y() - padding.y(); ++j )
-            for( size_t k = padding.z(); k < dataBlockSize.z() - padding.z(); ++k )
-                for( size_t c = 0; c < compCount; ++c )
-                {
-                    const size_t index = compCount * i * dataBlockSize.y() * dataBlockSize.z() +
-                                         compCount * j * dataBlockSize.z() +
-                                         compCount * k + c;
-
-                    size_t binIndex = 0;
-                    if( std::is_integral< SRC_TYPE >::value )
-                    {
-                        const size_t range =
-                                std::lround( histogram.getMax() - histogram.getMin( )) + 1u;
-                        const size_t perBinCount = range / binCount;
-                        binIndex = ( rawData[ index ] - std::lround( histogram.getMin( )))
-                                     / perBinCount;
-                    }
-                    else
-                    {
-                        const double data = rawData[ index ];
-                        if( data == histogram.getMax( ))
-                            binIndex = binCount - 1;
-                        else
-                        {
-                            const double range = histogram.getMax() - histogram.getMin();
-                            const double perBinCount = range / binCount;
-                            binIndex = ( rawData[ index ] - histogram.getMin( )) / perBinCount;
-                        }
-                    }
-                    dstData[ binIndex ] += scaleFactor;
-                }
+        #pragma omp critical
+        {
+            minVal = std::min( minVal, localMin );
+            maxVal = std::max( maxVal, localMax );
+        }
+    }
+}
+
+/**
+ * Accumulates the brick into per-thread sub-histograms, which are merged into
+ * the scaled bins of the histogram at the end.
+ */
+template< class SRC_TYPE, class BINNER >
+void binRows( const SRC_TYPE* rawData, const BrickRows& rows,
+              const BINNER& binner, Histogram& histogram,
+              const uint64_t scaleFactor )
+{
+    const size_t binCount = histogram.getBins().size();
+    uint64_t* dstData = histogram.getBins().data();
+    const size_t nVoxels = rows.nRows * rows.length;
+
+    #pragma omp parallel if( nVoxels >= minParallelVoxels )
+    {
+        std::vector< uint64_t > bins( binCount, 0 );
+
+        #pragma omp for schedule( static )
+        for( int64_t row = 0; row < int64_t( rows.nRows ); ++row )
+            binner( rows.get( rawData, row ), rows.length, bins.data( ));
+
+        #pragma omp critical
+        for( size_t i = 0; i < binCount; ++i )
+            dstData[ i ] += bins[ i ] * scaleFactor;
+    }
+}
+
+template< class SRC_TYPE >
+void binData( const SRC_TYPE* rawData,
+              Histogram& histogram,
+              const Vector3ui& blockSize,
+              const Vector3ui& padding,
+              const size_t compCount,
+              const uint64_t scaleFactor )
+{
+    static const LUTBinner< SRC_TYPE > binner;
+
+    histogram.resize( getBinCount< SRC_TYPE >( ));
+    histogram.setMin( std::numeric_limits< SRC_TYPE >::min( ));
+    histogram.setMax( std::numeric_limits< SRC_TYPE >::max( ));
+    binRows( rawData, BrickRows( blockSize, padding, compCount ), binner,
+             histogram, scaleFactor );
+}
+
+template<>
+void binData( const uint32_t* rawData, Histogram& histogram,
+              const Vector3ui& blockSize, const Vector3ui& padding,
+              const size_t compCount, const uint64_t scaleFactor )
+{
+    histogram.resize( getBinCount< uint32_t >( ));
+    histogram.setMin( std::numeric_limits< uint32_t >::min( ));
+    histogram.setMax( std::numeric_limits< uint32_t >::max( ));
+    binRows( rawData, BrickRows( blockSize, padding, compCount ),
+             IntegerBinner< uint32_t >(), histogram, scaleFactor );
+}
+
+template<>
+void binData( const int32_t* rawData, Histogram& histogram,
+              const Vector3ui& blockSize, const Vector3ui& padding,
+              const size_t compCount, const uint64_t scaleFactor )
+{
+    histogram.resize( getBinCount< int32_t >( ));
+    histogram.setMin( std::numeric_limits< int32_t >::min( ));
+    histogram.setMax( std::numeric_limits< int32_t >::max( ));
+    binRows( rawData, BrickRows( blockSize, padding, compCount ),
+             IntegerBinner< int32_t >(), histogram, scaleFactor );
+}
+
+/** The histogram range is extended from its current min and max */
+template<>
+void binData( const float* rawData, Histogram& histogram,
+              const Vector3ui& blockSize, const Vector3ui& padding,
+              const size_t compCount, const uint64_t scaleFactor )
+{
+    const BrickRows rows( blockSize, padding, compCount );
+    float minVal = histogram.getMin();
+    float maxVal = histogram.getMax();
+    minMax( rawData, rows, minVal, maxVal );
+
+    histogram.setMin( minVal );
+    histogram.setMax( maxVal );
+
+    if(( maxVal - minVal ) == 0.0f )
+    {
+        const Vector3ui dataBlockSize = blockSize + padding * 2;
+        histogram.getBins().clear();
+        const size_t bins = ( dataBlockSize - padding ).product() * scaleFactor * compCount;
+        histogram.getBins().push_back( bins );
+        return;
+    }
+
+    histogram.resize( getBinCount< float >( ));
+    binRows( rawData, rows, FloatBinner( minVal, maxVal, getBinCount< float >( )),
+             histogram, scaleFactor );
 }
 }
 
@@ -128,11 +348,18 @@ public:
           const DataSource& dataSource,
           const Vector2f& dataSourceRange )
         :  _size( 0 )
+        , _isDerived( false )
     {
        if( !load( cacheId, dataCache, dataSource, dataSourceRange ))
             LBTHROW( CacheLoadException( cacheId, "Unable to construct histogram cache object" ));
     }
 
+    Impl( const Histogram& histogram, const bool isDerived )
+        : _histogram( histogram )
+        , _size( sizeof( uint64_t ) * histogram.getBins().size( ))
+        , _isDerived( isDerived )
+    {}
+
 
     bool load( const CacheId& cacheId,
                const Cache& dataCache,
@@ -164,37 +391,30 @@ public:
         switch( dataType )
         {
            case DT_UINT8:
-                _histogram.resize( 256 );
                 binData( static_cast< const uint8_t* >( rawData ),
                          _histogram, voxelBox, padding, compCount, scaleFactor );
                 break;
            case DT_UINT16:
-                _histogram.resize( 1024 );
                 binData( static_cast< const uint16_t* >( rawData ),
                          _histogram, voxelBox, padding, compCount, scaleFactor );
                 break;
            case DT_UINT32:
-                _histogram.resize( 4096 );
                 binData( static_cast< const uint32_t* >( rawData ),
                          _histogram, voxelBox, padding, compCount, scaleFactor );
                 break;
            case DT_INT8:
-                _histogram.resize( 256 );
                 binData( static_cast< const int8_t* >( rawData ),
                          _histogram, voxelBox, padding, compCount, scaleFactor );
                 break;
            case DT_INT16:
-                _histogram.resize( 1024 );
                 binData( static_cast< const int16_t* >( rawData ),
                          _histogram, voxelBox, padding, compCount, scaleFactor );
                 break;
            case DT_INT32:
-                _histogram.resize( 4096 );
                 binData( static_cast< const int32_t* >( rawData ),
                          _histogram, voxelBox, padding, compCount, scaleFactor );
                 break;
            case DT_FLOAT:
-                _histogram.resize( 4096 );
                 _histogram.setMin( dataSourceRange[ 0 ] );
                 _histogram.setMax( dataSourceRange[ 1 ] );
                 binData( static_cast< const float* >( rawData ),
@@ -213,6 +433,7 @@ public:
 
     Histogram _histogram;
     size_t _size;
+    bool _isDerived;
 };
 
 HistogramObject::HistogramObject( const CacheId& cacheId,
@@ -223,6 +444,13 @@ HistogramObject::HistogramObject( const CacheId& cacheId,
     , _impl( new Impl( cacheId, dataCache, dataSource, dataSourceRange ))
 {}
 
+HistogramObject::HistogramObject( const CacheId& cacheId,
+                                  const Histogram& histogram,
+                                  const bool isDerived )
+    : CacheObject( cacheId )
+    , _impl( new Impl( histogram, isDerived ))
+{}
+
 HistogramObject::~HistogramObject()
 {}
 
@@ -236,4 +464,9 @@ const Histogram& HistogramObject::getHistogram() const
     return _impl->_histogram;
 }
 
+bool HistogramObject::isDerived() const
+{
+    return _impl->_isDerived;
+}
+
 }
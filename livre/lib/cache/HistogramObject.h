@@ -49,6 +49,17 @@ public:
                                const DataSource& dataSource,
                                const Vector2f& dataSourceRange );
 
+    /**
+     * Constructor from an already computed histogram, e.g. the sum of the
+     * histograms of the children of a node.
+     * @param cacheId is the unique identifier
+     * @param histogram the histogram of the node
+     * @param isDerived true if the histogram is the sum of the children
+     */
+    LIVRE_API HistogramObject( const CacheId& cacheId,
+                               const Histogram& histogram,
+                               bool isDerived );
+
     LIVRE_API ~HistogramObject();
 
     /** @copydoc livre::CacheObject::getSize */
@@ -57,6 +68,12 @@ public:
     /** @return the histogram */
     LIVRE_API const Histogram& getHistogram() const;
 
+    /**
+     * @return true if the histogram is the sum of the histograms of the
+     * children, false if it is binned from the voxels of the node
+     */
+    LIVRE_API bool isDerived() const;
+
 private:
 
     struct Impl;
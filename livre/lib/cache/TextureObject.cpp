@@ -26,8 +26,7 @@
 #include <livre/core/render/GLContext.h>
 #include <livre/core/render/Renderer.h>
 #include <livre/core/render/TexturePool.h>
-
-#include <eq/gl.h>
+#include <livre/core/util/Tracer.h>
 
 namespace livre
 {
@@ -40,8 +39,6 @@ size_t getTextureSize( const DataSource& dataSource )
 }
 }
 
-#define glewGetContext() GLContext::glewGetContext()
-
 /**
  * The TextureObject class holds the informarmation for the data which is on the GPU.
   */
@@ -66,7 +63,7 @@ struct TextureObject::Impl
     bool load( const CacheId& cacheId,
                const Cache& dataCache,
                const DataSource& dataSource,
-               const TexturePool& texturePool )
+               TexturePool& texturePool )
     {
         ConstDataObjectPtr data = dataCache.get< DataObject >( cacheId );
         if( !data )
@@ -78,7 +75,7 @@ struct TextureObject::Impl
 
     void initialize( const CacheId& cacheId,
                      const DataSource& dataSource,
-                     const TexturePool& texturePool,
+                     TexturePool& texturePool,
                      const ConstDataObjectPtr& data )
     {
         // TODO: The internal format size should be calculated correctly
@@ -87,8 +84,11 @@ struct TextureObject::Impl
         const Vector3f& size = lodNode.getVoxelBox().getSize();
         const Vector3f& maxSize = dataSource.getVolumeInfo().maximumBlockSize;
         const Vector3f& overlapf = overlap / maxSize;
-        _textureState.textureCoordsMax = overlapf + size / maxSize;
-        _textureState.textureCoordsMin = overlapf;
+        _textureState.textureCoordsMax =
+                texturePool.getTextureCoords( _textureState,
+                                              overlapf + size / maxSize );
+        _textureState.textureCoordsMin =
+                texturePool.getTextureCoords( _textureState, overlapf );
         _textureState.textureSize = _textureState.textureCoordsMax -
                                     _textureState.textureCoordsMin;
 
@@ -97,7 +97,7 @@ struct TextureObject::Impl
 
     bool loadTextureToGPU( const LODNode& lodNode,
                            const DataSource& dataSource,
-                           const TexturePool& texturePool,
+                           TexturePool& texturePool,
                            const ConstDataObjectPtr& data ) const
     {
     #ifdef LIVRE_DEBUG_RENDERING
@@ -105,24 +105,11 @@ struct TextureObject::Impl
                   << lodNode.getRelativePosition() << " to "
                   << _textureState.textureId << std::endl;
     #endif
+        const Tracer::Scope trace( "upload", "TextureUpload" );
         const Vector3ui& overlap = dataSource.getVolumeInfo().overlap;
         const Vector3ui& voxSizeVec = lodNode.getBlockSize() + overlap * 2;
-        _textureState.bind();
-
-        glTexSubImage3D( GL_TEXTURE_3D, 0, 0, 0, 0,
-                         voxSizeVec[0], voxSizeVec[1], voxSizeVec[2],
-                         texturePool.getFormat() ,
-                         texturePool.getTextureType(),
-                         data->getDataPtr( ));
-
-        const GLenum glErr = glGetError();
-        if ( glErr != GL_NO_ERROR )
-        {
-            LBERROR << "Error loading the texture into GPU, error number : "  << glErr << std::endl;
-            return false;
-        }
-
-        return true;
+        return texturePool.uploadTexture( _textureState, data->getDataPtr(),
+                                          voxSizeVec );
     }
 
     TextureState _textureState;
@@ -39,6 +39,9 @@ public:
      * @param cacheId is the unique identifier
      * @param dataCache source for the raw data
      * @param dataSource provides information about spatial structure of texture
+     * @param texturePool the pool of the texture slots. The copy of the data
+     * to the GPU may still be in progress when the constructor returns, see
+     * TexturePool::uploadTexture()
      * @throws CacheLoadException when the data cache does not have the data for cache id
      */
     LIVRE_API TextureObject( const CacheId& cacheId,
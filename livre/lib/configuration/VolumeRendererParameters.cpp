@@ -20,6 +20,9 @@
 
 #include "VolumeRendererParameters.h"
 
+#include <algorithm>
+#include <thread>
+
 namespace livre
 {
 
@@ -31,6 +34,17 @@ const std::string MINLOD_PARAM = "min-lod";
 const std::string MAXLOD_PARAM = "max-lod";
 const std::string SAMPLESPERRAY_PARAM = "samples-per-ray";
 const std::string SAMPLESPERPIXEL_PARAM = "samples-per-pixel";
+const std::string QUANTIZATION_PARAM = "quantization";
+const std::string TRACEFRAMES_PARAM = "trace-frames";
+const std::string RENDERTHREADS_PARAM = "render-threads";
+const std::string COMPUTETHREADS_PARAM = "compute-threads";
+const std::string UPLOADTHREADS_PARAM = "upload-threads";
+const std::string AUTOTUNETHREADS_PARAM = "auto-tune-threads";
+const std::string BUDGETEDLOD_PARAM = "budgeted-lod";
+const std::string PREFETCHFRAMES_PARAM = "prefetch-frames";
+const std::string PREFETCHTEXTURES_PARAM = "prefetch-textures";
+const std::string UPLOADBUFFERMEM_PARAM = "upload-buffer-mem";
+const std::string TEXTUREATLAS_PARAM = "texture-atlas";
 
 VolumeRendererParameters::VolumeRendererParameters()
     : Parameters( "Volume Renderer Parameters" )
@@ -63,6 +77,71 @@ VolumeRendererParameters::VolumeRendererParameters()
                                    getSamplesPerRay( ));
     configuration_.addDescription( configGroupName_, SAMPLESPERPIXEL_PARAM,
                                    "Number of samples per pixel", getSamplesPerPixel( ));
+    configuration_.addDescription( configGroupName_, QUANTIZATION_PARAM,
+                                   "Quantize the volume data to 8 or 16 bits per"
+                                   " voxel when loading, 0 (default) keeps the"
+                                   " original data type", getQuantization( ));
+    configuration_.addDescription( configGroupName_, TRACEFRAMES_PARAM,
+                                   "Trace the pipeline execution for the given"
+                                   " number of frames and write it as Chrome"
+                                   " trace JSON (about:tracing) per node",
+                                   getTraceFrames( ));
+    configuration_.addDescription( configGroupName_, RENDERTHREADS_PARAM,
+                                   "Number of threads for the rendering"
+                                   " filters", getRenderThreads( ));
+    configuration_.addDescription( configGroupName_, COMPUTETHREADS_PARAM,
+                                   "Number of threads for the histogram"
+                                   " computation", getComputeThreads( ));
+    configuration_.addDescription( configGroupName_, UPLOADTHREADS_PARAM,
+                                   "Number of threads loading and uploading"
+                                   " the data", getUploadThreads( ));
+    configuration_.addDescription( configGroupName_, AUTOTUNETHREADS_PARAM,
+                                   "Tune the number of upload threads for the"
+                                   " highest throughput during the first"
+                                   " frames", getAutoTuneThreads( ));
+    configuration_.addDescription( configGroupName_, BUDGETEDLOD_PARAM,
+                                   "Select the levels of detail by refining"
+                                   " the highest screen space error first,"
+                                   " until the nodes fill the GPU cache memory",
+                                   getBudgetedLOD( ));
+    configuration_.addDescription( configGroupName_, PREFETCHFRAMES_PARAM,
+                                   "Predict the camera the given number of"
+                                   " frames ahead and load the data it will"
+                                   " see in the background, 0 (default)"
+                                   " disables prefetching", getPrefetchFrames( ));
+    configuration_.addDescription( configGroupName_, PREFETCHTEXTURES_PARAM,
+                                   "Upload the prefetched data to textures",
+                                   getPrefetchTextures( ));
+    configuration_.addDescription( configGroupName_, UPLOADBUFFERMEM_PARAM,
+                                   "Pixel buffer memory (MB) the upload threads"
+                                   " stream the textures through, 0 uploads"
+                                   " them directly from the data",
+                                   getUploadBufferMemoryMB( ));
+    configuration_.addDescription( configGroupName_, TEXTUREATLAS_PARAM,
+                                   "Pack the textures in slots of one 3D"
+                                   " texture with the size of the GPU cache"
+                                   " memory, and ray cast all of them in a"
+                                   " single pass", getTextureAtlas( ));
+}
+
+size_t VolumeRendererParameters::getMaxUploadThreads() const
+{
+    const size_t nUploadThreads = getUploadThreads();
+    if( !getAutoTuneThreads( ))
+        return nUploadThreads;
+
+    const size_t nCores = std::thread::hardware_concurrency();
+    const size_t nOtherThreads = getRenderThreads() + getComputeThreads();
+    return std::max( nUploadThreads,
+                     nCores > nOtherThreads ? nCores - nOtherThreads : 1 );
+}
+
+size_t VolumeRendererParameters::getFreeCores() const
+{
+    const size_t nCores = std::thread::hardware_concurrency();
+    const size_t nThreads = getRenderThreads() + getComputeThreads() +
+                            getMaxUploadThreads();
+    return nCores > nThreads ? nCores - nThreads : 0;
 }
 
 void VolumeRendererParameters::initialize_()
@@ -80,6 +159,28 @@ void VolumeRendererParameters::initialize_()
                                                getSamplesPerRay( )));
     setSamplesPerPixel( configuration_.getValue( SAMPLESPERPIXEL_PARAM,
                                                  getSamplesPerPixel( )));
+    setQuantization( configuration_.getValue( QUANTIZATION_PARAM,
+                                              getQuantization( )));
+    setTraceFrames( configuration_.getValue( TRACEFRAMES_PARAM,
+                                             getTraceFrames( )));
+    setRenderThreads( configuration_.getValue( RENDERTHREADS_PARAM,
+                                               getRenderThreads( )));
+    setComputeThreads( configuration_.getValue( COMPUTETHREADS_PARAM,
+                                                getComputeThreads( )));
+    setUploadThreads( configuration_.getValue( UPLOADTHREADS_PARAM,
+                                               getUploadThreads( )));
+    setAutoTuneThreads( configuration_.getValue( AUTOTUNETHREADS_PARAM,
+                                                 getAutoTuneThreads( )));
+    setBudgetedLOD( configuration_.getValue( BUDGETEDLOD_PARAM,
+                                             getBudgetedLOD( )));
+    setPrefetchFrames( configuration_.getValue( PREFETCHFRAMES_PARAM,
+                                                getPrefetchFrames( )));
+    setPrefetchTextures( configuration_.getValue( PREFETCHTEXTURES_PARAM,
+                                                  getPrefetchTextures( )));
+    setUploadBufferMemoryMB( configuration_.getValue( UPLOADBUFFERMEM_PARAM,
+                                                      getUploadBufferMemoryMB( )));
+    setTextureAtlas( configuration_.getValue( TEXTUREATLAS_PARAM,
+                                              getTextureAtlas( )));
 }
 
 } //Livre
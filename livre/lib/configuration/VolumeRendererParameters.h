@@ -40,6 +40,19 @@ class VolumeRendererParameters
 public:
     LIVRE_API VolumeRendererParameters();
 
+    /**
+     * @return the upper limit of upload threads: the cores left by the render
+     * and compute threads if the upload threads are tuned, the configured
+     * number of upload threads otherwise.
+     */
+    LIVRE_API size_t getMaxUploadThreads() const;
+
+    /**
+     * @return the number of cores which are not used by the threads of the
+     * rendering pipeline.
+     */
+    LIVRE_API size_t getFreeCores() const;
+
 protected:
     LIVRE_API void initialize_() final;
 };
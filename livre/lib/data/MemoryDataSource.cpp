@@ -115,6 +115,10 @@ MemoryDataSource::MemoryDataSource( const DataSourcePluginData& initData )
             LBTHROW( std::runtime_error( except.what() ));
     }
 
+    // computeData() generates values in [16 - 127, 255 + 16 + 127]
+    if( _volumeInfo.dataType == DT_FLOAT )
+        _volumeInfo.dataRange = Vector2f( -111.0f, 398.0f );
+
     _volumeInfo.frameRange = FULL_FRAME_RANGE;
 
     if(!fillRegularVolumeInfo( _volumeInfo  ))
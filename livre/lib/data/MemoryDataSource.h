@@ -57,6 +57,9 @@ public:
      */
     MemoryUnitPtr getData( const LODNode& node ) final;
 
+    /** @copydoc DataSourcePlugin::hasRegularTree */
+    bool hasRegularTree() const final { return true; }
+
     static bool handles( const DataSourcePluginData& initData );
 
 private:
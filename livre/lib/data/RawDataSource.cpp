@@ -120,6 +120,26 @@ struct RawDataSource::Impl
         return memUnitPtr;
     }
 
+    Vector2f computeDataRange() const
+    {
+        // Integer volumes use the range of their type for quantization
+        if( _volInfo.dataType != DT_FLOAT )
+            return _volInfo.dataRange;
+
+        const float* data = reinterpret_cast< const float* >(
+                                (const uint8_t*)_mmapPtr + _headerSize );
+        const size_t count = _volInfo.voxels.product();
+
+        float minValue = std::numeric_limits< float >::max();
+        float maxValue = -std::numeric_limits< float >::max();
+        for( size_t i = 0; i < count; ++i )
+        {
+            minValue = std::min( minValue, data[ i ] );
+            maxValue = std::max( maxValue, data[ i ] );
+        }
+        return Vector2f( minValue, maxValue );
+    }
+
     void setDataType( const std::string& dataType )
     {
         if( dataType == "char" || dataType == "int8" )
@@ -226,6 +246,11 @@ MemoryUnitPtr RawDataSource::getData( const LODNode& node )
     return _impl->getData( node );
 }
 
+Vector2f RawDataSource::computeDataRange()
+{
+    return _impl->computeDataRange();
+}
+
 bool RawDataSource::handles( const DataSourcePluginData& initData )
 {
     return initData.getURI().getScheme() == "raw";
@@ -50,6 +50,15 @@ public:
      */
     MemoryUnitPtr getData( const LODNode& node ) final;
 
+    /** @copydoc DataSourcePlugin::hasRegularTree */
+    bool hasRegularTree() const final { return true; }
+
+    /**
+     * Scans the whole memory mapped volume for the range of float volumes.
+     * @copydoc DataSourcePlugin::computeDataRange
+     */
+    Vector2f computeDataRange() final;
+
     static bool handles( const DataSourcePluginData& initData );
 private:
 
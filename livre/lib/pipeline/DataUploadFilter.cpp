@@ -22,64 +22,143 @@
 #include <livre/lib/pipeline/DataUploadFilter.h>
 #include <livre/lib/configuration/VolumeRendererParameters.h>
 
+#include <livre/core/pipeline/CancellationToken.h>
 #include <livre/core/pipeline/Pipeline.h>
+#include <livre/core/data/DataSource.h>
+#include <livre/core/data/LODNode.h>
 #include <livre/core/data/NodeId.h>
 #include <livre/core/cache/Cache.h>
+#include <livre/core/render/CommandFence.h>
+#include <livre/core/render/Frustum.h>
 
-#include <eq/gl.h>
+#include <atomic>
+#include <deque>
+#include <limits>
 
 namespace livre
 {
 
+namespace
+{
+/**
+ * @return the importance of a node on screen: its projected size, weighted
+ * towards the view direction
+ */
+float getImportance( const Boxf& worldBox, const Frustum& frustum )
+{
+    const Vector3f toCenter = worldBox.getCenter() - frustum.getEyePos();
+    const float distance = std::max( toCenter.length(),
+                                     std::numeric_limits< float >::epsilon( ));
+    const float alignment = toCenter.dot( frustum.getViewDir( )) / distance;
+    return worldBox.getSize().length() / distance * ( 1.f + alignment );
+}
+}
+
 struct DataUploadFilter::Impl
 {
 public:
 
-    Impl( const size_t id,
-          const size_t nUploaders,
-          Cache& dataCache,
+    Impl( Cache& dataCache,
           Cache& textureCache,
           DataSource& dataSource,
           TexturePool& texturePool )
-        : _id( id )
-        , _nUploaders( nUploaders )
-        , _dataCache( dataCache )
+        : _dataCache( dataCache )
         , _textureCache( textureCache )
         , _dataSource( dataSource )
         , _texturePool( texturePool )
+        , _uploadedBytes( 0 )
     {}
 
-    ConstCacheObjects load( const NodeIds& visibles ) const
+    typedef std::pair< ConstTextureObjectPtr,
+                       std::unique_ptr< CommandFence >> PendingTexture;
+    typedef std::deque< PendingTexture > PendingTextures;
+
+    ConstCacheObjects load( const NodeIds& visibles,
+                            const CancellationToken& cancellation = CancellationToken( )) const
     {
         ConstCacheObjects cacheObjects;
         cacheObjects.reserve( visibles.size( ));
-        bool isTextureUploaded = false;
+
+        // The uploads are not waited for one by one: a texture is inserted in
+        // the cache, where the rendering can use it, once its fence signaled
+        PendingTextures pending;
         for( const NodeId& nodeId: visibles )
         {
+            if( cancellation.isCancelled( ))
+                break;
+
             ConstTextureObjectPtr texture = _textureCache.get< TextureObject >( nodeId.getId( ));
-            if( !texture )
+            if( texture )
+                cacheObjects.push_back( texture );
+            else
             {
-                if( !_dataCache.load< DataObject>( nodeId.getId( ), _dataSource ))
-                    continue;
+                texture = upload( nodeId );
+                if( texture )
+                    pending.emplace_back( texture, std::unique_ptr< CommandFence >(
+                                                       new CommandFence ));
+            }
+            publish( pending, cacheObjects, false );
+        }
 
-                texture = _textureCache.load< TextureObject >( nodeId.getId(),
-                                                              _dataCache,
-                                                              _dataSource,
-                                                              _texturePool );
-                if( !texture )
-                    continue;
+        publish( pending, cacheObjects, true );
+        return cacheObjects;
+    }
 
-                cacheObjects.push_back( texture );
-                isTextureUploaded = true;
-            }
-            else
-                cacheObjects.push_back( texture );
+    ConstTextureObjectPtr upload( const NodeId& nodeId ) const
+    {
+        if( !_dataCache.load< DataObject>( nodeId.getId( ), _dataSource ))
+            return ConstTextureObjectPtr();
+
+        try
+        {
+            return ConstTextureObjectPtr( new TextureObject( nodeId.getId(),
+                                                             _dataCache,
+                                                             _dataSource,
+                                                             _texturePool ));
         }
+        catch( const CacheLoadException& )
+        {}
+        return ConstTextureObjectPtr();
+    }
 
-        if( isTextureUploaded )
-            glFinish();
+    /** Inserts the textures in upload order, once their fences signaled */
+    void publish( PendingTextures& pending, ConstCacheObjects& cacheObjects,
+                  const bool wait ) const
+    {
+        while( !pending.empty( ))
+        {
+            CommandFence& fence = *pending.front().second;
+            if( wait )
+                fence.wait();
+            else if( !fence.isSignaled( ))
+                return;
 
-        return cacheObjects;
+            const ConstTextureObjectPtr& texture = pending.front().first;
+            _uploadedBytes += texture->getSize();
+            cacheObjects.push_back( _textureCache.insert( texture ));
+            pending.pop_front();
+        }
+    }
+
+    /** Sorts the nodes by decreasing screen-space importance */
+    void sortByImportance( NodeIds& nodeIds, const Frustum& frustum ) const
+    {
+        typedef std::pair< float, NodeId > ImportanceNodeId;
+        std::vector< ImportanceNodeId > importances;
+        importances.reserve( nodeIds.size( ));
+        for( const NodeId& nodeId: nodeIds )
+        {
+            const LODNode& node = _dataSource.getNode( nodeId );
+            importances.emplace_back( getImportance( node.getWorldBox(), frustum ),
+                                      nodeId );
+        }
+
+        std::sort( importances.begin(), importances.end(),
+                   []( const ImportanceNodeId& a, const ImportanceNodeId& b )
+                       { return a.first > b.first; } );
+
+        for( size_t i = 0; i < importances.size(); ++i )
+            nodeIds[ i ] = importances[ i ].second;
     }
 
     ConstCacheObjects get( const NodeIds& visibles ) const
@@ -105,28 +184,17 @@ public:
                 uniqueInputs.get< NodeIds >( "VisibleNodes" );
 
         const bool isAsync = !vrParams.getSynchronousMode();
-        const size_t perThreadSize = std::max( (size_t)1, visibles.size() / _nUploaders );
-
-        NodeIds partialVisibles;
-
-        if( _id * perThreadSize < visibles.size( ))
-        {
-            const NodeId* begin = visibles.data() + perThreadSize * _id;
-            if( _id == _nUploaders - 1 ) // last item
-                partialVisibles = NodeIds( begin,
-                                           begin + (visibles.size() - ( perThreadSize * _id )));
-            else
-                partialVisibles = NodeIds( begin,
-                                           begin + perThreadSize );
-        }
-
         if( isAsync )
         {
-            output.set( "CacheObjects", get( partialVisibles)); // Already loaded ones
-            load( partialVisibles ); // load
+            // The chunks are in the order of importance, loaded until the
+            // frame is superseded after its deadline. The already loaded ones
+            // are published by the preview of the map, see getResident()
+            output.set( "CacheObjects",
+                        load( visibles,
+                              uniqueInputs.get< CancellationToken >( "Cancellation" )));
         }
         else
-            output.set( "CacheObjects", load( partialVisibles )); // load all
+            output.set( "CacheObjects", load( visibles )); // load all
     }
 
     DataInfos getInputDataInfos() const
@@ -135,6 +203,8 @@ public:
         {
             { "Params", getType< VolumeRendererParameters >( )},
             { "VisibleNodes", getType< NodeIds >() },
+            { "Frustum", getType< Frustum >() },
+            { "Cancellation", getType< CancellationToken >() },
         };
     }
 
@@ -146,23 +216,18 @@ public:
         };
     }
 
-    const size_t _id;
-    const size_t _nUploaders;
     Cache& _dataCache;
     Cache& _textureCache;
     DataSource& _dataSource;
     TexturePool& _texturePool;
+    mutable std::atomic< size_t > _uploadedBytes;
 };
 
-DataUploadFilter::DataUploadFilter( const size_t id,
-                                    const size_t nUploaders,
-                                    Cache& dataCache,
+DataUploadFilter::DataUploadFilter( Cache& dataCache,
                                     Cache& textureCache,
                                     DataSource& dataSource,
                                     TexturePool& texturePool )
-    : _impl( new DataUploadFilter::Impl( id,
-                                         nUploaders,
-                                         dataCache,
+    : _impl( new DataUploadFilter::Impl( dataCache,
                                          textureCache,
                                          dataSource,
                                          texturePool ))
@@ -180,6 +245,22 @@ void DataUploadFilter::execute( const FutureMap& input,
     _impl->execute( input, output );
 }
 
+size_t DataUploadFilter::takeUploadedBytes() const
+{
+    return _impl->_uploadedBytes.exchange( 0 );
+}
+
+void DataUploadFilter::sortByImportance( NodeIds& nodeIds,
+                                         const Frustum& frustum ) const
+{
+    _impl->sortByImportance( nodeIds, frustum );
+}
+
+ConstCacheObjects DataUploadFilter::getResident( const NodeIds& nodeIds ) const
+{
+    return _impl->get( nodeIds );
+}
+
 DataInfos DataUploadFilter::getInputDataInfos() const
 {
     return _impl->getInputDataInfos();
@@ -28,9 +28,14 @@ namespace livre
 
 
 /**
- * DataUploadFilter class implements the parallel data loading for raw volume data and
- * textures. A group of uploaders is executed in rendering pipeline and each uploader
- * has an id in the group.
+ * DataUploadFilter class implements the data loading for raw volume data and
+ * textures of the "VisibleNodes". The rendering pipeline executes it in a
+ * ParallelMap over the visible nodes.
+ *
+ * In asynchronous mode the nodes are loaded in the order they are given, see
+ * sortByImportance(), and loading stops once the "Cancellation" token is
+ * cancelled and its deadline has passed. The textures which were available
+ * before the uploads started are given by getResident().
  */
 class DataUploadFilter : public Filter
 {
@@ -38,16 +43,12 @@ public:
 
     /**
      * Constructor
-     * @param id of the data uploader ( in a group of other uploaders )
-     * @param nbUploaders total number of uploders
      * @param dataCache data cache
      * @param textureCache texture cache
      * @param dataSource data source
      * @param texturePool the pool for 3D textures
      */
-    DataUploadFilter( const size_t id,
-                      const size_t nbUploaders,
-                      Cache& dataCache,
+    DataUploadFilter( Cache& dataCache,
                       Cache& textureCache,
                       DataSource& dataSource,
                       TexturePool& texturePool );
@@ -68,6 +69,29 @@ public:
      */
     DataInfos getOutputDataInfos() const final;
 
+    /**
+     * @return the number of bytes uploaded to textures since the last call.
+     * Thread safe.
+     */
+    size_t takeUploadedBytes() const;
+
+    /**
+     * Sorts the nodes by decreasing screen-space importance for the frustum.
+     * The parallel map of the uploads orders the whole visible set with it
+     * before splitting it into chunks.
+     * @param nodeIds the nodes to sort
+     * @param frustum the frustum of the frame
+     */
+    void sortByImportance( NodeIds& nodeIds, const Frustum& frustum ) const;
+
+    /**
+     * @return the textures of the nodes which are in the texture cache
+     * already, i.e. the resident set which can be rendered before the uploads
+     * of the nodes have finished. Thread safe.
+     * @param nodeIds the nodes to look up
+     */
+    ConstCacheObjects getResident( const NodeIds& nodeIds ) const;
+
 private:
 
     struct Impl;
@@ -23,13 +23,30 @@
 #include <livre/core/cache/Cache.h>
 #include <livre/core/data/DataSource.h>
 #include <livre/core/data/Histogram.h>
+#include <livre/core/data/LODNode.h>
+#include <livre/core/data/NodeId.h>
 #include <livre/core/render/Frustum.h>
 
+#include <algorithm>
+#include <unordered_set>
+
 namespace livre
 {
 namespace
 {
 const float infinite = std::numeric_limits< float >::max();
+typedef std::unordered_map< Identifier, ConstHistogramObjectPtr > HistogramMap;
+typedef std::vector< ConstHistogramObjectPtr > ConstHistogramObjects;
+
+bool isEqual( const Histogram& lhs, const Histogram& rhs )
+{
+    const auto& lhsBins = lhs.getBins();
+    const auto& rhsBins = rhs.getBins();
+    return lhs.getRange() == rhs.getRange() &&
+           lhsBins.size() == rhsBins.size() &&
+           std::equal( lhsBins.data(), lhsBins.data() + lhsBins.size(),
+                       rhsBins.data( ));
+}
 }
 
 struct HistogramFilter::Impl
@@ -75,6 +92,153 @@ struct HistogramFilter::Impl
         return ndcCube.isIn( mvpCenterHom );
     }
 
+    bool isCompatible( const Histogram& histogram, const Vector2f& range,
+                       const size_t binCount ) const
+    {
+        return histogram.getBins().size() == binCount &&
+               histogram.getRange() == range;
+    }
+
+    /**
+     * @return the histogram remapped to the given range and bin count. The
+     * cached histogram is replaced, so a growing data range does not require
+     * to bin the voxels again.
+     */
+    ConstHistogramObjectPtr rebin( const CacheId& cacheId,
+                                   const ConstHistogramObjectPtr& histogram,
+                                   const Vector2f& range,
+                                   const size_t binCount ) const
+    {
+        if( isCompatible( histogram->getHistogram(), range, binCount ))
+            return histogram;
+
+        const Histogram& rebinned = histogram->getHistogram().rebin( range, binCount );
+        _histogramCache.purge( cacheId );
+        return _histogramCache.load< HistogramObject >( cacheId, rebinned,
+                                                        histogram->isDerived( ));
+    }
+
+    /** @return true if the node has no children in the data source */
+    bool isLeaf( const NodeId& nodeId ) const
+    {
+        return nodeId.getLevel() + 1 >=
+               _dataSource.getVolumeInfo().rootNode.getDepth();
+    }
+
+    /**
+     * @return the cached sum of the children of a node. A histogram binned
+     * from the voxels of the node is replaced, so the histogram of a parent
+     * does not depend on which of its sources happened to be cached first.
+     */
+    ConstHistogramObjectPtr storeSum( const Identifier parentId,
+                                      const Histogram& sum ) const
+    {
+        const ConstHistogramObjectPtr cached =
+                _histogramCache.get< HistogramObject >( parentId );
+        if( cached && cached->isDerived() && isEqual( cached->getHistogram(), sum ))
+            return cached;
+
+        _histogramCache.purge( parentId );
+        return _histogramCache.load< HistogramObject >( parentId, sum, true );
+    }
+
+    /**
+     * @return the histogram of the node from the cached histograms of all its
+     * children, or an empty pointer if one of them is missing.
+     */
+    ConstHistogramObjectPtr deriveFromChildren( const NodeId& nodeId,
+                                                const Vector2f& range ) const
+    {
+        ConstHistogramObjects children;
+        size_t binCount = 0;
+        for( const NodeId& childId: nodeId.getChildRange( ))
+        {
+            if( !_dataSource.getNode( childId ).isValid( ))
+                continue;
+
+            ConstHistogramObjectPtr child =
+                    _histogramCache.get< HistogramObject >( childId.getId( ));
+            if( !child )
+                return ConstHistogramObjectPtr();
+
+            binCount = std::max( binCount, child->getHistogram().getBins().size( ));
+            children.push_back( child );
+        }
+
+        Histogram histogram;
+        for( const auto& child: children )
+        {
+            const ConstHistogramObjectPtr& rebinned =
+                    rebin( child->getId(), child, range, binCount );
+            if( !rebinned )
+                return ConstHistogramObjectPtr();
+            histogram += rebinned->getHistogram();
+        }
+
+        if( histogram.getBins().empty( ))
+            return ConstHistogramObjectPtr();
+        return storeSum( nodeId.getId(), histogram );
+    }
+
+    /**
+     * Replaces all complete sets of children with their parent, level by level,
+     * so the visible histogram is assembled from the coarsest fully visible
+     * nodes. Parent histograms are always the sum of their children, never
+     * binned from their own voxels, and stay cached.
+     */
+    void collapse( HistogramMap& histograms, const Vector2f& range,
+                   const size_t binCount ) const
+    {
+        bool collapsed = true;
+        while( collapsed )
+        {
+            collapsed = false;
+
+            std::unordered_set< Identifier > parentIds;
+            for( const auto& entry: histograms )
+            {
+                const NodeId nodeId( entry.first );
+                if( nodeId.getLevel() > 0 )
+                    parentIds.insert( nodeId.getParent().getId( ));
+            }
+
+            for( const Identifier parentId: parentIds )
+            {
+                const NodeId parent( parentId );
+                ConstHistogramObjects children;
+                for( const NodeId& childId: parent.getChildRange( ))
+                {
+                    if( !_dataSource.getNode( childId ).isValid( ))
+                        continue;
+
+                    const auto it = histograms.find( childId.getId( ));
+                    if( it == histograms.end( ))
+                    {
+                        children.clear();
+                        break;
+                    }
+                    children.push_back( it->second );
+                }
+
+                if( children.empty( ))
+                    continue;
+
+                Histogram sum;
+                for( const auto& child: children )
+                    sum += child->getHistogram();
+
+                const ConstHistogramObjectPtr& histogram = storeSum( parentId, sum );
+                if( !histogram )
+                    continue;
+
+                for( const NodeId& childId: parent.getChildRange( ))
+                    histograms.erase( childId.getId( ));
+                histograms[ parentId ] = histogram;
+                collapsed = true;
+            }
+        }
+    }
+
     void execute( const FutureMap& input, PromiseMap& output ) const
     {
         const auto& frustums = input.get< Frustum >( "Frustum" );
@@ -84,14 +248,31 @@ struct HistogramFilter::Impl
         const auto& frustum = frustums.front();
         const auto& viewport = viewports.front();
 
-        Histogram histogramAccumulated;
+        HistogramMap histograms;
+        size_t binCount = 0;
         for( const auto& cacheObjects: input.getFutures( "CacheObjects" ))
             for( const auto& cacheObject: cacheObjects.get< ConstCacheObjects >( ))
             {
                 const CacheId& cacheId = cacheObject->getId();
+                const NodeId nodeId( cacheId );
 
-                // Hist cache object expands the data source range if data has larger values
+                // Coarse nodes are derived from their children whenever they
+                // are cached, the others are binned once and stay in the
+                // cache. Leaves have no children to look up. The hist cache
+                // object expands the data source range if data has larger
+                // values
                 ConstHistogramObjectPtr histCacheObject =
+                        _histogramCache.get< HistogramObject >( cacheId );
+                if( !isLeaf( nodeId ) &&
+                    ( !histCacheObject || !histCacheObject->isDerived( )))
+                {
+                    const ConstHistogramObjectPtr& derived =
+                            deriveFromChildren( nodeId, dataSourceRange );
+                    if( derived )
+                        histCacheObject = derived;
+                }
+                if( !histCacheObject )
+                    histCacheObject =
                         _histogramCache.load< HistogramObject >( cacheId,
                                                                  _dataCache,
                                                                  _dataSource,
@@ -102,15 +283,12 @@ struct HistogramFilter::Impl
                 const Vector2f& currentRange = histCacheObject->getHistogram().getRange();
                 if( currentRange[ 0 ] < dataSourceRange[ 0 ] )
                     dataSourceRange[ 0 ] = currentRange[ 0 ];
-                histogramAccumulated.setMin(  dataSourceRange[ 0 ] );
 
                 if( currentRange[ 1 ] > dataSourceRange[ 1 ] )
                     dataSourceRange[ 1 ] = currentRange[ 1 ];
-                histogramAccumulated.setMax( dataSourceRange[ 1 ] );
 
-                const size_t currentBinCount = histCacheObject->getHistogram().getBins().size();
-                if( histogramAccumulated.getBins().empty( ))
-                    histogramAccumulated.resize( currentBinCount );
+                binCount = std::max( binCount,
+                                     histCacheObject->getHistogram().getBins().size( ));
 
                 // When a frame is rendered in multi-channel, multi-node, etc
                 // config, some nodes are rendered twice in sort-first renderings
@@ -118,21 +296,37 @@ struct HistogramFilter::Impl
                 // this frustum (because it can only be in one tile at a time). For viewports
                 // on the border of the absolute viewport, the frustum is virtually extended
                 // to infinity on the boundary.
-                try
-                {
-                    const LODNode& lodNode = _dataSource.getNode( NodeId( cacheId ));
-                    if( isCenterInViewport( frustum, lodNode.getWorldBox(), viewport))
-                        histogramAccumulated += histCacheObject->getHistogram();
-                }
-                catch( const std::runtime_error& )
-                {
-                    // Only compatible histograms can be added.( i.e same data range and number of
-                    // bins.) Until data range converges to the full data range combined from other
-                    // rendering clients, the cache objects are purged from the cache.
-                    _histogramCache.purge( cacheId );
-                }
+                const LODNode& lodNode = _dataSource.getNode( nodeId );
+                if( isCenterInViewport( frustum, lodNode.getWorldBox(), viewport ))
+                    histograms[ cacheId ] = histCacheObject;
             }
 
+        // Only compatible histograms can be added.( i.e same data range and number of
+        // bins.) Until data range converges to the full data range combined from other
+        // rendering clients, the cached histograms are rebinned to the current range.
+        for( auto it = histograms.begin(); it != histograms.end(); )
+        {
+            it->second = rebin( it->first, it->second, dataSourceRange, binCount );
+            if( it->second )
+                ++it;
+            else
+                it = histograms.erase( it );
+        }
+
+        collapse( histograms, dataSourceRange, binCount );
+
+        Histogram histogramAccumulated;
+        for( const auto& entry: histograms )
+            histogramAccumulated += entry.second->getHistogram();
+
+        // Report the expanded range even if no histogram could be added yet
+        if( histogramAccumulated.getBins().empty() && binCount > 0 )
+        {
+            histogramAccumulated.resize( binCount );
+            histogramAccumulated.setMin( dataSourceRange[ 0 ] );
+            histogramAccumulated.setMax( dataSourceRange[ 1 ] );
+        }
+
         output.set( "Histogram", histogramAccumulated );
     }
 
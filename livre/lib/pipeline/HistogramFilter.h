@@ -20,6 +20,7 @@
 #ifndef _HistogramFilter_h_
 #define _HistogramFilter_h_
 
+#include <livre/lib/api.h>
 #include <livre/lib/types.h>
 
 #include <livre/core/pipeline/Filter.h>
@@ -31,6 +32,9 @@ namespace livre
  * Histogram filter computes the accumulated histogram for given node ids that
  * are in or intersecting the frustum.
  *
+ * The histograms form a pyramid in the histogram cache: bricks are binned once,
+ * parent histograms are the sum of their children's, and the accumulated
+ * histogram is assembled from the coarsest fully visible nodes.
  */
 class HistogramFilter : public Filter
 {
@@ -43,25 +47,25 @@ public:
      * @param dataCache data cache
      * @param dataSource data source
      */
-    HistogramFilter( Cache& histogramCache,
-                     const Cache& dataCache,
-                     const DataSource& dataSource );
-    ~HistogramFilter();
+    LIVRE_API HistogramFilter( Cache& histogramCache,
+                               const Cache& dataCache,
+                               const DataSource& dataSource );
+    LIVRE_API ~HistogramFilter();
 
     /**
      * @copydoc Filter::execute
      */
-    void execute( const FutureMap& input, PromiseMap& output ) const final;
+    LIVRE_API void execute( const FutureMap& input, PromiseMap& output ) const final;
 
     /**
      * @copydoc Filter::getInputDataInfos
      */
-    DataInfos getInputDataInfos() const final;
+    LIVRE_API DataInfos getInputDataInfos() const final;
 
     /**
      * @copydoc Filter::getOutputDataInfos
      */
-    DataInfos getOutputDataInfos() const final;
+    LIVRE_API DataInfos getOutputDataInfos() const final;
 
 private:
 
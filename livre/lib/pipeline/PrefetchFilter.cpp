@@ -0,0 +1,173 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/lib/cache/DataObject.h>
+#include <livre/lib/cache/TextureObject.h>
+#include <livre/lib/pipeline/PrefetchFilter.h>
+#include <livre/lib/configuration/VolumeRendererParameters.h>
+
+#include <livre/core/pipeline/CancellationToken.h>
+#include <livre/core/pipeline/FutureMap.h>
+#include <livre/core/cache/Cache.h>
+#include <livre/core/cache/PrefetchStatistics.h>
+#include <livre/core/data/DataSource.h>
+#include <livre/core/data/NodeId.h>
+
+#include <unordered_set>
+
+namespace livre
+{
+
+struct PrefetchFilter::Impl
+{
+public:
+
+    Impl( Cache& dataCache,
+          Cache& textureCache,
+          DataSource& dataSource,
+          TexturePool& texturePool,
+          PrefetchStatisticsPtr statistics )
+        : _dataCache( dataCache )
+        , _textureCache( textureCache )
+        , _dataSource( dataSource )
+        , _texturePool( texturePool )
+        , _statistics( statistics )
+    {}
+
+    /** @return the predicted nodes which are neither loaded nor rendered now */
+    NodeIds getMissing( const NodeIds& predicted, const NodeIds& current,
+                        const bool prefetchTextures ) const
+    {
+        std::unordered_set< Identifier > currentIds;
+        currentIds.reserve( current.size( ));
+        for( const NodeId& nodeId: current )
+            currentIds.insert( nodeId.getId( ));
+
+        NodeIds missing;
+        for( const NodeId& nodeId: predicted )
+        {
+            if( currentIds.count( nodeId.getId( )))
+                continue;
+
+            const Cache& cache = prefetchTextures ? _textureCache : _dataCache;
+            if( !cache.get( nodeId.getId( )))
+                missing.push_back( nodeId );
+        }
+
+        std::stable_sort( missing.begin(), missing.end(),
+                          []( const NodeId& a, const NodeId& b )
+                              { return a.getLevel() < b.getLevel(); } );
+        return missing;
+    }
+
+    void prefetch( const NodeIds& nodeIds, const bool prefetchTextures,
+                   const CancellationToken& cancellation ) const
+    {
+        for( const NodeId& nodeId: nodeIds )
+        {
+            if( cancellation.isCancelled( ))
+                break;
+
+            size_t bytes = 0;
+            ConstDataObjectPtr data = _dataCache.get< DataObject >( nodeId.getId( ));
+            if( !data )
+            {
+                data = _dataCache.load< DataObject >( nodeId.getId(), _dataSource );
+                if( !data )
+                    continue;
+                bytes += data->getSize();
+            }
+
+            if( prefetchTextures )
+            {
+                const ConstTextureObjectPtr texture =
+                        _textureCache.load< TextureObject >( nodeId.getId(),
+                                                             _dataCache,
+                                                             _dataSource,
+                                                             _texturePool );
+                if( texture )
+                    bytes += texture->getSize();
+            }
+
+            if( bytes > 0 )
+                _statistics->notifyPrefetched( nodeId, bytes );
+        }
+    }
+
+    void execute( const FutureMap& input ) const
+    {
+        const UniqueFutureMap uniqueInputs( input.getFutures( ));
+        const auto& params =
+                uniqueInputs.get< VolumeRendererParameters >( "Params" );
+        const bool prefetchTextures = params.getPrefetchTextures();
+
+        const NodeIds missing =
+                getMissing( uniqueInputs.get< NodeIds >( "VisibleNodes" ),
+                            uniqueInputs.get< NodeIds >( "CurrentNodes" ),
+                            prefetchTextures );
+        prefetch( missing, prefetchTextures,
+                  uniqueInputs.get< CancellationToken >( "Cancellation" ));
+    }
+
+    DataInfos getInputDataInfos() const
+    {
+        return
+        {
+            { "Params", getType< VolumeRendererParameters >( )},
+            { "VisibleNodes", getType< NodeIds >() },
+            { "CurrentNodes", getType< NodeIds >() },
+            { "Cancellation", getType< CancellationToken >() },
+        };
+    }
+
+    Cache& _dataCache;
+    Cache& _textureCache;
+    DataSource& _dataSource;
+    TexturePool& _texturePool;
+    const PrefetchStatisticsPtr _statistics;
+};
+
+PrefetchFilter::PrefetchFilter( Cache& dataCache,
+                                Cache& textureCache,
+                                DataSource& dataSource,
+                                TexturePool& texturePool,
+                                PrefetchStatisticsPtr statistics )
+    : _impl( new PrefetchFilter::Impl( dataCache,
+                                       textureCache,
+                                       dataSource,
+                                       texturePool,
+                                       statistics ))
+{
+}
+
+PrefetchFilter::~PrefetchFilter()
+{
+}
+
+void PrefetchFilter::execute( const FutureMap& input, PromiseMap& ) const
+{
+    _impl->execute( input );
+}
+
+DataInfos PrefetchFilter::getInputDataInfos() const
+{
+    return _impl->getInputDataInfos();
+}
+
+}
@@ -0,0 +1,75 @@
+/* Copyright (c) 2011-2014, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _PrefetchFilter_h_
+#define _PrefetchFilter_h_
+
+#include <livre/lib/types.h>
+#include <livre/core/pipeline/Filter.h>
+
+namespace livre
+{
+
+/**
+ * PrefetchFilter class loads the "VisibleNodes" of a predicted frustum into
+ * the data cache, and into the texture cache if the "Params" ask for
+ * prefetched textures. The "CurrentNodes" of the rendered frame are left to
+ * the DataUploadFilter. The coarser nodes are loaded first, as they are drawn
+ * while the finer ones are loading, and loading stops once the
+ * "Cancellation" token is cancelled.
+ *
+ * The loaded nodes are notified to the prefetch statistics.
+ */
+class PrefetchFilter : public Filter
+{
+public:
+
+    /**
+     * Constructor
+     * @param dataCache data cache
+     * @param textureCache texture cache
+     * @param dataSource data source
+     * @param texturePool the pool for 3D textures
+     * @param statistics the statistics of the prefetched nodes
+     */
+    PrefetchFilter( Cache& dataCache,
+                    Cache& textureCache,
+                    DataSource& dataSource,
+                    TexturePool& texturePool,
+                    PrefetchStatisticsPtr statistics );
+    ~PrefetchFilter();
+
+    /**
+     * @copydoc Filter::execute
+     */
+    void execute( const FutureMap& input, PromiseMap& output ) const final;
+
+    /**
+     * @copydoc Filter::getInputDataInfos
+     */
+    DataInfos getInputDataInfos() const final;
+
+private:
+
+    struct Impl;
+    std::unique_ptr<Impl> _impl;
+};
+}
+
+#endif
@@ -20,10 +20,13 @@
 #include <livre/lib/pipeline/RenderFilter.h>
 #include <livre/lib/cache/TextureObject.h>
 
+#include <livre/core/render/BrickCost.h>
 #include <livre/core/render/Renderer.h>
+#include <livre/core/render/RenderTimer.h>
 #include <livre/core/render/Frustum.h>
 #include <livre/core/render/ClipPlanes.h>
 #include <livre/core/data/DataSource.h>
+#include <livre/core/data/LODNode.h>
 
 namespace livre
 {
@@ -31,13 +34,27 @@ namespace livre
 struct RenderFilter::Impl
 {
     Impl( const DataSource& dataSource,
-          Renderer& renderer )
+          Renderer& renderer,
+          const RenderTimerPtr& timer )
         : _dataSource( dataSource )
         , _renderer( renderer )
+        , _timer( timer )
     {}
 
+    /** @return the sum of the viewport fractions the bricks project to */
+    float getRenderedArea( const NodeIds& renderBricks,
+                           const Frustum& frustum ) const
+    {
+        const Matrix4f& mvpMatrix = frustum.getMVPMatrix();
+        float area = 0.f;
+        for( const NodeId& nodeId: renderBricks )
+            area += getScreenArea( _dataSource.getNode( nodeId ).getWorldBox(),
+                                   mvpMatrix );
+        return area;
+    }
+
     void execute( const FutureMap& input,
-                  PromiseMap&) const
+                  PromiseMap& output ) const
     {
         NodeIds renderBricks;
         for( const auto& cacheObjects: input.getFutures( "CacheObjects" ))
@@ -54,8 +71,26 @@ struct RenderFilter::Impl
         const auto& clipPlanes = input.get< ClipPlanes >( "ClipPlanes" );
         const auto& viewports = input.get< PixelViewport >( "Viewport" );
         const auto& renderStages = input.get< uint32_t >( "RenderStages" );
+        const auto& ranges = input.get< Range >( "DataRange" );
+
+        // The rendering costs of sort-last channels are measured on the GPU,
+        // and reported once the measurement is available
+        const Range& range = ranges[ 0 ];
+        const bool isSortLast = range[ 0 ] > 0.f || range[ 1 ] < 1.f;
+        FrameCost frameCost;
+        bool isMeasured = false;
+        if( isSortLast && _timer )
+        {
+            frameCost = _timer->takeMeasuredCost();
+            isMeasured = _timer->begin();
+        }
+
         _renderer.render( frustums[ 0 ], clipPlanes[ 0 ], viewports[ 0 ],
                           renderBricks, renderStages[ 0 ] );
+
+        if( isMeasured )
+            _timer->end( getRenderedArea( renderBricks, frustums[ 0 ]));
+        output.set( "FrameCost", frameCost );
     }
 
     DataInfos getInputDataInfos() const
@@ -66,18 +101,28 @@ struct RenderFilter::Impl
             { "Frustum", getType< Frustum >() },
             { "Viewport", getType< PixelViewport >() },
             { "ClipPlanes", getType< ClipPlanes >() },
-            { "RenderStages", getType< uint32_t >() }
+            { "RenderStages", getType< uint32_t >() },
+            { "DataRange", getType< Range >() }
+        };
+    }
+
+    DataInfos getOutputDataInfos() const
+    {
+        return
+        {
+            { "FrameCost", getType< FrameCost >() }
         };
     }
 
     const DataSource& _dataSource;
     Renderer& _renderer;
-
+    const RenderTimerPtr _timer;
 };
 
 RenderFilter::RenderFilter( const DataSource& dataSource,
-                            Renderer& renderer )
-    : _impl( new RenderFilter::Impl( dataSource, renderer ))
+                            Renderer& renderer,
+                            const RenderTimerPtr& timer )
+    : _impl( new RenderFilter::Impl( dataSource, renderer, timer ))
 {
 }
 
@@ -96,4 +141,9 @@ DataInfos RenderFilter::getInputDataInfos() const
     return _impl->getInputDataInfos();
 }
 
+DataInfos RenderFilter::getOutputDataInfos() const
+{
+    return _impl->getOutputDataInfos();
+}
+
 }
@@ -29,6 +29,11 @@ namespace livre
 
 /**
  * RenderFilter implements the rendering of loaded textures given the renderer.
+ *
+ * For a sort-last "DataRange", the "FrameCost" output has the GPU time and the
+ * viewport area of the bricks rendered by a previous frame of the renderer, as
+ * soon as the measurement of its timer is available. It is empty otherwise, so
+ * the rendering does not wait for the GPU.
  */
 class RenderFilter : public Filter
 {
@@ -39,9 +44,12 @@ public:
      * Constructor
      * @param dataSource the data source
      * @param renderer the renderer ( RayCaster, etc )
+     * @param timer measures the rendering of sort-last ranges, shared by all
+     * the frames of the renderer. Nothing is measured if it is empty.
      */
     RenderFilter( const DataSource& dataSource,
-                  Renderer& renderer );
+                  Renderer& renderer,
+                  const RenderTimerPtr& timer );
     ~RenderFilter();
 
     /**
@@ -54,6 +62,11 @@ public:
      */
     DataInfos getInputDataInfos() const final;
 
+    /**
+     * @copydoc Filter::getOutputDataInfos
+     */
+    DataInfos getOutputDataInfos() const final;
+
 private:
 
     struct Impl;
@@ -23,25 +23,447 @@
 #include <livre/lib/pipeline/DataUploadFilter.h>
 #include <livre/lib/pipeline/RenderFilter.h>
 #include <livre/lib/pipeline/HistogramFilter.h>
+#include <livre/lib/pipeline/PrefetchFilter.h>
 
 #include <livre/core/cache/Cache.h>
-#include <livre/core/pipeline/SimpleExecutor.h>
+#include <livre/core/cache/PrefetchStatistics.h>
+#include <livre/core/pipeline/CancellationToken.h>
+#include <livre/core/pipeline/DAGExecutor.h>
+#include <livre/core/pipeline/Workers.h>
 #include <livre/core/pipeline/Pipeline.h>
+#include <livre/core/pipeline/ThreadTuner.h>
 #include <livre/core/data/DataSource.h>
+#include <livre/core/data/VolumeInformation.h>
 
+#include <livre/core/render/FrustumPredictor.h>
+#include <livre/core/render/LODCut.h>
 #include <livre/core/render/TexturePool.h>
 #include <livre/core/render/Renderer.h>
+#include <livre/core/render/RenderTimer.h>
+
+#include <lunchbox/clock.h>
 
 #include <boost/progress.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
 namespace livre
 {
 
 namespace
 {
-const size_t nRenderThreads = 2;
-const size_t nUploadThreads = 1;
-const size_t nComputeThreads = 2;
+// Frame graphs kept per renderer. More graphs are only built while the
+// previous frames are still loading data, and are dropped after use.
+const size_t maxFrameGraphs = 4;
+
+// Time in ms from the start of a frame after which its uploads are dropped,
+// once it is superseded by a newer one. Until then they go on, so that every
+// frame makes progress.
+const float uploadDeadline = 16.f;
+
+typedef ParallelMap< NodeId, ConstCacheObjectPtr > UploadMap;
+typedef std::atomic< size_t > Counter;
+typedef std::shared_ptr< Counter > CounterPtr;
+
+/** Measures the time from the start of a stage until its last filter returned */
+class StageTimer
+{
+public:
+    StageTimer() : _end( 0.f ) {}
+
+    void start()
+    {
+        _clock.reset();
+        _end = 0.f;
+    }
+
+    void stop()
+    {
+        const float time = _clock.getTimef();
+        float end = _end;
+        while( end < time && !_end.compare_exchange_weak( end, time ))
+            ;
+    }
+
+    /** @return the duration of the stage in milliseconds */
+    float getTime() const { return _end; }
+
+private:
+    lunchbox::Clock _clock;
+    std::atomic< float > _end;
+};
+typedef std::shared_ptr< StageTimer > StageTimerPtr;
+
+/** Executes a pipe filter and counts down the running filters of its graph */
+class CountedFilter : public Executable
+{
+public:
+    CountedFilter( const PipeFilter& filter, const CounterPtr& running,
+                   const StageTimerPtr& timer = StageTimerPtr( ))
+        : _filter( filter )
+        , _running( running )
+        , _timer( timer )
+    {}
+
+    void execute() final
+    {
+        const CountDown countDown( *_running, _timer.get( ));
+        _filter.execute();
+    }
+
+    void cancel() final
+    {
+        const CountDown countDown( *_running, _timer.get( ));
+        _filter.cancel();
+    }
+
+    Futures getPostconditions() const final { return _filter.getPostconditions(); }
+    Futures getPreconditions() const final { return _filter.getPreconditions(); }
+    void reset() final { _filter.reset(); }
+
+    ExecutablePtr clone() const final
+    {
+        return std::make_shared< CountedFilter >( *this );
+    }
+
+private:
+    struct CountDown
+    {
+        CountDown( Counter& counter_, StageTimer* timer_ )
+            : counter( counter_ ), timer( timer_ ) {}
+
+        ~CountDown()
+        {
+            if( timer )
+                timer->stop();
+            --counter;
+        }
+
+        Counter& counter;
+        StageTimer* const timer;
+    };
+
+    PipeFilter _filter;
+    const CounterPtr _running;
+    const StageTimerPtr _timer;
+};
+
+void setupVisibleGeneratorFilter( PipeFilter& visibleSetGenerator,
+                                  const RenderParams& renderParams )
+{
+    visibleSetGenerator.getPromise( "Frustum" ).set( renderParams.frameInfo.frustum );
+    visibleSetGenerator.getPromise( "Frame" ).set( renderParams.frameInfo.timeStep );
+    visibleSetGenerator.getPromise( "DataRange" ).set( renderParams.renderDataRange );
+    visibleSetGenerator.getPromise( "Params" ).set( renderParams.vrParams );
+    visibleSetGenerator.getPromise( "Viewport" ).set( renderParams.pixelViewPort );
+    visibleSetGenerator.getPromise( "ClipPlanes" ).set( renderParams.clipPlanes );
+    visibleSetGenerator.getPromise( "BrickCost" ).set( renderParams.brickCost );
+}
+
+void setupRenderFilter( PipeFilter& renderFilter,
+                        const RenderParams& renderParams,
+                        const uint32_t renderStages )
+{
+
+    renderFilter.getPromise( "Frustum" ).set( renderParams.frameInfo.frustum );
+    renderFilter.getPromise( "Viewport" ).set( renderParams.pixelViewPort );
+    renderFilter.getPromise( "ClipPlanes" ).set( renderParams.clipPlanes );
+    renderFilter.getPromise( "RenderStages" ).set( renderStages );
+    renderFilter.getPromise( "DataRange" ).set( renderParams.renderDataRange );
+}
+
+/**
+ * @return the order of the uploads: the whole visible set by importance, so
+ * that the chunks claimed first by the upload lanes are the most important ones
+ */
+MapOrder< NodeId > orderByImportance( const std::shared_ptr< DataUploadFilter >& uploader )
+{
+    return [uploader]( NodeIds& nodeIds, const FutureMap& inputs )
+    {
+        const UniqueFutureMap futures( inputs.getFutures( ));
+        uploader->sortByImportance( nodeIds, futures.get< Frustum >( "Frustum" ));
+    };
+}
+
+/**
+ * @return the preview of the uploads: the textures of the visible set which are
+ * resident already, so that a redraw is requested before the lanes have
+ * finished uploading the rest
+ */
+MapPreview< NodeId, ConstCacheObjectPtr >
+residentTextures( const std::shared_ptr< DataUploadFilter >& uploader )
+{
+    return [uploader]( const NodeIds& nodeIds, const FutureMap& )
+    {
+        return uploader->getResident( nodeIds );
+    };
+}
+
+/**
+ * The filters of an asynchronously rendered frame. The graph is built once
+ * and re-armed every frame with reset() and the new inputs, once all of its
+ * filters from the previous frame have returned.
+ */
+class AsyncFrameGraph
+{
+public:
+    AsyncFrameGraph( DataSource& dataSource,
+                     const Caches& caches,
+                     TexturePool& texturePool,
+                     Renderer& renderer,
+                     const RenderTimerPtr& renderTimer,
+                     const PipeFilterFactory& createRedrawFilter,
+                     const PipeFilterFactory& createSendHistogramFilter,
+                     const size_t nUploaders,
+                     const LODCutPtr& lodCut )
+        : _running( std::make_shared< Counter >( 0 ))
+        , _uploadTimer( std::make_shared< StageTimer >( ))
+        , _nVisibles( 0 )
+        , _visibleSetGenerator( PipeFilterT< VisibleSetGeneratorFilter >(
+                                    "VisibleSetGenerator", dataSource, lodCut ))
+        , _renderingSetGenerator( PipeFilterT< RenderingSetGeneratorFilter >(
+                                      "RenderingSetGenerator", caches.textureCache ))
+        , _renderFilter( PipeFilterT< RenderFilter >( "RenderFilter", dataSource,
+                                                      renderer, renderTimer ))
+        , _histogramFilter( PipeFilterT< HistogramFilter >( "HistogramFilter",
+                                                            caches.histogramCache,
+                                                            caches.dataCache,
+                                                            dataSource ))
+        , _redrawFilter( createRedrawFilter( ))
+        , _sendHistogramFilter( createSendHistogramFilter( ))
+        , _uploader( std::make_shared< DataUploadFilter >( caches.dataCache,
+                                                           caches.textureCache,
+                                                           dataSource,
+                                                           texturePool ))
+        , _uploadMap( "DataUploader", _uploader, "VisibleNodes", "CacheObjects",
+                      nUploaders, 1, orderByImportance( _uploader ),
+                      residentTextures( _uploader ))
+    {
+        _histogramFilter.connect( "Histogram", _sendHistogramFilter, "Histogram" );
+        _visibleSetGenerator.connect( "VisibleNodes", _renderingSetGenerator, "VisibleNodes" );
+        _renderingSetGenerator.connect( "CacheObjects", _renderFilter, "CacheObjects" );
+        _renderingSetGenerator.connect( "CacheObjects", _histogramFilter, "CacheObjects" );
+        _renderingSetGenerator.connect( "RenderingDone", _redrawFilter, "RenderingDone" );
+
+        // The rendering thread waits for the render filters, while the
+        // histogram is not needed for the current frame
+        _add( _visibleSetGenerator, _renderFilters, PRIORITY_HIGH );
+        _add( _renderingSetGenerator, _renderFilters, PRIORITY_HIGH );
+        _add( _redrawFilter, _renderFilters, PRIORITY_HIGH );
+        _add( _histogramFilter, _computeFilters, PRIORITY_BACKGROUND );
+        _add( _sendHistogramFilter, _computeFilters, PRIORITY_BACKGROUND );
+
+        PipeFilter& uploadInput = _uploadMap.getInput();
+        _visibleSetGenerator.connect( "VisibleNodes", uploadInput, "VisibleNodes" );
+        _visibleSetGenerator.connect( "Params", uploadInput, "Params" );
+        // The redraw only needs to know whether something is missing, which
+        // the resident set tells before the uploads have finished
+        uploadInput.connect( "CacheObjects", _redrawFilter, "CacheObjects" );
+        for( const PipeFilter& filter: _uploadMap.getFilters( ))
+            _add( filter, _uploadFilters, PRIORITY_NORMAL, _uploadTimer );
+    }
+
+    /** @return true if no filter of the previous frame is running */
+    bool isIdle() const
+    {
+        return *_running == 0;
+    }
+
+    /** @return the number of filters loading the visible nodes */
+    size_t getUploaderCount() const { return _uploadMap.getLanes().size(); }
+
+    /** @return the number of visible nodes of the previous frame */
+    size_t getVisibleCount() const { return _nVisibles; }
+
+    /** @return the time the uploads of the previous frame took in ms */
+    float getUploadTime() const { return _uploadTimer->getTime(); }
+
+    /**
+     * @return the rendering costs of the frame rendered last, and the upload
+     * costs of the frame before
+     */
+    const FrameCost& getFrameCost() const { return _frameCost; }
+
+    /** @return the visible nodes of the frame rendered last */
+    const NodeIds& getVisibleNodes() const
+    {
+        const UniqueFutureMap futures( _visibleSetGenerator.getPostconditions( ));
+        return futures.get< NodeIds >( "VisibleNodes" );
+    }
+
+    /**
+     * Renders a frame.
+     * @param cancellation is cancelled when the next frame is rendered. The
+     * uploads of this frame are then dropped or cut short.
+     */
+    void render( const RenderParams& renderParams,
+                 const CancellationToken& cancellation,
+                 Executor& renderExecutor,
+                 Executor& computeExecutor,
+                 Executor& uploadExecutor,
+                 NodeAvailability& availability )
+    {
+        _renderFilter.reset();
+        for( const ExecutablePtr& filter: _filters )
+            filter->reset();
+
+        PipeFilter& uploadInput = _uploadMap.getInput();
+        uploadInput.getPromise( "Frustum" ).set( renderParams.frameInfo.frustum );
+        uploadInput.getPromise( "Cancellation" ).set( cancellation );
+        for( const ExecutablePtr& filter: _uploadFilters )
+            filter->setCancellationToken( cancellation );
+
+        _histogramFilter.getPromise( "Frustum" ).set( renderParams.frameInfo.frustum );
+        _histogramFilter.getPromise( "RelativeViewport" ).set( renderParams.viewport );
+        _histogramFilter.getPromise( "DataSourceRange" ).set( renderParams.dataSourceRange );
+        _sendHistogramFilter.getPromise( "RelativeViewport" ).set( renderParams.viewport );
+        _sendHistogramFilter.getPromise( "Id" ).set( renderParams.frameInfo.frameId );
+        setupVisibleGeneratorFilter( _visibleSetGenerator, renderParams );
+        setupRenderFilter( _renderFilter, renderParams, RENDER_ALL );
+
+        // The uploads of the previous frame loaded the nodes it missed
+        _frameCost.uploadTime = _uploadTimer->getTime();
+        _frameCost.uploadedBytes = _uploader->takeUploadedBytes();
+
+        *_running = _filters.size();
+        _uploadTimer->start();
+        for( const ExecutablePtr& filter: _renderFilters )
+            renderExecutor.schedule( filter );
+        for( const ExecutablePtr& filter: _uploadFilters )
+            uploadExecutor.schedule( filter );
+        for( const ExecutablePtr& filter: _computeFilters )
+            computeExecutor.schedule( filter );
+        _renderFilter.execute();
+
+        const UniqueFutureMap futures( _renderingSetGenerator.getPostconditions( ));
+        availability = futures.get< NodeAvailability >( "NodeAvailability" );
+        _nVisibles = availability.nAvailable + availability.nNotAvailable;
+
+        const UniqueFutureMap renderOutputs( _renderFilter.getPostconditions( ));
+        const FrameCost& renderCost = renderOutputs.get< FrameCost >( "FrameCost" );
+        _frameCost.renderTime = renderCost.renderTime;
+        _frameCost.renderedArea = renderCost.renderedArea;
+    }
+
+private:
+    void _add( const PipeFilter& filter, std::vector< ExecutablePtr >& filters,
+               const ExecutionPriority priority,
+               const StageTimerPtr& timer = StageTimerPtr( ))
+    {
+        const ExecutablePtr executable =
+                std::make_shared< CountedFilter >( filter, _running, timer );
+        executable->setPriority( priority );
+        filters.push_back( executable );
+        _filters.push_back( executable );
+    }
+
+    const CounterPtr _running;
+    const StageTimerPtr _uploadTimer;
+    size_t _nVisibles;
+    FrameCost _frameCost;
+    PipeFilter _visibleSetGenerator;
+    PipeFilter _renderingSetGenerator;
+    PipeFilter _renderFilter; // executed in the rendering thread
+    PipeFilter _histogramFilter;
+    PipeFilter _redrawFilter;
+    PipeFilter _sendHistogramFilter;
+    const std::shared_ptr< DataUploadFilter > _uploader;
+    UploadMap _uploadMap;
+    std::vector< ExecutablePtr > _filters;
+    std::vector< ExecutablePtr > _renderFilters;
+    std::vector< ExecutablePtr > _computeFilters;
+    std::vector< ExecutablePtr > _uploadFilters;
+};
+typedef std::shared_ptr< AsyncFrameGraph > AsyncFrameGraphPtr;
+typedef std::vector< AsyncFrameGraphPtr > AsyncFrameGraphs;
+
+/**
+ * The filters loading the nodes of a predicted frustum in the background. The
+ * graph is re-armed once all of its filters from the previous prediction have
+ * returned.
+ */
+class PrefetchGraph
+{
+public:
+    PrefetchGraph( DataSource& dataSource,
+                   const Caches& caches,
+                   TexturePool& texturePool,
+                   const PrefetchStatisticsPtr& statistics )
+        : _running( std::make_shared< Counter >( 0 ))
+        , _visibleSetGenerator( PipeFilterT< VisibleSetGeneratorFilter >(
+                                    "PrefetchSetGenerator", dataSource ))
+        , _prefetchFilter( PipeFilterT< PrefetchFilter >( "PrefetchFilter",
+                                                          caches.dataCache,
+                                                          caches.textureCache,
+                                                          dataSource,
+                                                          texturePool,
+                                                          statistics ))
+    {
+        _visibleSetGenerator.connect( "VisibleNodes", _prefetchFilter, "VisibleNodes" );
+        _visibleSetGenerator.connect( "Params", _prefetchFilter, "Params" );
+
+        // Prefetching only uses the threads the frames leave idle
+        for( const PipeFilter& filter: { _visibleSetGenerator, _prefetchFilter })
+        {
+            const ExecutablePtr executable =
+                    std::make_shared< CountedFilter >( filter, _running );
+            executable->setPriority( PRIORITY_BACKGROUND );
+            _filters.push_back( executable );
+        }
+    }
+
+    /** @return true if no filter of the previous prediction is running */
+    bool isIdle() const
+    {
+        return *_running == 0;
+    }
+
+    /**
+     * Loads the nodes visible with the predicted parameters.
+     * @param predictedParams the rendering parameters with the predicted
+     * frustum
+     * @param visibles the nodes visible in the frame rendered last
+     * @param cancellation is cancelled once the prediction is outdated
+     */
+    void prefetch( const RenderParams& predictedParams,
+                   const NodeIds& visibles,
+                   const CancellationToken& cancellation,
+                   Executor& executor )
+    {
+        for( const ExecutablePtr& filter: _filters )
+        {
+            filter->reset();
+            filter->setCancellationToken( cancellation );
+        }
+
+        setupVisibleGeneratorFilter( _visibleSetGenerator, predictedParams );
+        _prefetchFilter.getPromise( "CurrentNodes" ).set( visibles );
+        _prefetchFilter.getPromise( "Cancellation" ).set( cancellation );
+
+        *_running = _filters.size();
+        for( const ExecutablePtr& filter: _filters )
+            executor.schedule( filter );
+    }
+
+private:
+    const CounterPtr _running;
+    PipeFilter _visibleSetGenerator;
+    PipeFilter _prefetchFilter;
+    std::vector< ExecutablePtr > _filters;
+};
+
+/** The camera prediction and prefetching of a renderer */
+struct Prefetcher
+{
+    FrustumPredictor predictor;
+    PrefetchStatisticsPtr statistics;
+    std::shared_ptr< PrefetchGraph > graph;
+    CancellationToken cancellation;
+    Matrix4f predictedModelView;
+};
+
 }
 
 struct RenderPipeline::Impl
@@ -49,40 +471,27 @@ struct RenderPipeline::Impl
     Impl( DataSource& dataSource,
           Caches& caches,
           TexturePool& texturePool,
-          ConstGLContextPtr glContext )
+          ConstGLContextPtr glContext,
+          const VolumeRendererParameters& params )
         : _dataSource( dataSource )
+        , _caches( caches )
         , _dataCache( caches.dataCache )
         , _textureCache( caches.textureCache )
         , _histogramCache( caches.histogramCache )
         , _texturePool( texturePool )
-        , _renderExecutor( nRenderThreads, glContext )
-        , _computeExecutor( nComputeThreads, glContext )
-        , _uploadExecutor( nUploadThreads, glContext )
+        , _workers( std::make_shared< Workers >( params.getRenderThreads() +
+                                                 params.getComputeThreads() +
+                                                 params.getMaxUploadThreads(),
+                                                 glContext ))
+        , _renderExecutor( _workers )
+        , _computeExecutor( _workers )
+        , _uploadExecutor( _workers )
+        , _uploadTuner( params.getUploadThreads(),
+                        params.getAutoTuneThreads() ? 1 : params.getUploadThreads(),
+                        params.getMaxUploadThreads())
     {
     }
 
-    void setupVisibleGeneratorFilter( PipeFilter& visibleSetGenerator,
-                                      const RenderParams& renderParams ) const
-    {
-        visibleSetGenerator.getPromise( "Frustum" ).set( renderParams.frameInfo.frustum );
-        visibleSetGenerator.getPromise( "Frame" ).set( renderParams.frameInfo.timeStep );
-        visibleSetGenerator.getPromise( "DataRange" ).set( renderParams.renderDataRange );
-        visibleSetGenerator.getPromise( "Params" ).set( renderParams.vrParams );
-        visibleSetGenerator.getPromise( "Viewport" ).set( renderParams.pixelViewPort );
-        visibleSetGenerator.getPromise( "ClipPlanes" ).set( renderParams.clipPlanes );
-    }
-
-    void setupRenderFilter( PipeFilter& renderFilter,
-                            const RenderParams& renderParams,
-                            const uint32_t renderStages ) const
-    {
-
-        renderFilter.getPromise( "Frustum" ).set( renderParams.frameInfo.frustum );
-        renderFilter.getPromise( "Viewport" ).set( renderParams.pixelViewPort );
-        renderFilter.getPromise( "ClipPlanes" ).set( renderParams.clipPlanes );
-        renderFilter.getPromise( "RenderStages" ).set( renderStages );
-    }
-
     void renderSync( const RenderParams& renderParams,
                      PipeFilter& sendHistogramFilter,
                      Renderer& renderer,
@@ -100,10 +509,7 @@ struct RenderPipeline::Impl
         const auto& nodeIds = renderer.order( portFutures.get< NodeIds >( "VisibleNodes" ),
                                               renderParams.frameInfo.frustum );
 
-        const VolumeInformation& volInfo = _dataSource.getVolumeInfo();
-        const size_t blockMemSize = volInfo.maximumBlockSize.product() *
-                                    volInfo.getBytesPerVoxel() *
-                                    volInfo.compCount;
+        const size_t blockMemSize = _dataSource.getVolumeInfo().getBlockMemSize();
 
         const uint32_t maxNodesPerPass =
                 renderParams.vrParams.getMaxGPUCacheMemoryMB() * LB_1MB / blockMemSize;
@@ -120,6 +526,9 @@ struct RenderPipeline::Impl
         sendHistogramFilter.getPromise( "RelativeViewport" ).set( renderParams.viewport );
         sendHistogramFilter.getPromise( "Id" ).set( renderParams.frameInfo.frameId );
 
+        // A pass reports the measurement of an earlier pass or frame, once
+        // the GPU has finished it
+        FrameCost frameCost;
         for( uint32_t i = 0; i < numberOfPasses; ++i )
         {
             uint32_t renderStages = RENDER_FRAME;
@@ -135,15 +544,21 @@ struct RenderPipeline::Impl
                                         endIndex > nodeIds.size() ? nodeIds.end() :
                                         nodeIds.begin() + endIndex );
 
-            createAndExecuteSyncPass( nodesPerPass,
-                                      renderParams,
-                                      sendHistogramFilter,
-                                      renderer,
-                                      renderStages );
+            const FrameCost& passCost = createAndExecuteSyncPass( nodesPerPass,
+                                                                  renderParams,
+                                                                  sendHistogramFilter,
+                                                                  renderer,
+                                                                  renderStages );
+            if( passCost.renderTime > 0.f )
+                frameCost = passCost;
             if( numberOfPasses > 1 )
                 ++(*showProgress);
         }
         sendHistogramFilter.schedule( _computeExecutor );
+        {
+            ScopedLock lock( _frameGraphMutex );
+            _frameCosts[ &renderer ] = frameCost;
+        }
 
         const UniqueFutureMap futures( visibleSetGenerator.getPostconditions( ));
         availability.nAvailable = futures.get< NodeIds >( "VisibleNodes" ).size();
@@ -151,76 +566,165 @@ struct RenderPipeline::Impl
     }
 
     void renderAsync( const RenderParams& renderParams,
-                      PipeFilter& sendHistogramFilter,
+                      const PipeFilterFactory& createRedrawFilter,
+                      const PipeFilterFactory& createSendHistogramFilter,
                       Renderer& renderer,
-                      NodeAvailability& availability,
-                      PipeFilter& redrawFilter ) const
+                      NodeAvailability& availability ) const
     {
-        PipeFilterT< HistogramFilter > histogramFilter( "HistogramFilter",
-                                                        _histogramCache,
-                                                        _dataCache,
-                                                        _dataSource );
-        histogramFilter.getPromise( "Frustum" ).set( renderParams.frameInfo.frustum );
-        histogramFilter.connect( "Histogram", sendHistogramFilter, "Histogram" );
-        histogramFilter.getPromise( "RelativeViewport" ).set( renderParams.viewport );
-        histogramFilter.getPromise( "DataSourceRange" ).set( renderParams.dataSourceRange );
-        sendHistogramFilter.getPromise( "RelativeViewport" ).set( renderParams.viewport );
-        sendHistogramFilter.getPromise( "Id" ).set( renderParams.frameInfo.frameId );
+        AsyncFrameGraphPtr frameGraph;
+        const CancellationToken cancellation =
+                CancellationToken::create( uploadDeadline );
+        {
+            ScopedLock lock( _frameGraphMutex );
+
+            // The previous frame of this renderer is superseded
+            CancellationToken& previous = _cancellations[ &renderer ];
+            previous.cancel();
+            previous = cancellation;
+
+            // Graphs built before the tuner changed the uploader count are
+            // dropped once their frame is done
+            const size_t nUploaders = _uploadTuner.getThreadCount();
+            AsyncFrameGraphs& frameGraphs = _frameGraphs[ &renderer ];
+
+            // The frames of a renderer update the same cut incrementally
+            LODCutPtr& lodCut = _lodCuts[ &renderer ];
+            if( !lodCut )
+                lodCut = std::make_shared< LODCut >( _dataSource );
+            frameGraphs.erase( std::remove_if( frameGraphs.begin(), frameGraphs.end(),
+                                   [nUploaders]( const AsyncFrameGraphPtr& graph )
+                                   { return graph->isIdle() &&
+                                            graph->getUploaderCount() != nUploaders; }),
+                               frameGraphs.end( ));
+
+            for( const AsyncFrameGraphPtr& idleGraph: frameGraphs )
+            {
+                if( idleGraph->isIdle( ))
+                {
+                    frameGraph = idleGraph;
+                    break;
+                }
+            }
+
+            if( frameGraph && !_uploadTuner.isDone() &&
+                frameGraph->getVisibleCount() > 0 )
+            {
+                _uploadTuner.addFrame( frameGraph->getVisibleCount(),
+                                       frameGraph->getUploadTime(),
+                                       _workers->getQueueDepth( ));
+            }
+
+            if( !frameGraph )
+            {
+                frameGraph = std::make_shared< AsyncFrameGraph >( _dataSource,
+                                                                  _caches,
+                                                                  _texturePool,
+                                                                  renderer,
+                                                                  _getRenderTimer( renderer ),
+                                                                  createRedrawFilter,
+                                                                  createSendHistogramFilter,
+                                                                  nUploaders,
+                                                                  lodCut );
+                if( frameGraphs.size() < maxFrameGraphs )
+                    frameGraphs.push_back( frameGraph );
+            }
+        }
 
-        Pipeline renderPipeline;
-        Pipeline uploadPipeline;
+        frameGraph->render( renderParams, cancellation, _renderExecutor,
+                            _computeExecutor, _uploadExecutor, availability );
+        {
+            ScopedLock lock( _frameGraphMutex );
+            _frameCosts[ &renderer ] = frameGraph->getFrameCost();
+        }
+        prefetch( renderParams, frameGraph->getVisibleNodes(), renderer );
+    }
 
-        PipeFilterT< RenderFilter > renderFilter( "RenderFilter", _dataSource, renderer );
+    /**
+     * Starts loading the nodes visible from the frustum predicted by the
+     * last frames, unless the previous prediction is still loading.
+     */
+    void prefetch( const RenderParams& renderParams,
+                   const NodeIds& visibles,
+                   const Renderer& renderer ) const
+    {
+        ScopedLock lock( _frameGraphMutex );
 
-        PipeFilter visibleSetGenerator =
-                renderPipeline.add< VisibleSetGeneratorFilter >(
-                    "VisibleSetGenerator", _dataSource );
-        setupVisibleGeneratorFilter( visibleSetGenerator,  renderParams );
+        const uint32_t nFrames = renderParams.vrParams.getPrefetchFrames();
+        if( nFrames == 0 )
+        {
+            _releasePrefetcher( renderer );
+            return;
+        }
 
-        PipeFilter renderingSetGenerator =
-                renderPipeline.add< RenderingSetGeneratorFilter >(
-                    "RenderingSetGenerator", _textureCache );
+        Prefetcher& prefetcher = _prefetchers[ &renderer ];
+        if( !prefetcher.graph )
+        {
+            // Nodes the camera did not reach long after they were predicted
+            // are wasted
+            prefetcher.statistics =
+                    std::make_shared< PrefetchStatistics >( 2 * nFrames );
+            prefetcher.graph = std::make_shared< PrefetchGraph >( _dataSource,
+                                                                  _caches,
+                                                                  _texturePool,
+                                                                  prefetcher.statistics );
+        }
 
-        visibleSetGenerator.connect( "VisibleNodes", renderingSetGenerator, "VisibleNodes" );
-        renderingSetGenerator.connect( "CacheObjects", renderFilter, "CacheObjects" );
-        renderingSetGenerator.connect( "CacheObjects", histogramFilter, "CacheObjects" );
-        renderingSetGenerator.connect( "RenderingDone", redrawFilter, "RenderingDone" );
+        prefetcher.statistics->notifyFrame( visibles );
+        prefetcher.predictor.update( renderParams.frameInfo.frustum );
+        if( !prefetcher.predictor.isPredictable( ))
+        {
+            prefetcher.cancellation.cancel();
+            return;
+        }
 
-        for( size_t i = 0; i < nUploadThreads; ++i )
+        const Frustum predicted = prefetcher.predictor.predict( nFrames );
+        if( !prefetcher.graph->isIdle() ||
+            predicted.getMVMatrix().equals( prefetcher.predictedModelView,
+                                            std::numeric_limits< float >::epsilon( )))
         {
-            std::stringstream name;
-            name << "DataUploader" << i;
-            PipeFilter uploader =  uploadPipeline.add< DataUploadFilter >( name.str(),
-                                                                           i,
-                                                                           nUploadThreads,
-                                                                           _dataCache,
-                                                                           _textureCache,
-                                                                           _dataSource,
-                                                                           _texturePool );
-
-            visibleSetGenerator.connect( "VisibleNodes", uploader, "VisibleNodes" );
-            visibleSetGenerator.connect( "Params", uploader, "Params" );
-            uploader.connect( "CacheObjects", redrawFilter, "CacheObjects" );
+            return;
         }
 
-        setupRenderFilter( renderFilter, renderParams, RENDER_ALL );
+        RenderParams predictedParams = renderParams;
+        predictedParams.frameInfo = FrameInfo( predicted,
+                                               renderParams.frameInfo.timeStep,
+                                               renderParams.frameInfo.frameId );
+        prefetcher.predictedModelView = predicted.getMVMatrix();
+        prefetcher.cancellation = CancellationToken::create();
+        prefetcher.graph->prefetch( predictedParams, visibles,
+                                    prefetcher.cancellation, _uploadExecutor );
+    }
 
-        redrawFilter.schedule( _renderExecutor );
-        renderPipeline.schedule( _renderExecutor );
-        uploadPipeline.schedule( _uploadExecutor );
-        sendHistogramFilter.schedule( _computeExecutor );
-        histogramFilter.schedule( _computeExecutor );
-        renderFilter.execute();
+    ConstPrefetchStatisticsPtr getPrefetchStatistics( const Renderer& renderer ) const
+    {
+        ScopedLock lock( _frameGraphMutex );
+        const auto i = _prefetchers.find( &renderer );
+        return i == _prefetchers.end() ? ConstPrefetchStatisticsPtr()
+                                       : i->second.statistics;
+    }
 
-        const UniqueFutureMap futures( renderingSetGenerator.getPostconditions( ));
-        availability = futures.get< NodeAvailability >( "NodeAvailability" );
+    FrameCost getFrameCost( const Renderer& renderer ) const
+    {
+        ScopedLock lock( _frameGraphMutex );
+        const auto i = _frameCosts.find( &renderer );
+        return i == _frameCosts.end() ? FrameCost() : i->second;
     }
 
-    void createAndExecuteSyncPass( NodeIds nodeIds,
-                                   const RenderParams& renderParams,
-                                   PipeFilter& sendHistogramFilter,
-                                   Renderer& renderer,
-                                   const uint32_t renderStages ) const
+    void _releasePrefetcher( const Renderer& renderer ) const
+    {
+        const auto i = _prefetchers.find( &renderer );
+        if( i == _prefetchers.end( ))
+            return;
+        i->second.cancellation.cancel();
+        _prefetchers.erase( i );
+    }
+
+    /** @return the rendering cost measured by a previous pass, if available */
+    FrameCost createAndExecuteSyncPass( NodeIds nodeIds,
+                                        const RenderParams& renderParams,
+                                        PipeFilter& sendHistogramFilter,
+                                        Renderer& renderer,
+                                        const uint32_t renderStages ) const
     {
         PipeFilterT< HistogramFilter > histogramFilter( "HistogramFilter",
                                                         _histogramCache,
@@ -231,76 +735,139 @@ struct RenderPipeline::Impl
         histogramFilter.getPromise( "RelativeViewport" ).set( renderParams.viewport );
         histogramFilter.getPromise( "DataSourceRange" ).set( renderParams.dataSourceRange );
 
-        Pipeline renderPipeline;
         Pipeline uploadPipeline;
 
-        PipeFilterT< RenderFilter > renderFilter( "RenderFilter", _dataSource, renderer );
-        setupRenderFilter( renderFilter, renderParams, renderStages );
-
-        for( size_t i = 0; i < nUploadThreads; ++i )
+        RenderTimerPtr renderTimer;
         {
-            std::stringstream name;
-            name << "DataUploader" << i;
-            PipeFilter uploader = uploadPipeline.add< DataUploadFilter >( name.str(),
-                                                                          i,
-                                                                          nUploadThreads,
-                                                                          _dataCache,
-                                                                          _textureCache,
-                                                                          _dataSource,
-                                                                          _texturePool );
-
-            uploader.getPromise( "VisibleNodes" ).set( nodeIds );
-            uploader.getPromise( "Params" ).set( renderParams.vrParams );
-            uploader.connect( "CacheObjects", renderFilter, "CacheObjects" );
-            uploader.connect( "CacheObjects", histogramFilter, "CacheObjects" );
+            ScopedLock lock( _frameGraphMutex );
+            renderTimer = _getRenderTimer( renderer );
         }
+        PipeFilterT< RenderFilter > renderFilter( "RenderFilter", _dataSource, renderer,
+                                                  renderTimer );
+        setupRenderFilter( renderFilter, renderParams, renderStages );
+
+        UploadMap uploadMap =
+            uploadPipeline.addParallelMap< DataUploadFilter, NodeId, ConstCacheObjectPtr >(
+                "DataUploader", "VisibleNodes", "CacheObjects", _getUploaderCount(),
+                _dataCache, _textureCache, _dataSource, _texturePool );
+
+        PipeFilter& uploadInput = uploadMap.getInput();
+        uploadInput.getPromise( "VisibleNodes" ).set( nodeIds );
+        uploadInput.getPromise( "Params" ).set( renderParams.vrParams );
+        uploadInput.getPromise( "Frustum" ).set( renderParams.frameInfo.frustum );
+        uploadInput.getPromise( "Cancellation" ).set( CancellationToken( ));
+        uploadMap.getOutput().connect( "CacheObjects", renderFilter, "CacheObjects" );
+        uploadMap.getOutput().connect( "CacheObjects", histogramFilter, "CacheObjects" );
 
-        renderPipeline.schedule( _renderExecutor );
         uploadPipeline.schedule( _uploadExecutor );
         histogramFilter.schedule( _computeExecutor );
         renderFilter.execute();
+
+        const UniqueFutureMap renderOutputs( renderFilter.getPostconditions( ));
+        return renderOutputs.get< FrameCost >( "FrameCost" );
+    }
+
+    /**
+     * @return the timer measuring the rendering of all frames of the renderer.
+     * The frame graph mutex has to be locked.
+     */
+    RenderTimerPtr _getRenderTimer( const Renderer& renderer ) const
+    {
+        RenderTimerPtr& renderTimer = _renderTimers[ &renderer ];
+        if( !renderTimer )
+            renderTimer = std::make_shared< RenderTimer >();
+        return renderTimer;
     }
 
     void render( const RenderParams& renderParams,
-                 PipeFilter& redrawFilter,
-                 PipeFilter& sendHistogramFilter,
+                 const PipeFilterFactory& createRedrawFilter,
+                 const PipeFilterFactory& createSendHistogramFilter,
                  Renderer& renderer,
                  NodeAvailability& availability ) const
     {
         if( renderParams.vrParams.getSynchronousMode( ))
+        {
+            PipeFilter sendHistogramFilter = createSendHistogramFilter();
             renderSync( renderParams, sendHistogramFilter, renderer, availability );
+        }
         else
-            renderAsync( renderParams, sendHistogramFilter, renderer, availability, redrawFilter );
+            renderAsync( renderParams, createRedrawFilter, createSendHistogramFilter,
+                         renderer, availability );
+    }
 
+    size_t _getUploaderCount() const
+    {
+        ScopedLock lock( _frameGraphMutex );
+        return _uploadTuner.getThreadCount();
+    }
+
+    void release( const Renderer& renderer ) const
+    {
+        ScopedLock lock( _frameGraphMutex );
+        _frameGraphs.erase( &renderer );
+        _cancellations.erase( &renderer );
+        _lodCuts.erase( &renderer );
+        _releasePrefetcher( renderer );
+        _frameCosts.erase( &renderer );
+        _renderTimers.erase( &renderer );
     }
 
     DataSource& _dataSource;
+    const Caches _caches;
     Cache& _dataCache;
     Cache& _textureCache;
     Cache& _histogramCache;
     TexturePool& _texturePool;
-    mutable SimpleExecutor _renderExecutor;
-    mutable SimpleExecutor _computeExecutor;
-    mutable SimpleExecutor _uploadExecutor;
+    WorkersPtr _workers;
+    mutable DAGExecutor _renderExecutor;
+    mutable DAGExecutor _computeExecutor;
+    mutable DAGExecutor _uploadExecutor;
+    mutable std::map< const Renderer*, AsyncFrameGraphs > _frameGraphs;
+    mutable std::map< const Renderer*, CancellationToken > _cancellations;
+    mutable std::map< const Renderer*, LODCutPtr > _lodCuts;
+    mutable std::map< const Renderer*, Prefetcher > _prefetchers;
+    mutable std::map< const Renderer*, FrameCost > _frameCosts;
+    mutable std::map< const Renderer*, RenderTimerPtr > _renderTimers;
+    mutable ThreadTuner _uploadTuner;
+    mutable boost::mutex _frameGraphMutex;
 };
 
 RenderPipeline::RenderPipeline( DataSource& dataSource,
                                 Caches& caches,
                                 TexturePool& texturePool,
-                                ConstGLContextPtr glContext )
-    : _impl( new RenderPipeline::Impl( dataSource, caches, texturePool, glContext ))
+                                ConstGLContextPtr glContext,
+                                const VolumeRendererParameters& params )
+    : _impl( new RenderPipeline::Impl( dataSource, caches, texturePool, glContext,
+                                       params ))
 {}
 
 RenderPipeline::~RenderPipeline()
 {}
 
 void RenderPipeline::render( const RenderParams& renderParams,
-                             PipeFilter redrawFilter,
-                             PipeFilter sendHistogramFilter,
+                             const PipeFilterFactory& createRedrawFilter,
+                             const PipeFilterFactory& createSendHistogramFilter,
                              Renderer& renderer,
                              NodeAvailability& avaibility ) const
 {
-    _impl->render( renderParams, redrawFilter, sendHistogramFilter, renderer, avaibility );
+    _impl->render( renderParams, createRedrawFilter, createSendHistogramFilter,
+                   renderer, avaibility );
+}
+
+void RenderPipeline::release( const Renderer& renderer ) const
+{
+    _impl->release( renderer );
+}
+
+ConstPrefetchStatisticsPtr
+RenderPipeline::getPrefetchStatistics( const Renderer& renderer ) const
+{
+    return _impl->getPrefetchStatistics( renderer );
+}
+
+FrameCost RenderPipeline::getFrameCost( const Renderer& renderer ) const
+{
+    return _impl->getFrameCost( renderer );
 }
 
 }
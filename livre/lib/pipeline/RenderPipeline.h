@@ -23,6 +23,7 @@
 #include <livre/lib/configuration/VolumeRendererParameters.h>
 #include <livre/lib/types.h>
 
+#include <livre/core/render/BrickCost.h>
 #include <livre/core/render/ClipPlanes.h>
 #include <livre/core/render/FrameInfo.h>
 
@@ -47,10 +48,20 @@ struct RenderParams
     PixelViewport pixelViewPort;
     Viewport viewport;
     ClipPlanes clipPlanes;
+    BrickCostModel brickCost; //!< splits the bricks of sort-last channels
 };
 
+/** Creates a filter the application connects to the rendering pipeline */
+typedef std::function< PipeFilter() > PipeFilterFactory;
+
 /**
- * RenderPipeline generates and executes the rendering pipeline every frame
+ * RenderPipeline executes the rendering pipeline every frame. The
+ * asynchronous frame graphs are built once per renderer and re-armed with
+ * the new inputs every frame.
+ *
+ * If the parameters ask for prefetching, the camera of the next frames is
+ * predicted from the frusta of the last frames, and the nodes visible from it
+ * are loaded in the background.
  */
 class RenderPipeline
 {
@@ -63,27 +74,54 @@ public:
      * @param dataSource the data source
      * @param texturePool the pool for textures
      * @param glContext the gl context that will be shared
+     * @param params the thread counts of the pipeline stages
      */
     RenderPipeline( DataSource& dataSource,
                     Caches& caches,
                     TexturePool& texturePool,
-                    ConstGLContextPtr glContext );
+                    ConstGLContextPtr glContext,
+                    const VolumeRendererParameters& params );
 
     ~RenderPipeline();
 
     /**
      * Renders a frame using the given frustum and view
      * @param renderParams parameters for rendering
-     * @param redrawFilter executed on data update
-     * @param sendHistogramFilter executed on histogram computation
+     * @param createRedrawFilter creates the filter executed on data update.
+     * It is only called when a new frame graph is built.
+     * @param createSendHistogramFilter creates the filter executed on
+     * histogram computation. It is only called when a new frame graph is built.
      * @param renderer the rendering algorithm
      * @param availability the number of available and not available nodes are written
      */
     void render( const RenderParams& renderParams,
-                 PipeFilter redrawFilter,
-                 PipeFilter sendHistogramFilter,
+                 const PipeFilterFactory& createRedrawFilter,
+                 const PipeFilterFactory& createSendHistogramFilter,
                  Renderer& renderer,
                  NodeAvailability& avaibility ) const;
+
+    /**
+     * Releases the frame graphs built for the renderer. Has to be called
+     * before the renderer is destroyed, in the rendering thread of the
+     * renderer, so its timer query is deleted in its GL context.
+     * @param renderer the rendering algorithm
+     */
+    void release( const Renderer& renderer ) const;
+
+    /**
+     * @param renderer the rendering algorithm
+     * @return the statistics of the nodes prefetched for the renderer, empty
+     * if the renderer does not prefetch
+     */
+    ConstPrefetchStatisticsPtr getPrefetchStatistics( const Renderer& renderer ) const;
+
+    /**
+     * @param renderer the rendering algorithm
+     * @return the measured costs of the last rendered frame of the renderer.
+     * The rendering is only measured for sort-last ranges, and the uploads
+     * only in asynchronous mode.
+     */
+    FrameCost getFrameCost( const Renderer& renderer ) const;
 private:
 
     struct Impl;
@@ -25,82 +25,125 @@
 #include <livre/core/pipeline/Workers.h>
 #include <livre/core/pipeline/PortData.h>
 
+#include <livre/core/data/NodeId.h>
 #include <livre/core/render/FrameInfo.h>
 
+#include <algorithm>
+
 namespace livre
 {
 
+namespace
+{
+/** @return true if ancestor is the node or one of its parents */
+bool isAncestorOrSelf( const NodeId& ancestor, const NodeId& node )
+{
+    if( ancestor.getTimeStep() != node.getTimeStep() ||
+        ancestor.getLevel() > node.getLevel( ))
+    {
+        return false;
+    }
+
+    const uint32_t shift = node.getLevel() - ancestor.getLevel();
+    const Vector3ui& ancestorPos = ancestor.getPosition();
+    const Vector3ui& nodePos = node.getPosition();
+    return ( nodePos[0] >> shift ) == ancestorPos[0] &&
+           ( nodePos[1] >> shift ) == ancestorPos[1] &&
+           ( nodePos[2] >> shift ) == ancestorPos[2];
+}
+}
+
+/**
+ * Replaces each visible node which has no texture by its closest parent with
+ * one, and drops the nodes which are covered by a parent in the rendering set.
+ *
+ * In Morton order a node is followed by all the nodes it covers, so this is
+ * done in one pass over the visibles, keeping the nodes of the rendering set
+ * on a stack. The textures of the visibles and their parents are queried with
+ * a single lock of the texture cache.
+ */
 struct RenderingSetGenerator
 {
     explicit RenderingSetGenerator( const Cache& textureCache )
         : _textureCache( textureCache )
     {}
 
-    bool hasParentInMap( const NodeId& childRenderNode,
-                         const ConstCacheMap& cacheMap ) const
-    {
-        const NodeIds& parentNodeIds = childRenderNode.getParents();
-
-        for( const NodeId& parentId : parentNodeIds )
-            if( cacheMap.find( parentId.getId( )) != cacheMap.end() )
-                return true;
-
-        return false;
-    }
-
-    void collectLoadedTextures( const NodeId& nodeId,
-                                ConstCacheMap& cacheMap ) const
+    /** @return the loaded textures of the visibles and their parents */
+    ConstCacheMap getLoadedTextures( const NodeIds& visibles ) const
     {
-        NodeId current = nodeId;
-        while( current.isValid( ))
+        // The parents of a node which cover the previous node are already
+        // collected for it, as are their parents.
+        CacheIds cacheIds;
+        cacheIds.reserve( visibles.size( ));
+        NodeId previous;
+        for( const NodeId& nodeId: visibles )
         {
-            const NodeId& currentNodeId = current;
-            const ConstCacheObjectPtr texture = _textureCache.get( currentNodeId.getId( ));
-            if( texture )
+            NodeId current = nodeId;
+            while( current.isValid() &&
+                   !( previous.isValid() && isAncestorOrSelf( current, previous )))
             {
-                cacheMap[ currentNodeId.getId() ] = texture;
-                break;
+                cacheIds.push_back( current.getId( ));
+                current = current.isRoot() ? NodeId() : current.getParent();
             }
+            previous = nodeId;
+        }
+
+        const ConstCacheObjects& textures = _textureCache.get( cacheIds );
 
-            current = currentNodeId.isRoot() ? NodeId() :
-                                               currentNodeId.getParent();
+        ConstCacheMap loaded;
+        for( size_t i = 0; i < cacheIds.size(); ++i )
+        {
+            if( textures[ i ] )
+                loaded.emplace( cacheIds[ i ], textures[ i ]);
         }
+        return loaded;
     }
 
     ConstCacheObjects generateRenderingSet( const NodeIds& visibles,
                                             NodeAvailability& availability ) const
     {
-        ConstCacheMap cacheMap;
-        for( const NodeId& nodeId : visibles )
+        if( !std::is_sorted( visibles.begin(), visibles.end(), mortonLess ))
         {
-            collectLoadedTextures( nodeId, cacheMap );
-            cacheMap.count( nodeId.getId( )) > 0 ?
-                        ++availability.nAvailable : ++availability.nNotAvailable;
+            NodeIds sorted = visibles;
+            sortMorton( sorted );
+            return generateRenderingSet( sorted, availability );
         }
 
-        if( visibles.size() != cacheMap.size( ))
+        const ConstCacheMap& loaded = getLoadedTextures( visibles );
+
+        NodeIds renderNodes;
+        ConstCacheObjects cacheObjects;
+        for( const NodeId& nodeId: visibles )
         {
-            ConstCacheMap::const_iterator it = cacheMap.begin();
-            size_t previousSize = 0;
-            do
+            NodeId current = nodeId;
+            ConstCacheMap::const_iterator it = loaded.find( current.getId( ));
+            while( it == loaded.end() && !current.isRoot( ))
             {
-                previousSize = cacheMap.size();
-                while( it != cacheMap.end( ))
-                {
-                    if( hasParentInMap( NodeId( it->first ), cacheMap ))
-                        it = cacheMap.erase( it );
-                    else
-                        ++it;
-                }
+                current = current.getParent();
+                it = loaded.find( current.getId( ));
             }
-            while( previousSize != cacheMap.size( ));
-        }
 
-        ConstCacheObjects cacheObjects;
-        cacheObjects.reserve( cacheMap.size( ));
-        for( ConstCacheMap::const_iterator it = cacheMap.begin();
-             it != cacheMap.end(); ++it )
-        {
+            if( current == nodeId && it != loaded.end( ))
+                ++availability.nAvailable;
+            else
+                ++availability.nNotAvailable;
+
+            if( it == loaded.end() ||
+                ( !renderNodes.empty() &&
+                  isAncestorOrSelf( renderNodes.back(), current )))
+            {
+                continue;
+            }
+
+            // A parent replaces the nodes it covers, which precede it when
+            // it stands in for a later visible
+            while( !renderNodes.empty() &&
+                   isAncestorOrSelf( current, renderNodes.back( )))
+            {
+                renderNodes.pop_back();
+                cacheObjects.pop_back();
+            }
+            renderNodes.push_back( current );
             cacheObjects.push_back( it->second );
         }
 
@@ -124,7 +167,7 @@ struct RenderingSetGeneratorFilter::Impl
         ConstCacheObjects cacheObjects;
         size_t nVisible = 0;
         NodeAvailability cumulativeAvailability;
-        for( const auto& visibles: input.get< NodeIds >( "VisibleNodes" ))
+        for( const NodeIds& visibles: input.getRefs< NodeIds >( "VisibleNodes" ))
         {
             NodeAvailability avaliability;
             const ConstCacheObjects& objs = renderSetGenerator.generateRenderingSet( visibles,
@@ -134,8 +177,8 @@ struct RenderingSetGeneratorFilter::Impl
             cumulativeAvailability += avaliability;
         }
 
-        output.set( "CacheObjects", cacheObjects );
         output.set( "RenderingDone", cacheObjects.size() == nVisible );
+        output.set( "CacheObjects", std::move( cacheObjects ));
         output.set( "NodeAvailability", cumulativeAvailability );
     }
 
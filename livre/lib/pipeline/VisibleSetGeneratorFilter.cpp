@@ -24,18 +24,40 @@
 #include <livre/core/pipeline/InputPort.h>
 #include <livre/core/pipeline/Workers.h>
 #include <livre/core/pipeline/PortData.h>
+#include <livre/core/render/BrickCost.h>
+#include <livre/core/render/LODCriterion.h>
+#include <livre/core/render/LODCut.h>
 #include <livre/core/render/SelectVisibles.h>
 #include <livre/core/render/ClipPlanes.h>
 #include <livre/core/data/DataSource.h>
+#include <livre/core/data/LODNode.h>
+#include <livre/core/data/VolumeInformation.h>
 #include <livre/core/visitor/DFSTraversal.h>
 
 namespace livre
 {
+namespace
+{
+// The subtrees at this level are traversed in parallel, i.e. up to 64 tasks
+// per root block
+const uint32_t taskLevel = 2;
+
+const Range fullRange = {{ 0.f, 1.f }};
+
+/** @return the number of nodes which fit in the GPU cache memory */
+size_t getMaxNodes( const VolumeInformation& volInfo,
+                    const VolumeRendererParameters& params )
+{
+    return params.getMaxGPUCacheMemoryMB() * LB_1MB /
+           volInfo.getBlockMemSize();
+}
+}
 
 struct VisibleSetGeneratorFilter::Impl
 {
-    explicit Impl( const DataSource& dataSource )
+    Impl( const DataSource& dataSource, LODCutPtr lodCut )
         : _dataSource( dataSource )
+        , _lodCut( lodCut )
     {}
 
     void execute( const FutureMap& input,
@@ -49,30 +71,81 @@ struct VisibleSetGeneratorFilter::Impl
         const auto& params = uniqueInputs.get< VolumeRendererParameters >( "Params" );
         const auto& vp = uniqueInputs.get< PixelViewport >( "Viewport" );
         const auto& clipPlanes = uniqueInputs.get< ClipPlanes >( "ClipPlanes" );
+        const auto& brickCost = uniqueInputs.get< BrickCostModel >( "BrickCost" );
 
         const uint32_t windowHeight = vp[ 3 ];
         const float sse = params.getSSE();
         const uint32_t minLOD = params.getMinLOD();
         const uint32_t maxLOD = params.getMaxLOD();
 
-        SelectVisibles visitor( _dataSource,
-                                frustum,
-                                windowHeight,
-                                sse,
-                                minLOD,
-                                maxLOD,
-                                range,
-                                clipPlanes );
-
-        DFSTraversal traverser;
-        traverser.traverse( _dataSource.getVolumeInfo().rootNode,
-                            visitor,
-                            frame );
-
-        output.set( "VisibleNodes", visitor.getVisibles( ));
+        // The cut depends on the frames this renderer has seen before, while
+        // the sort-last channels have to split the same visibles
+        const bool isSortLast = range != fullRange;
+        const bool useLODCut = _lodCut && !isSortLast;
+
+        const VolumeInformation& volInfo = _dataSource.getVolumeInfo();
+        NodeIds visibles;
+        if( params.getBudgetedLOD() || useLODCut )
+        {
+            const LODCriterion criterion( frustum, windowHeight, sse, minLOD,
+                                          maxLOD, volInfo.rootNode.getDepth(),
+                                          clipPlanes );
+            if( params.getBudgetedLOD( ))
+                visibles = selectBudgeted( _dataSource, criterion, frame,
+                                           getMaxNodes( volInfo, params ));
+            else
+                visibles = _lodCut->update( criterion, frame );
+        }
+        else
+        {
+            SelectVisibles visitor( _dataSource,
+                                    frustum,
+                                    windowHeight,
+                                    sse,
+                                    minLOD,
+                                    maxLOD,
+                                    fullRange,
+                                    clipPlanes );
+
+            // The filter runs on a pipeline worker, which joins the cores
+            // left by the other pipeline threads
+            DFSTraversal traverser;
+            traverser.traverse( volInfo.rootNode,
+                                visitor,
+                                frame,
+                                taskLevel,
+                                params.getFreeCores() + 1 );
+            visibles = visitor.takeVisibles();
+        }
+
+        if( isSortLast )
+            selectRange( visibles, getCosts( visibles, frustum, brickCost ),
+                         range );
+
+        output.set( "VisibleNodes", std::move( visibles ));
         output.set( "Params", params );
     }
 
+    /** @return the estimated rendering and upload costs of the visibles */
+    Floats getCosts( const NodeIds& visibles, const Frustum& frustum,
+                     const BrickCostModel& brickCost ) const
+    {
+        const Matrix4f& mvpMatrix = frustum.getMVPMatrix();
+        const size_t blockMemSize =
+                _dataSource.getVolumeInfo().getBlockMemSize();
+
+        Floats costs;
+        costs.reserve( visibles.size( ));
+        for( const NodeId& nodeId: visibles )
+        {
+            const LODNode& node = _dataSource.getNode( nodeId );
+            costs.push_back( brickCost.getCost( getScreenArea( node.getWorldBox(),
+                                                               mvpMatrix ),
+                                                blockMemSize ));
+        }
+        return costs;
+    }
+
     DataInfos getInputDataInfos() const
     {
         return {
@@ -81,7 +154,8 @@ struct VisibleSetGeneratorFilter::Impl
             { "DataRange", getType< Range >() },
             { "Params", getType< VolumeRendererParameters >() },
             { "Viewport", getType< PixelViewport >() },
-            { "ClipPlanes", getType< ClipPlanes >() }
+            { "ClipPlanes", getType< ClipPlanes >() },
+            { "BrickCost", getType< BrickCostModel >() }
         };
     }
 
@@ -95,10 +169,12 @@ struct VisibleSetGeneratorFilter::Impl
     }
 
     const DataSource& _dataSource;
+    const LODCutPtr _lodCut;
 };
 
-VisibleSetGeneratorFilter::VisibleSetGeneratorFilter( const DataSource& dataSource )
-    : _impl( new VisibleSetGeneratorFilter::Impl( dataSource ))
+VisibleSetGeneratorFilter::VisibleSetGeneratorFilter( const DataSource& dataSource,
+                                                      LODCutPtr lodCut )
+    : _impl( new VisibleSetGeneratorFilter::Impl( dataSource, lodCut ))
 {
 }
 
@@ -31,6 +31,12 @@ namespace livre
 /**
  * Collects all the visibles for given inputs ( Frustums, Frames, Data Ranges,
  * Rendering params and Viewports )
+ *
+ * The visibles are split between the sort-last channels in Morton order, by
+ * their rendering and upload costs estimated with the "BrickCost" model. The
+ * channels have to split the same visibles by the same costs: the model is
+ * the one shared by the render settings, and the visibles of a sort-last
+ * range are selected without the cut of the previous frames.
  */
 class VisibleSetGeneratorFilter : public Filter
 {
@@ -40,8 +46,12 @@ public:
     /**
      * Constructor
      * @param dataSource the data source
+     * @param lodCut if set, the visibles of the full range are updated
+     *        incrementally from the cut of the previous frames instead of a
+     *        full traversal
      */
-    explicit VisibleSetGeneratorFilter( const DataSource& dataSource );
+    explicit VisibleSetGeneratorFilter( const DataSource& dataSource,
+                                        LODCutPtr lodCut = LODCutPtr( ));
     ~VisibleSetGeneratorFilter();
 
     /**
@@ -0,0 +1,169 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE BrickCost
+
+#include <livre/core/data/NodeId.h>
+#include <livre/core/render/BrickCost.h>
+#include <livre/core/render/SelectVisibles.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+const float identityArray[] = { 1, 0, 0, 0,
+                                0, 1, 0, 0,
+                                0, 0, 1, 0,
+                                0, 0, 0, 1 };
+
+const float projArray[] = { 2.0, 0, 0, 0,
+                            0, 2.0, 0, 0,
+                            0, 0, -1.01342285, -1,
+                            0, 0, -0.201342285, 0 };
+
+livre::NodeIds createNodes( const size_t nNodes )
+{
+    livre::NodeIds nodes;
+    for( uint32_t i = 0; i < nNodes; ++i )
+        nodes.push_back( livre::NodeId( 3, livre::Vector3ui( i, 0, 0 )));
+    return nodes;
+}
+
+/** @return the nodes of each range of a split of the full range */
+std::vector< livre::NodeIds > split( const livre::NodeIds& nodes,
+                                     const livre::Floats& costs,
+                                     const livre::Floats& bounds )
+{
+    std::vector< livre::NodeIds > parts;
+    for( size_t i = 0; i + 1 < bounds.size(); ++i )
+    {
+        livre::NodeIds part = nodes;
+        livre::selectRange( part, costs, {{ bounds[i], bounds[i + 1] }});
+        parts.push_back( part );
+    }
+    return parts;
+}
+
+float getCost( const livre::NodeIds& part, const livre::NodeIds& nodes,
+               const livre::Floats& costs )
+{
+    float cost = 0.f;
+    for( const livre::NodeId& nodeId: part )
+    {
+        const auto i = std::find( nodes.begin(), nodes.end(), nodeId );
+        cost += costs[ i - nodes.begin() ];
+    }
+    return cost;
+}
+}
+
+BOOST_AUTO_TEST_CASE( testLearnCosts )
+{
+    livre::BrickCostModel model( 10.f, 1.f );
+    BOOST_CHECK_CLOSE( model.getCost( 0.5f, 2 * LB_1MB ), 7.f, 1e-3f );
+
+    // Work not done in a frame keeps its cost
+    model.addFrame( livre::FrameCost( ));
+    BOOST_CHECK_EQUAL( model.getRenderCost(), 10.f );
+    BOOST_CHECK_EQUAL( model.getUploadCost(), 1.f );
+
+    livre::FrameCost frameCost;
+    frameCost.renderTime = 40.f;
+    frameCost.renderedArea = 2.f;
+    frameCost.uploadTime = 12.f;
+    frameCost.uploadedBytes = 4 * LB_1MB;
+    for( size_t i = 0; i < 200; ++i )
+    {
+        const float renderCost = model.getRenderCost();
+        model.addFrame( frameCost );
+        BOOST_CHECK_GT( model.getRenderCost(), renderCost - 1e-5f );
+    }
+    BOOST_CHECK_CLOSE( model.getRenderCost(), 20.f, 1e-2f );
+    BOOST_CHECK_CLOSE( model.getUploadCost(), 3.f, 1e-2f );
+}
+
+BOOST_AUTO_TEST_CASE( testScreenArea )
+{
+    const livre::Matrix4f identity( identityArray, identityArray + 16 );
+    const livre::Boxf viewport( livre::Vector3f( -1.f ), livre::Vector3f( 1.f ));
+    BOOST_CHECK_CLOSE( livre::getScreenArea( viewport, identity ), 1.f, 1e-3f );
+
+    const livre::Boxf quarter( livre::Vector3f( -.5f ), livre::Vector3f( .5f ));
+    BOOST_CHECK_CLOSE( livre::getScreenArea( quarter, identity ), .25f, 1e-3f );
+
+    const livre::Boxf larger( livre::Vector3f( 0.f ), livre::Vector3f( 4.f ));
+    BOOST_CHECK_CLOSE( livre::getScreenArea( larger, identity ), .25f, 1e-3f );
+
+    const livre::Boxf outside( livre::Vector3f( 2.f ), livre::Vector3f( 3.f ));
+    BOOST_CHECK_EQUAL( livre::getScreenArea( outside, identity ), 0.f );
+
+    const livre::Matrix4f projection( projArray, projArray + 16 );
+    const livre::Boxf behind( livre::Vector3f( -.1f, -.1f, .5f ),
+                              livre::Vector3f( .1f, .1f, 1.f ));
+    BOOST_CHECK_EQUAL( livre::getScreenArea( behind, projection ), 1.f );
+
+    const livre::Boxf near( livre::Vector3f( -.1f, -.1f, -2.f ),
+                            livre::Vector3f( .1f, .1f, -1.f ));
+    const livre::Boxf far( livre::Vector3f( -.1f, -.1f, -5.f ),
+                           livre::Vector3f( .1f, .1f, -4.f ));
+    BOOST_CHECK_GT( livre::getScreenArea( near, projection ),
+                    livre::getScreenArea( far, projection ));
+}
+
+BOOST_AUTO_TEST_CASE( testCostRangesPartition )
+{
+    const livre::NodeIds nodes = createNodes( 64 );
+    livre::Floats costs;
+    for( size_t i = 0; i < nodes.size(); ++i )
+        costs.push_back( i < 16 ? 10.f : 1.f );
+
+    const livre::Floats bounds = { 0.f, .25f, .5f, .75f, 1.f };
+    const std::vector< livre::NodeIds > parts = split( nodes, costs, bounds );
+
+    // The ranges are contiguous in the visibles order and cover all of them
+    livre::NodeIds joined;
+    for( const livre::NodeIds& part: parts )
+        joined.insert( joined.end(), part.begin(), part.end( ));
+    BOOST_CHECK( joined == nodes );
+
+    // The expensive nodes are spread over more ranges than the cheap ones
+    BOOST_CHECK_LT( parts[0].size(), parts[3].size( ));
+    const float total = std::accumulate( costs.begin(), costs.end(), 0.f );
+    const float maxCost = *std::max_element( costs.begin(), costs.end( ));
+    for( const livre::NodeIds& part: parts )
+        BOOST_CHECK_LE( std::abs( getCost( part, nodes, costs ) - total / 4.f ),
+                        maxCost );
+}
+
+BOOST_AUTO_TEST_CASE( testZeroCostsSplitByCount )
+{
+    const livre::NodeIds nodes = createNodes( 12 );
+    const livre::Floats costs( nodes.size(), 0.f );
+    const std::vector< livre::NodeIds > parts =
+            split( nodes, costs, { 0.f, .5f, 1.f });
+
+    BOOST_CHECK_EQUAL( parts[0].size(), 6u );
+    BOOST_CHECK_EQUAL( parts[1].size(), 6u );
+    BOOST_CHECK( parts[0].front() == nodes.front( ));
+    BOOST_CHECK( parts[1].back() == nodes.back( ));
+}
@@ -74,3 +74,23 @@ BOOST_AUTO_TEST_CASE( testCache )
     BOOST_CHECK_EQUAL( cache.getCount(), 0 );
     BOOST_CHECK_EQUAL( cache.getStatistics().getUsedMemory(), 0 );
 }
+
+BOOST_AUTO_TEST_CASE( testCacheInsert )
+{
+    livre::CacheT< test::ValidCacheObject > cache( "Test Cache", 2048u );
+
+    // An object constructed outside of the cache is only visible once inserted
+    const test::ConstValidCacheObjectPtr object( new test::ValidCacheObject( 1 ));
+    BOOST_CHECK( !cache.get( 1 ));
+
+    BOOST_CHECK_EQUAL( cache.insert( object ), object );
+    BOOST_CHECK_EQUAL( cache.get( 1 ), object );
+    BOOST_CHECK_EQUAL( cache.getCount(), 1 );
+    BOOST_CHECK_EQUAL( cache.getStatistics().getUsedMemory(), test::OBJECT_SIZE );
+
+    // The object loaded first is kept
+    const test::ConstValidCacheObjectPtr duplicate( new test::ValidCacheObject( 1 ));
+    BOOST_CHECK_EQUAL( cache.insert( duplicate ), object );
+    BOOST_CHECK_EQUAL( cache.getCount(), 1 );
+    BOOST_CHECK_EQUAL( cache.getStatistics().getUsedMemory(), test::OBJECT_SIZE );
+}
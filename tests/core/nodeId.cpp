@@ -0,0 +1,102 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE NodeId
+
+#include <boost/test/unit_test.hpp>
+
+#include "livre/core/data/NodeId.h"
+
+BOOST_AUTO_TEST_CASE( childRange )
+{
+    const livre::NodeId nodeId( 2, livre::Vector3ui( 1, 2, 3 ), 4 );
+    const livre::NodeIds& children = nodeId.getChildren();
+
+    BOOST_CHECK_EQUAL( nodeId.getChildRange().size(), 8u );
+    BOOST_CHECK_EQUAL( children.size(), 8u );
+
+    uint32_t i = 0;
+    for( const livre::NodeId& child: nodeId.getChildRange( ))
+    {
+        BOOST_CHECK( child == children[ i ] );
+        BOOST_CHECK( child == nodeId.getChild( i ));
+        BOOST_CHECK( child.getParent() == nodeId );
+        BOOST_CHECK_EQUAL( child.getTimeStep(), 4u );
+        ++i;
+    }
+    BOOST_CHECK_EQUAL( i, 8u );
+
+    BOOST_CHECK( livre::NodeId().getChildRange().empty( ));
+    BOOST_CHECK( livre::NodeId().getChildren().empty( ));
+}
+
+BOOST_AUTO_TEST_CASE( parentAndSiblingRanges )
+{
+    const livre::NodeId nodeId( 3, livre::Vector3ui( 5, 6, 7 ));
+    const livre::NodeIds& parents = nodeId.getParents();
+    BOOST_CHECK_EQUAL( parents.size(), 3u );
+
+    size_t i = 0;
+    for( const livre::NodeId& parent: nodeId.getParentRange( ))
+        BOOST_CHECK( parent == parents[ i++ ] );
+    BOOST_CHECK_EQUAL( i, 3u );
+    BOOST_CHECK( parents.back().isRoot( ));
+
+    const livre::NodeId root( 0, livre::Vector3ui( 0u ));
+    BOOST_CHECK( root.getParentRange().empty( ));
+    BOOST_CHECK( root.getSiblingRange().empty( ));
+    BOOST_CHECK( root.getSiblings().empty( ));
+
+    const livre::NodeIds& siblings = nodeId.getSiblings();
+    BOOST_CHECK_EQUAL( siblings.size(), 8u );
+    BOOST_CHECK( std::find( siblings.begin(), siblings.end(), nodeId ) !=
+                 siblings.end( ));
+}
+
+BOOST_AUTO_TEST_CASE( mortonOrder )
+{
+    const livre::NodeId root( 0, livre::Vector3ui( 0u ));
+    BOOST_CHECK_EQUAL( root.getMortonCode(), 0u );
+    BOOST_CHECK_EQUAL( livre::NodeId( 1, livre::Vector3ui( 1, 0, 0 )).getMortonCode(), 4u );
+    BOOST_CHECK_EQUAL( livre::NodeId( 1, livre::Vector3ui( 0, 1, 0 )).getMortonCode(), 2u );
+    BOOST_CHECK_EQUAL( livre::NodeId( 1, livre::Vector3ui( 0, 0, 1 )).getMortonCode(), 1u );
+    BOOST_CHECK_EQUAL( livre::NodeId( 2, livre::Vector3ui( 3 )).getMortonCode(), 63u );
+
+    // The depth first order of the tree is the Z-order
+    livre::NodeIds depthFirst;
+    std::function< void( const livre::NodeId& ) > collect =
+        [&]( const livre::NodeId& nodeId )
+        {
+            depthFirst.push_back( nodeId );
+            if( nodeId.getLevel() < 3 )
+                for( const livre::NodeId& child: nodeId.getChildRange( ))
+                    collect( child );
+        };
+    collect( root );
+
+    livre::NodeIds sorted( depthFirst.rbegin(), depthFirst.rend( ));
+    livre::sortMorton( sorted );
+    BOOST_CHECK( sorted == depthFirst );
+
+    for( size_t i = 1; i < depthFirst.size(); ++i )
+    {
+        BOOST_CHECK( livre::mortonLess( depthFirst[ i - 1 ], depthFirst[ i ] ));
+        BOOST_CHECK( !livre::mortonLess( depthFirst[ i ], depthFirst[ i - 1 ] ));
+    }
+}
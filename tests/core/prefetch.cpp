@@ -0,0 +1,144 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE Prefetch
+
+#include <livre/core/cache/PrefetchStatistics.h>
+#include <livre/core/data/NodeId.h>
+#include <livre/core/render/Frustum.h>
+#include <livre/core/render/FrustumPredictor.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+
+namespace
+{
+const float projArray[] = { 2.0, 0, 0, 0,
+                            0, 2.0, 0, 0,
+                            0, 0, -1.01342285, -1,
+                            0, 0, -0.201342285, 0 };
+
+/** @return a frustum orbiting around the volume at the given angle */
+livre::Frustum createFrustum( const float angle, const float distance = 2.0f )
+{
+    const float c = std::cos( angle );
+    const float s = std::sin( angle );
+    const float mvArray[] = { c, 0, -s, 0,
+                              0, 1, 0, 0,
+                              s, 0, c, 0,
+                              0, 0, -distance, 1 };
+
+    return livre::Frustum( livre::Matrix4f( mvArray, mvArray + 16 ),
+                           livre::Matrix4f( projArray, projArray + 16 ));
+}
+
+bool equals( const livre::Frustum& a, const livre::Frustum& b )
+{
+    return a.getMVMatrix().equals( b.getMVMatrix(), 1e-4f ) &&
+           a.getProjMatrix().equals( b.getProjMatrix(), 1e-4f );
+}
+}
+
+BOOST_AUTO_TEST_CASE( testPredictSteadyOrbit )
+{
+    livre::FrustumPredictor predictor;
+    for( size_t i = 0; i < 3; ++i )
+    {
+        BOOST_CHECK( !predictor.isPredictable( ));
+        predictor.update( createFrustum( 0.05f * i ));
+    }
+    BOOST_CHECK( predictor.isPredictable( ));
+    BOOST_CHECK( equals( predictor.predict( 5 ), createFrustum( 0.05f * 7 )));
+    BOOST_CHECK( equals( predictor.predict( 0 ), createFrustum( 0.1f )));
+}
+
+BOOST_AUTO_TEST_CASE( testPredictSteadyZoom )
+{
+    livre::FrustumPredictor predictor;
+    for( size_t i = 0; i < 4; ++i )
+        predictor.update( createFrustum( 0.3f, 3.0f - 0.1f * i ));
+
+    BOOST_CHECK( predictor.isPredictable( ));
+    BOOST_CHECK( equals( predictor.predict( 4 ), createFrustum( 0.3f, 2.3f )));
+}
+
+BOOST_AUTO_TEST_CASE( testPredictIgnoresRedraws )
+{
+    livre::FrustumPredictor predictor;
+    for( size_t i = 0; i < 3; ++i )
+    {
+        predictor.update( createFrustum( 0.05f * i ));
+        predictor.update( createFrustum( 0.05f * i ));
+    }
+    BOOST_CHECK( predictor.isPredictable( ));
+    BOOST_CHECK( equals( predictor.predict( 2 ), createFrustum( 0.2f )));
+}
+
+BOOST_AUTO_TEST_CASE( testPredictChangingMotion )
+{
+    livre::FrustumPredictor predictor;
+    predictor.update( createFrustum( 0.0f ));
+    predictor.update( createFrustum( 0.05f ));
+    predictor.update( createFrustum( 0.3f ));
+    BOOST_CHECK( !predictor.isPredictable( ));
+    BOOST_CHECK( equals( predictor.predict( 5 ), createFrustum( 0.3f )));
+
+    // The new motion is predicted once it is steady
+    predictor.update( createFrustum( 0.55f ));
+    BOOST_CHECK( predictor.isPredictable( ));
+    BOOST_CHECK( equals( predictor.predict( 1 ), createFrustum( 0.8f )));
+
+    predictor.clear();
+    BOOST_CHECK( !predictor.isPredictable( ));
+    BOOST_CHECK_THROW( predictor.predict( 1 ), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( testPrefetchStatistics )
+{
+    const livre::NodeId first( 1, livre::Vector3ui( 0, 0, 0 ));
+    const livre::NodeId second( 1, livre::Vector3ui( 1, 0, 0 ));
+    const livre::NodeId third( 1, livre::Vector3ui( 0, 1, 0 ));
+
+    livre::PrefetchStatistics statistics( 2 );
+    BOOST_CHECK_EQUAL( statistics.getAccuracy(), 0.f );
+
+    statistics.notifyPrefetched( first, 100 );
+    statistics.notifyPrefetched( second, 200 );
+    statistics.notifyPrefetched( third, 400 );
+    statistics.notifyPrefetched( third, 400 );
+    BOOST_CHECK_EQUAL( statistics.getPrefetchedCount(), 3u );
+
+    statistics.notifyFrame( { first } );
+    statistics.notifyFrame( {} );
+    BOOST_CHECK_EQUAL( statistics.getHitCount(), 1u );
+    BOOST_CHECK_EQUAL( statistics.getWastedCount(), 0u );
+    BOOST_CHECK_EQUAL( statistics.getAccuracy(), 1.f );
+
+    statistics.notifyFrame( { second } );
+    statistics.notifyFrame( { first } );
+    BOOST_CHECK_EQUAL( statistics.getHitCount(), 2u );
+    BOOST_CHECK_EQUAL( statistics.getWastedCount(), 1u );
+    BOOST_CHECK_EQUAL( statistics.getWastedBytes(), 400u );
+    BOOST_CHECK_CLOSE( statistics.getAccuracy(), 2.f / 3.f, 1e-4f );
+
+    statistics.clear();
+    BOOST_CHECK_EQUAL( statistics.getPrefetchedCount(), 0u );
+    BOOST_CHECK_EQUAL( statistics.getWastedBytes(), 0u );
+}
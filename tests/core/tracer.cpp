@@ -0,0 +1,85 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE LibCore
+
+#include <livre/core/util/Tracer.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <thread>
+
+BOOST_AUTO_TEST_CASE( testTracerDisabled )
+{
+    livre::Tracer::stop();
+    {
+        const livre::Tracer::Scope trace( "test", "Disabled" );
+    }
+
+    std::ostringstream os;
+    livre::Tracer::writeChromeTrace( os );
+    BOOST_CHECK( os.str().find( "Disabled" ) == std::string::npos );
+}
+
+BOOST_AUTO_TEST_CASE( testTracerFrames )
+{
+    livre::Tracer::start( 2 );
+    BOOST_CHECK( livre::Tracer::isEnabled( ));
+
+    {
+        const livre::Tracer::Scope trace( "test", "MainThread" );
+    }
+    std::thread thread( []
+    {
+        livre::Tracer::setQueueWait( 42.0 );
+        const livre::Tracer::Scope trace( "test", "OtherThread" );
+    });
+    thread.join();
+
+    BOOST_CHECK( !livre::Tracer::frame( ));
+    BOOST_CHECK( livre::Tracer::frame( ));
+    BOOST_CHECK( !livre::Tracer::isEnabled( ));
+    BOOST_CHECK( !livre::Tracer::frame( ));
+
+    std::ostringstream os;
+    livre::Tracer::writeChromeTrace( os );
+    const std::string& trace = os.str();
+    BOOST_CHECK_EQUAL( trace.find( "{\"traceEvents\":[" ), 0 );
+    BOOST_CHECK( trace.find( "\"name\":\"MainThread\"" ) != std::string::npos );
+    BOOST_CHECK( trace.find( "\"name\":\"OtherThread\"" ) != std::string::npos );
+    BOOST_CHECK( trace.find( "\"queueWait\":42.000" ) != std::string::npos );
+}
+
+BOOST_AUTO_TEST_CASE( testTracerRingBuffer )
+{
+    livre::Tracer::start( 1 );
+    const size_t nEvents = livre::Tracer::bufferSize + 10;
+    for( size_t i = 0; i < nEvents; ++i )
+        livre::Tracer::record( "test", "Event" + std::to_string( i ), 0.0, 1.0, 0.0 );
+    livre::Tracer::stop();
+
+    std::ostringstream os;
+    livre::Tracer::writeChromeTrace( os );
+    const std::string& trace = os.str();
+    BOOST_CHECK( trace.find( "\"name\":\"Event9\"" ) == std::string::npos );
+    BOOST_CHECK( trace.find( "\"name\":\"Event10\"" ) != std::string::npos );
+    BOOST_CHECK( trace.find( "\"name\":\"Event" + std::to_string( nEvents - 1 ) + "\"" )
+                 != std::string::npos );
+}
@@ -44,6 +44,7 @@ BOOST_AUTO_TEST_CASE( defaultVolumeInformation )
     BOOST_CHECK_EQUAL( volume.bigEndian, false );
     BOOST_CHECK_EQUAL( volume.compCount, 1u );
     BOOST_CHECK_EQUAL( volume.dataType, livre::DT_UINT8 );
+    BOOST_CHECK( volume.dataRange[ 0 ] > volume.dataRange[ 1 ] );
     BOOST_CHECK_EQUAL( volume.overlap, livre::Vector3ui( 0u ));
     BOOST_CHECK_EQUAL( volume.maximumBlockSize, livre::Vector3ui( 0u ));
     BOOST_CHECK_EQUAL( volume.voxels, livre::Vector3ui( 256u ));
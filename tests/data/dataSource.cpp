@@ -27,6 +27,8 @@
 #include <livre/core/data/MemoryUnit.h>
 #include <livre/core/data/VolumeInformation.h>
 
+#include <cmath>
+
 namespace
 {
 const uint32_t BLOCK_SIZE = 32;
@@ -78,3 +80,54 @@ BOOST_AUTO_TEST_CASE( memoryDataSource )
 
     _testDataSource( volumeName.str( ));
 }
+
+BOOST_AUTO_TEST_CASE( quantizedDataSource )
+{
+    std::stringstream volumeName;
+    volumeName << "mem:///?datatype=float#" << VOXEL_SIZE_X << ","
+               << VOXEL_SIZE_Y << "," << VOXEL_SIZE_Z << "," << BLOCK_SIZE;
+    const lunchbox::URI uri( volumeName.str( ));
+
+    const livre::DataSource source( uri );
+    livre::DataSource quantizedSource( uri );
+    const livre::VolumeInformation& info = source.getVolumeInfo();
+    BOOST_CHECK_EQUAL( info.dataType, livre::DT_FLOAT );
+    BOOST_CHECK( info.dataRange[ 0 ] < info.dataRange[ 1 ] );
+
+    BOOST_CHECK_THROW( quantizedSource.setQuantization( livre::DT_INT16 ),
+                       std::runtime_error );
+    quantizedSource.setQuantization( livre::DT_UINT8 );
+    BOOST_CHECK( quantizedSource.isQuantized( ));
+    BOOST_CHECK( !source.isQuantized( ));
+    const livre::VolumeInformation& quantizedInfo =
+        quantizedSource.getVolumeInfo();
+    BOOST_CHECK_EQUAL( quantizedInfo.dataType, livre::DT_UINT8 );
+    BOOST_CHECK_EQUAL( quantizedInfo.getBytesPerVoxel(), 1 );
+    BOOST_CHECK_EQUAL( quantizedInfo.dataRange, livre::Vector2f( 0, 255 ));
+    BOOST_CHECK_EQUAL( quantizedInfo.voxels, info.voxels );
+
+    const livre::NodeId nodeId =
+        livre::NodeId( 0, livre::Vector3f( 0, 0, 0 ), 0 ).getChildren().front();
+    const livre::LODNode& lodNode = source.getNode( nodeId );
+    const size_t nVoxels = ( lodNode.getBlockSize() +
+                             livre::Vector3ui( info.overlap ) * 2 ).product();
+
+    const livre::ConstMemoryUnitPtr data = source.getData( nodeId );
+    const livre::ConstMemoryUnitPtr quantizedData =
+        quantizedSource.getData( nodeId );
+    BOOST_CHECK_EQUAL( data->getMemSize(), nVoxels * sizeof( float ));
+    BOOST_CHECK_EQUAL( quantizedData->getMemSize(), nVoxels );
+
+    const float* values = data->getData< float >();
+    const uint8_t* quantizedValues = quantizedData->getData< uint8_t >();
+    const float scale = 255.f / ( info.dataRange[ 1 ] - info.dataRange[ 0 ] );
+    for( size_t i = 0; i < nVoxels; ++i )
+    {
+        const float expected = ( values[ i ] - info.dataRange[ 0 ] ) * scale;
+        BOOST_REQUIRE_LE( std::abs( quantizedValues[ i ] - expected ), 0.5f );
+    }
+
+    quantizedSource.setQuantization( livre::DT_UNDEFINED );
+    BOOST_CHECK_EQUAL( quantizedSource.getVolumeInfo().dataType,
+                       livre::DT_FLOAT );
+}
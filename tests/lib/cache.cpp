@@ -30,15 +30,88 @@
 #include <livre/core/data/MemoryUnit.h>
 #include <livre/core/data/VolumeInformation.h>
 
+#include <lunchbox/pluginRegisterer.h>
+
 #define BOOST_TEST_MODULE Cache
 #include <boost/test/unit_test.hpp>
 
+#include <cmath>
+#include <limits>
+
 
 const uint32_t BLOCK_SIZE = 32;
 const uint32_t VOXEL_SIZE_X = 1024;
 const uint32_t VOXEL_SIZE_Y = 1024;
 const uint32_t VOXEL_SIZE_Z = 512;
 
+namespace
+{
+// Rows of 5 voxels are binned by both the vectorized loop and the scalar tail
+const uint32_t SPECIAL_VOLUME_SIZE = 5;
+
+/**
+ * A float volume of values in [0, 3] with special values in the first and the
+ * last voxel of the rows. Parses URIs in the form special://#[nan,inf]
+ */
+class SpecialValuesDataSource : public livre::DataSourcePlugin
+{
+public:
+    explicit SpecialValuesDataSource( const livre::DataSourcePluginData& initData )
+        : _infinite( initData.getURI().getFragment() == "inf" )
+    {
+        _volumeInfo.voxels = livre::Vector3ui( SPECIAL_VOLUME_SIZE );
+        _volumeInfo.overlap = livre::Vector3ui( 0u );
+        _volumeInfo.maximumBlockSize = _volumeInfo.voxels;
+        _volumeInfo.dataType = livre::DT_FLOAT;
+        _volumeInfo.frameRange = livre::FULL_FRAME_RANGE;
+        livre::fillRegularVolumeInfo( _volumeInfo );
+    }
+
+    static float getValue( const size_t index, const bool infinite )
+    {
+        const float infinity = std::numeric_limits< float >::infinity();
+        if( index % 10 == 4 )
+            return infinite ? infinity : std::nanf( "" );
+        if( index % 10 == 5 )
+            return infinite ? -infinity : std::nanf( "" );
+        return float( index % 4 );
+    }
+
+    livre::MemoryUnitPtr getData( const livre::LODNode& node ) final
+    {
+        std::vector< float > values( node.getBlockSize().product( ));
+        for( size_t i = 0; i < values.size(); ++i )
+            values[ i ] = getValue( i, _infinite );
+        return livre::MemoryUnitPtr(
+                    new livre::AllocMemoryUnit( values.data(), values.size( )));
+    }
+
+    bool hasRegularTree() const final { return true; }
+
+    static bool handles( const livre::DataSourcePluginData& initData )
+    {
+        return initData.getURI().getScheme() == "special";
+    }
+
+private:
+    const bool _infinite;
+};
+
+lunchbox::PluginRegisterer< SpecialValuesDataSource > registerer;
+
+livre::Histogram binSpecialValues( const std::string& uri )
+{
+    livre::DataSource source( lunchbox::URI( uri ));
+    livre::CacheT< livre::DataObject > dataCache( "DataCache", LB_1MB );
+    const livre::NodeId rootId( 0, livre::Vector3ui( 0u ), 0 );
+    dataCache.load< livre::DataObject >( rootId.getId(), source );
+
+    const livre::HistogramObject histogram( rootId.getId(), dataCache, source,
+                                            livre::Vector2f( 0.f, 0.f ));
+    return histogram.getHistogram();
+}
+}
+
 BOOST_AUTO_TEST_CASE( testCache )
 {
     std::stringstream volumeName;
@@ -132,3 +205,68 @@ BOOST_AUTO_TEST_CASE( testCache )
     BOOST_CHECK_EQUAL( binAcc[ size_t( hist.getMaxIndex( )) ], 1u << 25 );
     BOOST_CHECK_EQUAL( hist.getSum(), 1u << 25 );
 }
+
+BOOST_AUTO_TEST_CASE( histogramPyramid )
+{
+    std::stringstream volumeName;
+    volumeName << "mem://#" << VOXEL_SIZE_X << "," << VOXEL_SIZE_Y << ","
+               << VOXEL_SIZE_Z << "," << BLOCK_SIZE;
+
+    livre::DataSource source( lunchbox::URI( volumeName.str( )));
+    livre::CacheT< livre::DataObject > dataCache( "DataCache", 1024 * LB_1MB );
+    livre::CacheT< livre::HistogramObject > histogramCache( "HistogramCache",
+                                                             LB_1MB );
+    const livre::Vector2f range( 0.0f, 255.f );
+
+    const livre::NodeId parentId( 1, livre::Vector3ui( 0u ), 0 );
+    livre::Histogram sum;
+    for( const livre::NodeId& childId: parentId.getChildRange( ))
+    {
+        dataCache.load< livre::DataObject >( childId.getId(), source );
+        sum += histogramCache.load< livre::HistogramObject >( childId.getId(),
+                   dataCache, source, range )->getHistogram();
+    }
+
+    dataCache.load< livre::DataObject >( parentId.getId(), source );
+    const livre::HistogramObject scanned( parentId.getId(), dataCache, source,
+                                          range );
+    const livre::HistogramObject derived( parentId.getId(), sum, true );
+    BOOST_CHECK( derived.isDerived( ));
+    BOOST_CHECK( !scanned.isDerived( ));
+
+    // The children cover the same voxels as their parent at a finer level
+    BOOST_CHECK_EQUAL( derived.getHistogram().getSum(),
+                       scanned.getHistogram().getSum( ));
+    BOOST_CHECK_EQUAL( derived.getHistogram().getRange(),
+                       scanned.getHistogram().getRange( ));
+    BOOST_CHECK_EQUAL( derived.getSize(), scanned.getSize( ));
+}
+
+BOOST_AUTO_TEST_CASE( histogramSpecialValues )
+{
+    const size_t nVoxels = SPECIAL_VOLUME_SIZE * SPECIAL_VOLUME_SIZE *
+                           SPECIAL_VOLUME_SIZE;
+
+    // NaNs are skipped by the range and go to the first bin
+    const livre::Histogram& histogram = binSpecialValues( "special://#nan" );
+    BOOST_CHECK_EQUAL( histogram.getRange(), livre::Vector2f( 0.f, 3.f ));
+    BOOST_CHECK_EQUAL( histogram.getSum(), nVoxels );
+
+    const size_t binCount = histogram.getBins().size();
+    const float scale = float( binCount ) / 3.f;
+    std::vector< uint64_t > expected( binCount, 0 );
+    for( size_t i = 0; i < nVoxels; ++i )
+    {
+        const float value = SpecialValuesDataSource::getValue( i, false );
+        const size_t bin = std::isnan( value ) ? 0 : size_t( value * scale );
+        ++expected[ std::min( bin, binCount - 1 )];
+    }
+    const uint64_t* bins = histogram.getBins().data();
+    BOOST_CHECK_EQUAL_COLLECTIONS( bins, bins + binCount,
+                                   expected.begin(), expected.end( ));
+
+    // An infinite range collapses all voxels into the first bin
+    const livre::Histogram& infinite = binSpecialValues( "special://#inf" );
+    BOOST_CHECK_EQUAL( infinite.getSum(), nVoxels );
+    BOOST_CHECK_EQUAL( infinite.getBins().data()[ 0 ], nVoxels );
+}
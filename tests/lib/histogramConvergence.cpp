@@ -0,0 +1,127 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE HistogramConvergence
+#include <boost/test/unit_test.hpp>
+
+#include <livre/lib/cache/DataObject.h>
+#include <livre/lib/cache/HistogramObject.h>
+#include <livre/lib/pipeline/HistogramFilter.h>
+
+#include <livre/core/cache/Cache.h>
+#include <livre/core/data/DataSource.h>
+#include <livre/core/data/Histogram.h>
+#include <livre/core/data/NodeId.h>
+#include <livre/core/pipeline/FutureMap.h>
+#include <livre/core/pipeline/PipeFilter.h>
+#include <livre/core/render/Frustum.h>
+
+namespace
+{
+const uint32_t VOLUME_SIZE = 256;
+const uint32_t BLOCK_SIZE = 32;
+
+livre::Histogram computeHistogram( livre::Cache& histogramCache,
+                                   const livre::Cache& dataCache,
+                                   const livre::DataSource& dataSource,
+                                   const livre::ConstCacheObjects& cacheObjects,
+                                   const livre::Vector2f& dataSourceRange )
+{
+    livre::PipeFilterT< livre::HistogramFilter > filter(
+        "HistogramFilter", histogramCache, dataCache, dataSource );
+
+    const livre::Matrix4f identity;
+    filter.getPromise( "Frustum" ).set( livre::Frustum( identity, identity ));
+    filter.getPromise( "RelativeViewport" ).set( livre::Viewport( 0.f, 0.f, 1.f, 1.f ));
+    filter.getPromise( "CacheObjects" ).set( cacheObjects );
+    filter.getPromise( "DataSourceRange" ).set( dataSourceRange );
+    filter.execute();
+
+    const livre::UniqueFutureMap outputs( filter.getPostconditions( ));
+    return outputs.get< livre::Histogram >( "Histogram" );
+}
+}
+
+BOOST_AUTO_TEST_CASE( rebin )
+{
+    livre::Histogram histogram;
+    histogram.setMin( 0.0f );
+    histogram.setMax( 10.0f );
+    histogram.resize( 10 );
+    for( size_t i = 0; i < 10; ++i )
+        histogram.getBins()[ i ] = 100 + i;
+
+    const livre::Histogram& same = histogram.rebin( livre::Vector2f( 0.f, 10.f ), 10 );
+    BOOST_CHECK( same.getBins() == histogram.getBins( ));
+
+    const livre::Histogram& wider = histogram.rebin( livre::Vector2f( -10.f, 10.f ), 10 );
+    BOOST_CHECK_EQUAL( wider.getRange(), livre::Vector2f( -10.f, 10.f ));
+    BOOST_CHECK_EQUAL( wider.getSum(), histogram.getSum( ));
+    BOOST_CHECK_EQUAL( wider.getBins()[ 4 ], 0 );
+    BOOST_CHECK_EQUAL( wider.getBins()[ 5 ], 201 );
+    BOOST_CHECK_EQUAL( wider.getBins()[ 9 ], 217 );
+
+    BOOST_CHECK( !histogram.isCompatible( wider ));
+    BOOST_CHECK_THROW( histogram += wider, std::runtime_error );
+    BOOST_CHECK( histogram.isCompatible( livre::Histogram( )));
+}
+
+BOOST_AUTO_TEST_CASE( floatRangeConvergence )
+{
+    std::stringstream volumeName;
+    volumeName << "mem:///?datatype=float#" << VOLUME_SIZE << "," << VOLUME_SIZE
+               << "," << VOLUME_SIZE << "," << BLOCK_SIZE;
+    livre::DataSource dataSource( lunchbox::URI( volumeName.str( )));
+
+    livre::CacheT< livre::DataObject > dataCache( "DataCache", 1024 * LB_1MB );
+    livre::CacheT< livre::HistogramObject > histogramCache( "HistogramCache",
+                                                             32 * LB_1MB );
+
+    const livre::NodeId root( 0, livre::Vector3ui( 0u ));
+    livre::ConstCacheObjects cacheObjects;
+    for( const livre::NodeId& nodeId: root.getChildrenAtLevel( 2 ))
+        cacheObjects.push_back( dataCache.load< livre::DataObject >( nodeId.getId(),
+                                                                     dataSource ));
+
+    const uint64_t nVoxels = uint64_t( VOLUME_SIZE ) * VOLUME_SIZE * VOLUME_SIZE;
+
+    // The bricks exceed the default uint8 range. All of them are counted
+    // nevertheless, with the range expanded in the same frame.
+    livre::Vector2f range( 0.0f, 255.0f );
+    const livre::Histogram& first = computeHistogram( histogramCache, dataCache,
+                                                      dataSource, cacheObjects,
+                                                      range );
+    BOOST_CHECK_GT( first.getMax(), 255.0f );
+    BOOST_CHECK_EQUAL( first.getSum(), nVoxels );
+    range = first.getRange();
+
+    // The range converged, the following frames reuse the cached histograms
+    // without touching the voxels again
+    dataCache.purge();
+
+    for( size_t frame = 0; frame < 3; ++frame )
+    {
+        const livre::Histogram& histogram =
+                computeHistogram( histogramCache, dataCache, dataSource,
+                                  cacheObjects, range );
+        BOOST_CHECK_EQUAL( histogram.getRange(), range );
+        BOOST_CHECK_EQUAL( histogram.getSum(), nVoxels );
+        BOOST_CHECK( histogram.getBins() == first.getBins( ));
+    }
+}
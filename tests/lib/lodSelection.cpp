@@ -22,6 +22,8 @@
 #include <livre/lib/data/MemoryDataSource.h>
 
 #include <livre/core/data/DataSource.h>
+#include <livre/core/render/LODCriterion.h>
+#include <livre/core/render/LODCut.h>
 #include <livre/core/render/SelectVisibles.h>
 #include <livre/core/visitor/DFSTraversal.h>
 #include <livre/core/render/Frustum.h>
@@ -31,17 +33,24 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <cmath>
+#include <limits>
+
 // Explicit registration required because the folder of the data source plugin is not
 // in the LD_LIBRARY_PATH of the test executable.
 lunchbox::PluginRegisterer< livre::MemoryDataSource > registerer;
 
 typedef std::vector< livre::Identifier > Identifiers;
 
+const uint32_t sequential = std::numeric_limits< uint32_t >::max();
+
 Identifiers getVisibles( const livre::DataSource& dataSource,
                          const uint32_t windowHeight,
                          const float screenSpaceError,
                          const uint32_t minLOD,
-                         const uint32_t maxLOD )
+                         const uint32_t maxLOD,
+                         const uint32_t taskLevel = sequential,
+                         const size_t nThreads = 4 )
 {
     const float projArray[] = { 2.0, 0, 0, 0,
                                 0, 2.0, 0, 0,
@@ -69,8 +78,12 @@ Identifiers getVisibles( const livre::DataSource& dataSource,
                                           planes );
 
     livre::DFSTraversal traverser;
-    traverser.traverse( dataSource.getVolumeInfo().rootNode,
-                        selectVisibles, 0 );
+    if( taskLevel == sequential )
+        traverser.traverse( dataSource.getVolumeInfo().rootNode,
+                            selectVisibles, 0 );
+    else
+        traverser.traverse( dataSource.getVolumeInfo().rootNode,
+                            selectVisibles, 0, taskLevel, nThreads );
 
 
     Identifiers visibles;
@@ -201,3 +214,171 @@ BOOST_AUTO_TEST_CASE( testLODSelection )
             BOOST_CHECK_EQUAL( livre::NodeId( visible ).getLevel(), maxMinLevel );
     }
 }
+
+BOOST_AUTO_TEST_CASE( testParallelLODSelection )
+{
+    const lunchbox::URI uri( "mem://#4096,4096,4096,256" );
+    livre::DataSource dataSource( uri );
+    const uint32_t depth = dataSource.getVolumeInfo().rootNode.getDepth();
+
+    for( const float screenSpaceError: { 1.0f, 2.0f, 8.0f })
+    {
+        const Identifiers& expected = getVisibles( dataSource, 512, screenSpaceError,
+                                                   0, 100 );
+
+        // Includes task levels below the tree and a single thread, which
+        // traverse sequentially
+        for( uint32_t taskLevel = 0; taskLevel <= depth; ++taskLevel )
+            for( const size_t nThreads: { 1, 4 })
+            {
+                const Identifiers& visibles = getVisibles( dataSource, 512,
+                                                           screenSpaceError, 0, 100,
+                                                           taskLevel, nThreads );
+                BOOST_CHECK_EQUAL_COLLECTIONS( expected.data(),
+                                               expected.data() + expected.size(),
+                                               visibles.data(),
+                                               visibles.data() + visibles.size( ));
+            }
+    }
+}
+
+namespace
+{
+const float incrementalProjArray[] = { 2.0, 0, 0, 0,
+                                       0, 2.0, 0, 0,
+                                       0, 0, -1.01342285, -1,
+                                       0, 0, -0.201342285, 0 };
+
+/** @return a frustum looking at the volume, rotated around y and moved */
+livre::Frustum createFrustum( const float angle, const float x, const float z,
+                              const float zoom = 1.0f )
+{
+    const float c = std::cos( angle );
+    const float s = std::sin( angle );
+    const float mvArray[] = { c, 0, -s, 0,
+                              0, 1, 0, 0,
+                              s, 0, c, 0,
+                              x, 0, z, 1 };
+
+    livre::Matrix4f projMat( incrementalProjArray, incrementalProjArray + 16 );
+    projMat( 0, 0 ) *= zoom;
+    projMat( 1, 1 ) *= zoom;
+    return livre::Frustum( livre::Matrix4f( mvArray, mvArray + 16 ), projMat );
+}
+
+Identifiers getIds( const livre::NodeIds& nodeIds )
+{
+    Identifiers ids;
+    for( const livre::NodeId& nodeId: nodeIds )
+        ids.push_back( nodeId.getId( ));
+    std::sort( ids.begin(), ids.end( ));
+    return ids;
+}
+
+Identifiers getVisibles( const livre::DataSource& dataSource,
+                         const livre::Frustum& frustum,
+                         const uint32_t timeStep )
+{
+    livre::SelectVisibles selectVisibles( dataSource, frustum, 512, 1.0f, 0, 100,
+                                          {{ 0.0f, 1.0f }}, livre::ClipPlanes( ));
+    livre::DFSTraversal traverser;
+    traverser.traverse( dataSource.getVolumeInfo().rootNode, selectVisibles,
+                        timeStep );
+    return getIds( selectVisibles.getVisibles( ));
+}
+
+Identifiers getVisibles( const livre::DataSource& dataSource,
+                         const livre::Frustum& frustum,
+                         const uint32_t timeStep,
+                         livre::LODCut& lodCut )
+{
+    const uint32_t depth = dataSource.getVolumeInfo().rootNode.getDepth();
+    const livre::LODCriterion criterion( frustum, 512, 1.0f, 0, 100, depth,
+                                         livre::ClipPlanes( ));
+    const livre::NodeIds& visibles = lodCut.update( criterion, timeStep );
+    BOOST_CHECK( std::is_sorted( visibles.begin(), visibles.end(),
+                                 livre::mortonLess ));
+    return getIds( visibles );
+}
+}
+
+BOOST_AUTO_TEST_CASE( testIncrementalLODSelection )
+{
+    const lunchbox::URI uri( "mem://#4096,4096,4096,256" );
+    livre::DataSource dataSource( uri );
+    livre::LODCut lodCut( dataSource );
+
+    // Turns, pans and moves towards the volume, so the cut is refined,
+    // coarsened and the frustum culls different nodes along the path
+    const size_t nSteps = 100;
+    for( size_t i = 0; i < nSteps; ++i )
+    {
+        const float t = float( i ) / nSteps;
+        const livre::Frustum& frustum =
+                createFrustum( 0.5f * std::sin( 6.0f * t ),
+                               0.2f * std::sin( 10.0f * t ), -1.0f + 0.6f * t );
+
+        const Identifiers& expected = getVisibles( dataSource, frustum, 0 );
+        const Identifiers& visibles = getVisibles( dataSource, frustum, 0, lodCut );
+        BOOST_CHECK_EQUAL_COLLECTIONS( expected.data(), expected.data() + expected.size(),
+                                       visibles.data(), visibles.data() + visibles.size( ));
+    }
+
+    // A still camera does not revisit the cut
+    const livre::Frustum& frustum = createFrustum( 0.2f, 0.1f, -0.8f );
+    const Identifiers& first = getVisibles( dataSource, frustum, 0, lodCut );
+    const Identifiers& second = getVisibles( dataSource, frustum, 0, lodCut );
+    BOOST_CHECK_EQUAL( lodCut.getEvaluations(), size_t( 0 ));
+    BOOST_CHECK( first == second );
+
+    // A new projection or time step traverses the tree again
+    for( const float zoom: { 1.0f, 2.0f })
+    {
+        for( const uint32_t timeStep: { 0u, 1u })
+        {
+            const livre::Frustum& zoomed = createFrustum( 0.2f, 0.1f, -0.8f, zoom );
+            const Identifiers& expected = getVisibles( dataSource, zoomed, timeStep );
+            const Identifiers& visibles = getVisibles( dataSource, zoomed, timeStep,
+                                                       lodCut );
+            BOOST_CHECK_EQUAL_COLLECTIONS( expected.data(),
+                                           expected.data() + expected.size(),
+                                           visibles.data(),
+                                           visibles.data() + visibles.size( ));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( testBudgetedLODSelection )
+{
+    const lunchbox::URI uri( "mem://#4096,4096,4096,256" );
+    livre::DataSource dataSource( uri );
+    const uint32_t depth = dataSource.getVolumeInfo().rootNode.getDepth();
+
+    const livre::Frustum& frustum = createFrustum( 0.2f, 0.1f, -0.8f );
+    const livre::LODCriterion criterion( frustum, 512, 1.0f, 0, 100, depth,
+                                         livre::ClipPlanes( ));
+
+    // Without a limit, the selection is the one of the screen space error
+    const Identifiers& expected = getVisibles( dataSource, frustum, 0 );
+    const Identifiers& unlimited = getIds( livre::selectBudgeted(
+                                               dataSource, criterion, 0,
+                                               std::numeric_limits< size_t >::max( )));
+    BOOST_CHECK_EQUAL_COLLECTIONS( expected.data(), expected.data() + expected.size(),
+                                   unlimited.data(), unlimited.data() + unlimited.size( ));
+
+    for( size_t maxNodes = 1; maxNodes < expected.size(); maxNodes *= 2 )
+    {
+        const livre::NodeIds& visibles = livre::selectBudgeted( dataSource, criterion,
+                                                                0, maxNodes );
+        BOOST_CHECK_LE( visibles.size(), maxNodes );
+        BOOST_CHECK( !visibles.empty( ));
+        BOOST_CHECK( std::is_sorted( visibles.begin(), visibles.end(),
+                                     livre::mortonLess ));
+
+        // A cut of the tree: no selected node contains another one
+        for( const livre::NodeId& nodeId: visibles )
+            for( const livre::NodeId& parentId: nodeId.getParentRange( ))
+                BOOST_CHECK( std::find( visibles.begin(), visibles.end(),
+                                        parentId ) == visibles.end( ));
+    }
+}
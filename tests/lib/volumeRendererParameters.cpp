@@ -22,6 +22,8 @@
 
 #include <livre/lib/configuration/VolumeRendererParameters.h>
 
+#include <thread>
+
 BOOST_AUTO_TEST_CASE(defaultValues)
 {
     const livre::VolumeRendererParameters params;
@@ -31,6 +33,16 @@ BOOST_AUTO_TEST_CASE(defaultValues)
     BOOST_CHECK( !params.getSynchronousMode( ));
     BOOST_CHECK_EQUAL( params.getSamplesPerRay(), 0 );
     BOOST_CHECK_EQUAL( params.getSamplesPerPixel(), 1 );
+    BOOST_CHECK_EQUAL( params.getQuantization(), 0 );
+    BOOST_CHECK_EQUAL( params.getRenderThreads(), 2 );
+    BOOST_CHECK_EQUAL( params.getComputeThreads(), 2 );
+    BOOST_CHECK_EQUAL( params.getUploadThreads(), 1 );
+    BOOST_CHECK( !params.getAutoTuneThreads( ));
+    BOOST_CHECK( !params.getBudgetedLOD( ));
+    BOOST_CHECK_EQUAL( params.getPrefetchFrames(), 0 );
+    BOOST_CHECK( !params.getPrefetchTextures( ));
+    BOOST_CHECK_EQUAL( params.getUploadBufferMemoryMB(), 64u );
+    BOOST_CHECK( !params.getTextureAtlas( ));
 
 #ifdef __i386__
     BOOST_CHECK_EQUAL( params.getSSE(), 8.0f );
@@ -66,7 +78,12 @@ BOOST_AUTO_TEST_CASE(initFromArgv)
                            "--cpu-cache-mem", "54321",
                            "--min-lod", "2", "--max-lod", "6",
                            "--samples-per-ray", "42",
-                           "--samples-per-pixel", "4" };
+                           "--samples-per-pixel", "4",
+                           "--quantization", "16",
+                           "--upload-threads", "6", "--auto-tune-threads",
+                           "--budgeted-lod",
+                           "--prefetch-frames", "5", "--prefetch-textures",
+                           "--upload-buffer-mem", "16", "--texture-atlas" };
     const int argc = sizeof(argv)/sizeof(char*);
 
     livre::VolumeRendererParameters params;
@@ -77,7 +94,37 @@ BOOST_AUTO_TEST_CASE(initFromArgv)
     BOOST_CHECK( params.getSynchronousMode( ));
     BOOST_CHECK_EQUAL( params.getSamplesPerRay(), 42 );
     BOOST_CHECK_EQUAL( params.getSamplesPerPixel(), 4 );
+    BOOST_CHECK_EQUAL( params.getQuantization(), 16 );
+    BOOST_CHECK_EQUAL( params.getUploadThreads(), 6 );
+    BOOST_CHECK( params.getAutoTuneThreads( ));
+    BOOST_CHECK( params.getBudgetedLOD( ));
+    BOOST_CHECK_EQUAL( params.getPrefetchFrames(), 5 );
+    BOOST_CHECK( params.getPrefetchTextures( ));
+    BOOST_CHECK_EQUAL( params.getUploadBufferMemoryMB(), 16u );
+    BOOST_CHECK( params.getTextureAtlas( ));
     BOOST_CHECK_EQUAL( params.getSSE(), 1.4f );
     BOOST_CHECK_EQUAL( params.getMaxGPUCacheMemoryMB(), 12345u );
     BOOST_CHECK_EQUAL( params.getMaxCPUCacheMemoryMB(), 54321u );
 }
+
+BOOST_AUTO_TEST_CASE(threadBudget)
+{
+    const size_t nCores = std::thread::hardware_concurrency();
+
+    livre::VolumeRendererParameters params;
+    params.setRenderThreads( 1 );
+    params.setComputeThreads( 1 );
+    params.setUploadThreads( 1 );
+    BOOST_CHECK_EQUAL( params.getMaxUploadThreads(), 1 );
+    BOOST_CHECK_EQUAL( params.getFreeCores(), nCores > 3 ? nCores - 3 : 0 );
+
+    // Tuned upload threads may use all the cores left
+    params.setAutoTuneThreads( true );
+    BOOST_CHECK_EQUAL( params.getMaxUploadThreads(),
+                       std::max< size_t >( nCores > 2 ? nCores - 2 : 1, 1 ));
+    BOOST_CHECK_EQUAL( params.getFreeCores(), 0 );
+
+    params.setAutoTuneThreads( false );
+    params.setUploadThreads( uint32_t( nCores ));
+    BOOST_CHECK_EQUAL( params.getFreeCores(), 0 );
+}
@@ -0,0 +1,158 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#define BOOST_TEST_MODULE BoxCulling
+#include <boost/test/unit_test.hpp>
+
+#include <livre/core/render/BoxCuller.h>
+#include <livre/core/render/ClipPlanes.h>
+#include <livre/core/render/Frustum.h>
+
+#include <lunchbox/clock.h>
+
+#include <bitset>
+#include <cmath>
+#include <random>
+
+namespace
+{
+const size_t nParents = 1 << 17;
+const size_t nRepetitions = 10;
+
+livre::Frustum createFrustum()
+{
+    const float projArray[] = { 2.0, 0, 0, 0,
+                                0, 2.0, 0, 0,
+                                0, 0, -1.01342285, -1,
+                                0, 0, -0.201342285, 0 };
+
+    const float mvArray[] = { 1, 0, 0, 0,
+                              0, 1, 0, 0,
+                              0, 0, 1, 0,
+                              0, 0, -1.0, 1 };
+
+    return livre::Frustum( livre::Matrix4f( mvArray, mvArray + 16 ),
+                           livre::Matrix4f( projArray, projArray + 16 ));
+}
+
+/** @return the normalized frustum planes, the inner side being positive */
+std::vector< livre::Plane > getFrustumPlanes( const livre::Frustum& frustum )
+{
+    std::vector< livre::Plane > planes( 6 );
+    const livre::Matrix4f& mvp = frustum.getMVPMatrix();
+    for( size_t i = 0; i < 6; ++i )
+    {
+        const float sign = ( i % 2 == 0 ) ? 1.f : -1.f;
+        for( size_t j = 0; j < 4; ++j )
+            planes[ i ][ j ] = mvp( 3, j ) + sign * mvp( i / 2, j );
+        planes[ i ] /= std::sqrt( planes[ i ][ 0 ] * planes[ i ][ 0 ] +
+                                  planes[ i ][ 1 ] * planes[ i ][ 1 ] +
+                                  planes[ i ][ 2 ] * planes[ i ][ 2 ]);
+    }
+    return planes;
+}
+
+/** @return the children boxes of random parents, 8 per parent */
+std::vector< livre::Boxf > createBoxes()
+{
+    std::mt19937 random( 42 );
+    std::uniform_real_distribution< float > position( -1.0f, 1.0f );
+    std::uniform_real_distribution< float > size( 0.01f, 0.2f );
+
+    std::vector< livre::Boxf > boxes;
+    for( size_t i = 0; i < nParents; ++i )
+    {
+        const livre::Vector3f origin( position( random ), position( random ),
+                                      position( random ));
+        const float childSize = size( random );
+        for( size_t j = 0; j < 8; ++j )
+        {
+            const livre::Vector3f min = origin +
+                    livre::Vector3f( float(( j >> 2 ) & 1u ), float(( j >> 1 ) & 1u ),
+                                     float( j & 1u )) * childSize;
+            boxes.push_back( livre::Boxf( min, min + livre::Vector3f( childSize )));
+        }
+    }
+    return boxes;
+}
+}
+
+BOOST_AUTO_TEST_CASE( boxCulling )
+{
+    const livre::Frustum frustum = createFrustum();
+    const livre::ClipPlanes clipPlanes;
+
+    const std::vector< livre::Boxf >& boxes = createBoxes();
+    const livre::BoxCuller frustumCuller( getFrustumPlanes( frustum ));
+
+    std::vector< livre::Plane > planes;
+    for( const auto& plane: clipPlanes.getPlanes( ))
+    {
+        const float* normal = plane.getNormal();
+        planes.push_back( livre::Plane( normal[ 0 ], normal[ 1 ], normal[ 2 ],
+                                        plane.getD( )));
+    }
+    const livre::BoxCuller clipCuller( planes );
+
+    size_t nCulled = 0;
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < nRepetitions; ++i )
+    {
+        for( const livre::Boxf& box: boxes )
+            if( !frustum.isInFrustum( box ) || clipPlanes.isClipped( box ))
+                ++nCulled;
+    }
+    std::cout << "per box, vmml: " << clock.resetTimef() * 1e6f /
+                                     ( nRepetitions * boxes.size( ))
+              << " ns per box, " << nCulled / nRepetitions << " culled" << std::endl;
+
+    size_t nCulledBoxes = 0;
+    for( size_t i = 0; i < nRepetitions; ++i )
+    {
+        for( const livre::Boxf& box: boxes )
+            if( frustumCuller.isCulled( box ) || clipCuller.isCulled( box ))
+                ++nCulledBoxes;
+    }
+    std::cout << "per box, culler: " << clock.resetTimef() * 1e6f /
+                                       ( nRepetitions * boxes.size( ))
+              << " ns per box, " << nCulledBoxes / nRepetitions << " culled"
+              << std::endl;
+
+    size_t nCulledBatches = 0;
+    livre::BoxBatch batch;
+    for( size_t i = 0; i < nRepetitions; ++i )
+    {
+        for( size_t j = 0; j < boxes.size(); j += livre::BoxBatch::maxSize )
+        {
+            batch.clear();
+            for( size_t k = j; k < j + livre::BoxBatch::maxSize; ++k )
+                batch.add( boxes[ k ]);
+
+            const uint32_t culled = frustumCuller.cull( batch ) |
+                                    clipCuller.cull( batch );
+            nCulledBatches += std::bitset< 32 >( culled ).count();
+        }
+    }
+    std::cout << "batches of " << livre::BoxBatch::maxSize << ", culler: "
+              << clock.resetTimef() * 1e6f / ( nRepetitions * boxes.size( ))
+              << " ns per box, " << nCulledBatches / nRepetitions << " culled"
+              << std::endl;
+
+    BOOST_CHECK_EQUAL( nCulledBatches, nCulledBoxes );
+    BOOST_CHECK_GT( nCulledBoxes, 0 );
+}
@@ -0,0 +1,241 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE BrickOrdering
+#include <boost/test/unit_test.hpp>
+
+#include <livre/lib/data/MemoryDataSource.h>
+
+#include <livre/core/data/DataSource.h>
+#include <livre/core/data/DataSourcePlugin.h>
+#include <livre/core/data/LODNode.h>
+#include <livre/core/data/NodeId.h>
+#include <livre/core/data/VolumeInformation.h>
+#include <livre/core/render/BrickOrder.h>
+#include <livre/core/render/Frustum.h>
+
+#include <lunchbox/clock.h>
+#include <lunchbox/pluginRegisterer.h>
+
+#include <algorithm>
+
+namespace
+{
+const size_t nIterations = 10;
+
+// Two root blocks along x, a tree of depth 6
+const char* const regularURI = "mem://#2048,1024,1024,32";
+const char* const irregularURI = "irregular://#2048,1024,1024,32";
+
+/** The same tree as the memory data source, without the regular tree lookups */
+class IrregularDataSource : public livre::DataSourcePlugin
+{
+public:
+    explicit IrregularDataSource( const livre::DataSourcePluginData& )
+    {
+        _volumeInfo.voxels = livre::Vector3ui( 2048, 1024, 1024 );
+        _volumeInfo.maximumBlockSize = livre::Vector3ui( 32 );
+        _volumeInfo.overlap = livre::Vector3ui( 4 );
+        livre::fillRegularVolumeInfo( _volumeInfo );
+    }
+
+    livre::MemoryUnitPtr getData( const livre::LODNode& ) final
+    {
+        return livre::MemoryUnitPtr();
+    }
+
+    static bool handles( const livre::DataSourcePluginData& initData )
+    {
+        return initData.getURI().getScheme() == "irregular";
+    }
+};
+
+// Explicit registration required because the folder of the data source plugin is not
+// in the LD_LIBRARY_PATH of the test executable.
+lunchbox::PluginRegisterer< livre::MemoryDataSource > memoryRegisterer;
+lunchbox::PluginRegisterer< IrregularDataSource > irregularRegisterer;
+
+livre::Frustum createFrustum( const livre::Vector3f& eye )
+{
+    const float projArray[] = { 2.0, 0, 0, 0,
+                                0, 2.0, 0, 0,
+                                0, 0, -1.01342285, -1,
+                                0, 0, -0.201342285, 0 };
+
+    const float mvArray[] = { 1, 0, 0, 0,
+                              0, 1, 0, 0,
+                              0, 0, 1, 0,
+                              -eye[0], -eye[1], -eye[2], 1 };
+
+    return livre::Frustum( livre::Matrix4f( mvArray, mvArray + 16 ),
+                           livre::Matrix4f( projArray, projArray + 16 ));
+}
+
+/** The nodes of the first root at one level and the second root one below */
+livre::NodeIds createBricks( const uint32_t level )
+{
+    const livre::NodeIds& first =
+            livre::NodeId( 0, livre::Vector3ui( 0, 0, 0 )).getChildrenAtLevel( level );
+    const livre::NodeIds& second =
+            livre::NodeId( 0, livre::Vector3ui( 1, 0, 0 )).getChildrenAtLevel( level + 1 );
+
+    livre::NodeIds bricks( first );
+    bricks.insert( bricks.end(), second.begin(), second.end( ));
+    std::reverse( bricks.begin(), bricks.end( ));
+    return bricks;
+}
+
+/** Sorts with lookups of the nodes in each comparison, as used before. */
+livre::NodeIds sortWithLookups( const livre::DataSource& dataSource,
+                                const livre::NodeIds& bricks,
+                                const livre::Frustum& frustum )
+{
+    livre::NodeIds sorted = bricks;
+    std::sort( sorted.begin(), sorted.end(),
+               [&]( const livre::NodeId& rb1, const livre::NodeId& rb2 )
+    {
+        const livre::LODNode& lodNode1 = dataSource.getNode( rb1 );
+        const livre::LODNode& lodNode2 = dataSource.getNode( rb2 );
+        return ( frustum.getMVMatrix() * lodNode1.getWorldBox().getCenter( )).length() <
+               ( frustum.getMVMatrix() * lodNode2.getWorldBox().getCenter( )).length();
+    });
+    return sorted;
+}
+
+/**
+ * @return the number of bricks ordered after a brick they share a face with
+ * and are in front of.
+ */
+size_t countOcclusions( const livre::DataSource& dataSource,
+                        const livre::NodeIds& ordered, const livre::Vector3f& eye )
+{
+    std::vector< livre::Boxf > boxes;
+    for( const livre::NodeId& brick: ordered )
+        boxes.push_back( dataSource.getNode( brick ).getWorldBox( ));
+
+    size_t nOcclusions = 0;
+    for( size_t i = 0; i < boxes.size(); ++i )
+    {
+        for( size_t j = i + 1; j < boxes.size(); ++j )
+        {
+            const livre::Boxf& first = boxes[ i ];
+            const livre::Boxf& later = boxes[ j ];
+            for( size_t axis = 0; axis < 3; ++axis )
+            {
+                bool overlaps = true;
+                for( size_t k = 0; k < 3; ++k )
+                {
+                    if( k != axis )
+                        overlaps = overlaps &&
+                                   first.getMin()[ k ] < later.getMax()[ k ] &&
+                                   later.getMin()[ k ] < first.getMax()[ k ];
+                }
+                if( !overlaps )
+                    continue;
+
+                if( later.getMax()[ axis ] == first.getMin()[ axis ] &&
+                    eye[ axis ] < first.getMin()[ axis ] )
+                {
+                    ++nOcclusions;
+                }
+                if( later.getMin()[ axis ] == first.getMax()[ axis ] &&
+                    eye[ axis ] > first.getMax()[ axis ] )
+                {
+                    ++nOcclusions;
+                }
+            }
+        }
+    }
+    return nOcclusions;
+}
+
+template< class OrderT >
+float benchmark( const std::string& name, const livre::NodeIds& bricks,
+                 const OrderT& order )
+{
+    const livre::Frustum frustum = createFrustum( livre::Vector3f( .3f, .2f, 1.5f ));
+    livre::NodeIds ordered;
+
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < nIterations; ++i )
+        ordered = order( bricks, frustum );
+    const float time = clock.getTimef() / nIterations;
+
+    BOOST_CHECK_EQUAL( ordered.size(), bricks.size( ));
+    std::cout << name << ": " << time << " ms for " << bricks.size()
+              << " bricks" << std::endl;
+    return time;
+}
+}
+
+BOOST_AUTO_TEST_CASE( frontToBack )
+{
+    const livre::DataSource regular( lunchbox::URI( regularURI ));
+    const livre::DataSource irregular( lunchbox::URI( irregularURI ));
+    BOOST_CHECK( regular.hasRegularTree( ));
+    BOOST_CHECK( !irregular.hasRegularTree( ));
+
+    const livre::NodeIds& bricks = createBricks( 2 );
+    const livre::Vector3f eyes[] = { livre::Vector3f( .3f, .2f, 1.5f ),
+                                     livre::Vector3f( -2.f, 0.f, 0.f ),
+                                     livre::Vector3f( .1f, -.05f, .2f ),
+                                     livre::Vector3f( -.6f, .8f, -.3f ) };
+    for( const livre::Vector3f& eye: eyes )
+    {
+        const livre::NodeIds& ordered =
+                livre::orderFrontToBack( regular, bricks, createFrustum( eye ));
+
+        livre::NodeIds expected = bricks;
+        livre::NodeIds actual = ordered;
+        std::sort( expected.begin(), expected.end( ));
+        std::sort( actual.begin(), actual.end( ));
+        BOOST_CHECK( actual == expected );
+        BOOST_CHECK_EQUAL( countOcclusions( regular, ordered, eye ), 0u );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( orderingTime )
+{
+    const livre::DataSource regular( lunchbox::URI( regularURI ));
+    const livre::DataSource irregular( lunchbox::URI( irregularURI ));
+    const livre::NodeIds& bricks = createBricks( 4 );
+
+    livre::NodeIds mortonBricks = bricks;
+    livre::sortMorton( mortonBricks );
+
+    for( const livre::DataSource* dataSource: { &regular, &irregular })
+    {
+        const std::string& tree = dataSource->hasRegularTree() ? "regular tree"
+                                                               : "irregular tree";
+        benchmark( "Sort with lookups, " + tree, bricks,
+                   [dataSource]( const livre::NodeIds& nodeIds,
+                                 const livre::Frustum& frustum )
+                       { return sortWithLookups( *dataSource, nodeIds, frustum ); });
+        benchmark( "Front to back, " + tree, bricks,
+                   [dataSource]( const livre::NodeIds& nodeIds,
+                                 const livre::Frustum& frustum )
+                       { return livre::orderFrontToBack( *dataSource, nodeIds,
+                                                         frustum ); });
+    }
+    benchmark( "Front to back of Morton ordered bricks, regular tree",
+               mortonBricks,
+               [&regular]( const livre::NodeIds& nodeIds,
+                           const livre::Frustum& frustum )
+                   { return livre::orderFrontToBack( regular, nodeIds, frustum ); });
+}
@@ -0,0 +1,138 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE ExecutorScheduling
+#include <boost/test/unit_test.hpp>
+
+#include <livre/core/pipeline/DAGExecutor.h>
+#include <livre/core/pipeline/Filter.h>
+#include <livre/core/pipeline/FutureMap.h>
+#include <livre/core/pipeline/PipeFilter.h>
+#include <livre/core/pipeline/Pipeline.h>
+#include <livre/core/pipeline/SimpleExecutor.h>
+
+#include <lunchbox/clock.h>
+
+namespace
+{
+const size_t nThreads = 4;
+const size_t nRepetitions = 5;
+const size_t pipelineSizes[] = { 16, 128, 1024 };
+
+/** Adds one to its input, the scheduling overhead dominates */
+class IncrementFilter : public livre::Filter
+{
+    void execute( const livre::FutureMap& input,
+                  livre::PromiseMap& output ) const final
+    {
+        uint32_t sum = 0;
+        for( const uint32_t value: input.get< uint32_t >( "Input" ))
+            sum += value;
+        output.set( "Output", sum + 1 );
+    }
+
+    livre::DataInfos getInputDataInfos() const final
+    {
+        return {{ "Input", livre::getType< uint32_t >( )}};
+    }
+
+    livre::DataInfos getOutputDataInfos() const final
+    {
+        return {{ "Output", livre::getType< uint32_t >( )}};
+    }
+};
+
+/** One source feeding 'size' independent filters */
+livre::Pipeline createWidePipeline( const size_t size )
+{
+    livre::Pipeline pipeline;
+    livre::PipeFilter source = pipeline.add< IncrementFilter >( "Source" );
+    for( size_t i = 0; i < size; ++i )
+    {
+        livre::PipeFilter filter =
+                pipeline.add< IncrementFilter >( std::to_string( i ));
+        source.connect( "Output", filter, "Input" );
+    }
+    return pipeline;
+}
+
+/** A chain of 'size' filters */
+livre::Pipeline createDeepPipeline( const size_t size )
+{
+    livre::Pipeline pipeline;
+    livre::PipeFilter source = pipeline.add< IncrementFilter >( "Source" );
+    livre::PipeFilter previous = source;
+    for( size_t i = 0; i < size; ++i )
+    {
+        livre::PipeFilter filter =
+                pipeline.add< IncrementFilter >( std::to_string( i ));
+        previous.connect( "Output", filter, "Input" );
+        previous = filter;
+    }
+    return pipeline;
+}
+
+typedef livre::Pipeline ( *PipelineFactory )( size_t );
+
+template< class ExecutorT >
+float benchmark( const PipelineFactory createPipeline, const size_t size )
+{
+    ExecutorT executor( nThreads );
+    float time = 0.f;
+    for( size_t i = 0; i < nRepetitions; ++i )
+    {
+        livre::Pipeline pipeline = createPipeline( size );
+        livre::PipeFilter source = static_cast< const livre::PipeFilter& >(
+                                       pipeline.getExecutable( "Source" ));
+        // Connected before scheduling, so every filter waits for this input
+        livre::Promise input = source.getPromise( "Input" );
+
+        lunchbox::Clock clock;
+        const livre::FutureMap futures( pipeline.schedule( executor ));
+        input.set( 0u );
+        futures.wait();
+        time += clock.getTimef();
+
+        BOOST_CHECK( futures.isReady( ));
+    }
+    return time / nRepetitions;
+}
+
+void compare( const std::string& name, const PipelineFactory createPipeline )
+{
+    for( const size_t size: pipelineSizes )
+    {
+        const float simple =
+                benchmark< livre::SimpleExecutor >( createPipeline, size );
+        const float dag = benchmark< livre::DAGExecutor >( createPipeline, size );
+        std::cout << name << " " << size << " filters: SimpleExecutor "
+                  << simple << " ms, DAGExecutor " << dag << " ms" << std::endl;
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE( widePipeline )
+{
+    compare( "wide", &createWidePipeline );
+}
+
+BOOST_AUTO_TEST_CASE( deepPipeline )
+{
+    compare( "deep", &createDeepPipeline );
+}
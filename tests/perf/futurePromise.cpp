@@ -0,0 +1,159 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE FuturePromise
+#include <boost/test/unit_test.hpp>
+
+#include <livre/core/pipeline/FuturePromise.h>
+
+#include <lunchbox/clock.h>
+
+#include <boost/thread/future.hpp>
+#include <boost/thread/thread.hpp>
+
+namespace
+{
+const size_t nPromises = 100000;
+const size_t nCopies = 1000000;
+const size_t nWaits = 1000;
+const size_t nWaitFutures = 64;
+
+// The implementation the ports used before: a boost promise per port and a
+// boost shared future per future
+typedef boost::promise< livre::PortDataPtr > BoostPromise;
+typedef boost::shared_future< livre::PortDataPtr > BoostFuture;
+
+livre::PortDataPtr createData( const uint32_t value )
+{
+    return std::make_shared< livre::PortDataT< uint32_t >>( value );
+}
+
+uint32_t getValue( const livre::PortDataPtr& data )
+{
+    return static_cast< const livre::PortDataT< uint32_t >& >( *data ).data;
+}
+
+void print( const std::string& name, const float livreTime,
+            const float boostTime, const size_t count )
+{
+    std::cout << name << ": livre " << livreTime * 1000000.f / count
+              << " ns, boost " << boostTime * 1000000.f / count << " ns"
+              << std::endl;
+}
+}
+
+BOOST_AUTO_TEST_CASE( setGet )
+{
+    const livre::DataInfo info( "Value", livre::getType< uint32_t >( ));
+    uint32_t livreSum = 0;
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < nPromises; ++i )
+    {
+        livre::Promise promise( info );
+        const livre::Future future = promise.getFuture();
+        promise.set( uint32_t( i ));
+        livreSum += future.get< uint32_t >();
+    }
+    const float livreTime = clock.resetTimef();
+
+    uint32_t boostSum = 0;
+    for( size_t i = 0; i < nPromises; ++i )
+    {
+        BoostPromise promise;
+        const BoostFuture future( promise.get_future( ));
+        promise.set_value( createData( i ));
+        boostSum += getValue( future.get( ));
+    }
+    const float boostTime = clock.getTimef();
+
+    BOOST_CHECK_EQUAL( livreSum, boostSum );
+    print( "create, set and get", livreTime, boostTime, nPromises );
+}
+
+BOOST_AUTO_TEST_CASE( copyGet )
+{
+    livre::Promise promise( livre::DataInfo( "Value", livre::getType< uint32_t >( )));
+    promise.set( 1u );
+    const livre::Future future = promise.getFuture();
+
+    BoostPromise boostPromise;
+    boostPromise.set_value( createData( 1 ));
+    const BoostFuture boostFuture( boostPromise.get_future( ));
+
+    uint32_t livreSum = 0;
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < nCopies; ++i )
+    {
+        const livre::Future copy( future );
+        livreSum += copy.get< uint32_t >();
+    }
+    const float livreTime = clock.resetTimef();
+
+    uint32_t boostSum = 0;
+    for( size_t i = 0; i < nCopies; ++i )
+    {
+        const BoostFuture copy( boostFuture );
+        boostSum += getValue( copy.get( ));
+    }
+    const float boostTime = clock.getTimef();
+
+    BOOST_CHECK_EQUAL( livreSum, boostSum );
+    print( "copy and get", livreTime, boostTime, nCopies );
+}
+
+BOOST_AUTO_TEST_CASE( waitForAny )
+{
+    const livre::DataInfo info( "Value", livre::getType< uint32_t >( ));
+    float livreTime = 0.f;
+    float boostTime = 0.f;
+    for( size_t i = 0; i < nWaits; ++i )
+    {
+        // The last future is set by another thread while the others block
+        std::vector< livre::Promise > promises;
+        livre::Futures futures;
+        for( size_t j = 0; j < nWaitFutures; ++j )
+        {
+            promises.emplace_back( info );
+            futures.push_back( promises.back().getFuture( ));
+        }
+
+        lunchbox::Clock clock;
+        boost::thread livreSetter( [&promises] { promises.back().set( 1u ); } );
+        livre::waitForAny( futures );
+        livreTime += clock.getTimef();
+        livreSetter.join();
+        BOOST_CHECK( futures.back().isReady( ));
+
+        std::vector< BoostPromise > boostPromises( nWaitFutures );
+        std::vector< BoostFuture > boostFutures;
+        for( BoostPromise& promise: boostPromises )
+            boostFutures.push_back( promise.get_future( ));
+
+        clock.reset();
+        boost::thread boostSetter( [&boostPromises]
+                                   { boostPromises.back().set_value( createData( 1 )); });
+        boost::wait_for_any( boostFutures.begin(), boostFutures.end( ));
+        boostTime += clock.getTimef();
+        boostSetter.join();
+        BOOST_CHECK( boostFutures.back().is_ready( ));
+    }
+
+    print( "wait for any of 64, set by another thread", livreTime, boostTime,
+           nWaits );
+}
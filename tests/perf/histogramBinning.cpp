@@ -0,0 +1,87 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE HistogramBinning
+#include <boost/test/unit_test.hpp>
+
+#include <livre/lib/cache/DataObject.h>
+#include <livre/lib/cache/HistogramObject.h>
+
+#include <livre/core/cache/Cache.h>
+#include <livre/core/data/DataSource.h>
+#include <livre/core/data/Histogram.h>
+#include <livre/core/data/LODNode.h>
+#include <livre/core/data/NodeId.h>
+#include <livre/core/data/VolumeInformation.h>
+
+#include <lunchbox/clock.h>
+
+namespace
+{
+const uint32_t BLOCK_SIZE = 64;
+const uint32_t VOLUME_SIZE = 1024;
+const size_t nRepetitions = 4;
+
+void benchmark( const std::string& dataType )
+{
+    std::stringstream volumeName;
+    volumeName << "mem:///?sparsity=0.5,datatype=" << dataType << "#"
+               << VOLUME_SIZE << "," << VOLUME_SIZE << "," << VOLUME_SIZE
+               << "," << BLOCK_SIZE;
+    livre::DataSource source( lunchbox::URI( volumeName.str( )));
+    const livre::VolumeInformation& info = source.getVolumeInfo();
+
+    const livre::NodeId root( 0, livre::Vector3ui( 0u ));
+    const livre::NodeIds& nodeIds = root.getChildrenAtLevel( 2 );
+
+    livre::CacheT< livre::DataObject > dataCache( "DataCache", 4096 * LB_1MB );
+    size_t nVoxels = 0;
+    for( const livre::NodeId& nodeId: nodeIds )
+    {
+        dataCache.load< livre::DataObject >( nodeId.getId(), source );
+        nVoxels += source.getNode( nodeId ).getVoxelBox().getSize().product();
+    }
+
+    uint64_t sum = 0;
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < nRepetitions; ++i )
+    {
+        for( const livre::NodeId& nodeId: nodeIds )
+        {
+            const livre::HistogramObject histogram( nodeId.getId(), dataCache,
+                                                    source, info.dataRange );
+            sum += histogram.getHistogram().getSum();
+        }
+    }
+    const float time = clock.getTimef();
+
+    BOOST_CHECK_GT( sum, 0 );
+    std::cout << dataType << ": " << nRepetitions * nVoxels / time / 1000.f
+              << " MVoxels/s" << std::endl;
+}
+}
+
+BOOST_AUTO_TEST_CASE( binningThroughput )
+{
+    for( const std::string& dataType : { "uint8", "int8", "uint16", "int16",
+                                         "uint32", "int32", "float" })
+    {
+        benchmark( dataType );
+    }
+}
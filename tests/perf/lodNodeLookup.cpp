@@ -0,0 +1,167 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE LODNodeLookup
+#include <boost/test/unit_test.hpp>
+
+#include <livre/core/data/DataSourcePlugin.h>
+#include <livre/core/data/LODNode.h>
+#include <livre/core/data/NodeId.h>
+
+#include <lunchbox/clock.h>
+
+#include <boost/thread/thread.hpp>
+
+namespace
+{
+const size_t nThreads = 8;
+const size_t nLookupsPerThread = 1000000;
+const uint32_t maxLevel = 5;
+
+class TestDataSource : public livre::DataSourcePlugin
+{
+public:
+    explicit TestDataSource( const bool regular )
+        : _regular( regular )
+    {
+        _volumeInfo.voxels = livre::Vector3ui( 1024 );
+        _volumeInfo.maximumBlockSize = livre::Vector3ui( 32 );
+        livre::fillRegularVolumeInfo( _volumeInfo );
+    }
+
+    livre::MemoryUnitPtr getData( const livre::LODNode& ) final
+    {
+        return livre::MemoryUnitPtr();
+    }
+
+    bool hasRegularTree() const final { return _regular; }
+
+private:
+    const bool _regular;
+};
+
+/** The unbounded map under a single read-write mutex, as used before. */
+class MapLookup
+{
+public:
+    explicit MapLookup( const livre::DataSourcePlugin& plugin )
+        : _plugin( plugin )
+    {}
+
+    livre::LODNode getNode( const livre::NodeId& nodeId ) const
+    {
+        {
+            livre::ReadLock lock( _mutex );
+            const auto it = _lodNodeMap.find( nodeId.getId( ));
+            if( it != _lodNodeMap.end( ))
+                return it->second;
+        }
+
+        livre::WriteLock writeLock( _mutex );
+        const auto it = _lodNodeMap.find( nodeId.getId( ));
+        if( it == _lodNodeMap.end( ))
+            _lodNodeMap[ nodeId.getId() ] = _plugin.internalNodeToLODNode( nodeId );
+
+        return _lodNodeMap[ nodeId.getId() ];
+    }
+
+private:
+    const livre::DataSourcePlugin& _plugin;
+    mutable std::unordered_map< livre::Identifier, livre::LODNode > _lodNodeMap;
+    mutable livre::ReadWriteMutex _mutex;
+};
+
+livre::NodeIds createNodeIds()
+{
+    const livre::NodeId root( 0, livre::Vector3ui( 0u ));
+    livre::NodeIds nodeIds( 1, root );
+    for( uint32_t level = 1; level <= maxLevel; ++level )
+    {
+        const livre::NodeIds& children = root.getChildrenAtLevel( level );
+        nodeIds.insert( nodeIds.end(), children.begin(), children.end( ));
+    }
+    return nodeIds;
+}
+
+template< class LookupT >
+float benchmark( const std::string& name, const LookupT& lookup,
+                 const livre::NodeIds& nodeIds )
+{
+    boost::thread_group threads;
+    livre::Floats checksums( nThreads, 0.f );
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < nThreads; ++i )
+    {
+        threads.create_thread( [&lookup, &nodeIds, &checksums, i]
+        {
+            float checksum = 0.f;
+            for( size_t j = 0; j < nLookupsPerThread; ++j )
+            {
+                const size_t index = ( j * 7919 + i * 104729 ) % nodeIds.size();
+                checksum += lookup( nodeIds[ index ]).getWorldBox().getMin().x();
+            }
+            checksums[ i ] = checksum;
+        });
+    }
+    threads.join_all();
+
+    const float time = clock.getTimef();
+    for( const float checksum: checksums )
+        BOOST_CHECK( std::isfinite( checksum ));
+    std::cout << name << ": " << nThreads * nLookupsPerThread / time
+              << " lookups/ms with " << nThreads << " threads" << std::endl;
+    return time;
+}
+}
+
+BOOST_AUTO_TEST_CASE( lookupsMatch )
+{
+    const TestDataSource regular( true );
+    const TestDataSource irregular( false );
+    const MapLookup map( irregular );
+
+    for( const livre::NodeId& nodeId: createNodeIds( ))
+    {
+        const livre::LODNode& expected = map.getNode( nodeId );
+        BOOST_CHECK( regular.getNode( nodeId ).getWorldBox() ==
+                     expected.getWorldBox( ));
+        BOOST_CHECK( irregular.getNode( nodeId ).getWorldBox() ==
+                     expected.getWorldBox( ));
+        BOOST_CHECK( irregular.getNode( nodeId ).getVoxelBox() ==
+                     expected.getVoxelBox( ));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( lookupThroughput )
+{
+    const livre::NodeIds& nodeIds = createNodeIds();
+    const TestDataSource regular( true );
+    const TestDataSource irregular( false );
+    const MapLookup map( irregular );
+
+    benchmark( "Unbounded map", [&map]( const livre::NodeId& nodeId )
+                                    { return map.getNode( nodeId ); },
+               nodeIds );
+    benchmark( "Sharded bounded map", [&irregular]( const livre::NodeId& nodeId )
+                                          { return irregular.getNode( nodeId ); },
+               nodeIds );
+    benchmark( "Computed", [&regular]( const livre::NodeId& nodeId )
+                               { return regular.getNode( nodeId ); },
+               nodeIds );
+}
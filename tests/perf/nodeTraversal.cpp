@@ -0,0 +1,133 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE NodeTraversal
+#include <boost/test/unit_test.hpp>
+
+#include <livre/core/data/NodeId.h>
+#include <livre/core/visitor/DFSTraversal.h>
+#include <livre/core/visitor/NodeVisitor.h>
+#include <livre/core/visitor/VisitState.h>
+
+#include <lunchbox/clock.h>
+
+namespace
+{
+const uint32_t treeDepth = 10;
+const size_t nIterations = 10;
+
+/** Refines the nodes on the x = 0 face of the volume, like a view would */
+bool isRefined( const livre::NodeId& nodeId )
+{
+    return nodeId.getPosition().x() == 0 && nodeId.getLevel() + 1 < treeDepth;
+}
+
+size_t traverseAllocating( const livre::NodeId& nodeId )
+{
+    size_t count = 1;
+    if( !isRefined( nodeId ))
+        return count;
+
+    for( const livre::NodeId& child: nodeId.getChildren( ))
+        count += traverseAllocating( child );
+    return count;
+}
+
+size_t traverseRange( const livre::NodeId& nodeId )
+{
+    size_t count = 1;
+    if( !isRefined( nodeId ))
+        return count;
+
+    for( const livre::NodeId& child: nodeId.getChildRange( ))
+        count += traverseRange( child );
+    return count;
+}
+
+class CountVisitor : public livre::NodeVisitor
+{
+public:
+    void visit( const livre::NodeId& nodeId, livre::VisitState& state ) final
+    {
+        ++count;
+        state.setVisitChild( isRefined( nodeId ));
+    }
+
+    size_t count = 0;
+};
+
+template< class TraverseT >
+size_t benchmark( const std::string& name, const TraverseT& traverse )
+{
+    size_t count = 0;
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < nIterations; ++i )
+        count = traverse();
+
+    const float time = clock.getTimef();
+    std::cout << name << ": " << count * nIterations / time
+              << " nodes/ms, " << count << " nodes" << std::endl;
+    return count;
+}
+}
+
+BOOST_AUTO_TEST_CASE( childTraversal )
+{
+    const livre::NodeId root( 0, livre::Vector3ui( 0u ));
+    const livre::RootNode rootNode( treeDepth, livre::Vector3ui( 1u ));
+
+    const size_t allocating =
+            benchmark( "getChildren()", [&]{ return traverseAllocating( root ); });
+    const size_t range =
+            benchmark( "getChildRange()", [&]{ return traverseRange( root ); });
+    const size_t dfs = benchmark( "DFSTraversal", [&]
+    {
+        CountVisitor visitor;
+        livre::DFSTraversal traverser;
+        traverser.traverse( rootNode, visitor, 0 );
+        return visitor.count;
+    });
+
+    BOOST_CHECK_EQUAL( allocating, range );
+    BOOST_CHECK_EQUAL( allocating, dfs );
+}
+
+BOOST_AUTO_TEST_CASE( parentTraversal )
+{
+    const livre::NodeId leaf( treeDepth - 1, livre::Vector3ui( 0, 511, 511 ));
+    const size_t nLookups = 1000000;
+
+    const size_t allocating = benchmark( "getParents()", [&]
+    {
+        size_t count = 0;
+        for( size_t i = 0; i < nLookups; ++i )
+            count += leaf.getParents().size();
+        return count;
+    });
+    const size_t range = benchmark( "getParentRange()", [&]
+    {
+        size_t count = 0;
+        for( size_t i = 0; i < nLookups; ++i )
+            for( const livre::NodeId& parent: leaf.getParentRange( ))
+                count += parent.isValid();
+        return count;
+    });
+
+    BOOST_CHECK_EQUAL( allocating, range );
+}
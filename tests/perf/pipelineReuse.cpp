@@ -0,0 +1,115 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE PipelineReuse
+#include <boost/test/unit_test.hpp>
+
+#include <livre/core/pipeline/Filter.h>
+#include <livre/core/pipeline/FutureMap.h>
+#include <livre/core/pipeline/PipeFilter.h>
+#include <livre/core/pipeline/Pipeline.h>
+
+#include <lunchbox/clock.h>
+
+namespace
+{
+const size_t nFrames = 10000;
+
+/** Adds one to the sum of its inputs */
+class IncrementFilter : public livre::Filter
+{
+    void execute( const livre::FutureMap& input,
+                  livre::PromiseMap& output ) const final
+    {
+        uint32_t sum = 0;
+        for( const uint32_t value: input.get< uint32_t >( "Input" ))
+            sum += value;
+        output.set( "Output", sum + 1 );
+    }
+
+    livre::DataInfos getInputDataInfos() const final
+    {
+        return {{ "Input", livre::getType< uint32_t >( )}};
+    }
+
+    livre::DataInfos getOutputDataInfos() const final
+    {
+        return {{ "Output", livre::getType< uint32_t >( )}};
+    }
+};
+
+/**
+ * A graph shaped like the asynchronous render pipeline: visible set ->
+ * rendering set -> { render, histogram -> send, upload -> redraw }.
+ */
+livre::Pipeline createFrameGraph()
+{
+    livre::Pipeline pipeline;
+    livre::PipeFilter visibles = pipeline.add< IncrementFilter >( "Visibles" );
+    livre::PipeFilter renderingSet = pipeline.add< IncrementFilter >( "RenderingSet" );
+    livre::PipeFilter render = pipeline.add< IncrementFilter >( "Render" );
+    livre::PipeFilter histogram = pipeline.add< IncrementFilter >( "Histogram" );
+    livre::PipeFilter send = pipeline.add< IncrementFilter >( "Send" );
+    livre::PipeFilter upload = pipeline.add< IncrementFilter >( "Upload" );
+    livre::PipeFilter redraw = pipeline.add< IncrementFilter >( "Redraw" );
+
+    visibles.connect( "Output", renderingSet, "Input" );
+    visibles.connect( "Output", upload, "Input" );
+    renderingSet.connect( "Output", render, "Input" );
+    renderingSet.connect( "Output", histogram, "Input" );
+    renderingSet.connect( "Output", redraw, "Input" );
+    histogram.connect( "Output", send, "Input" );
+    upload.connect( "Output", redraw, "Input" );
+    return pipeline;
+}
+
+uint32_t executeFrame( livre::Pipeline& pipeline, const uint32_t frame )
+{
+    livre::PipeFilter visibles = static_cast< const livre::PipeFilter& >(
+                                     pipeline.getExecutable( "Visibles" ));
+    visibles.getPromise( "Input" ).set( frame );
+    pipeline.execute();
+
+    const livre::Executable& redraw = pipeline.getExecutable( "Redraw" );
+    const livre::UniqueFutureMap futures( redraw.getPostconditions( ));
+    return futures.get< uint32_t >( "Output" );
+}
+}
+
+BOOST_AUTO_TEST_CASE( frameOverhead )
+{
+    lunchbox::Clock clock;
+    for( uint32_t i = 0; i < nFrames; ++i )
+    {
+        livre::Pipeline pipeline = createFrameGraph();
+        BOOST_CHECK_EQUAL( executeFrame( pipeline, i ), 2 * i + 5 );
+    }
+    const float rebuilt = clock.resetTimef() * 1000.f / nFrames;
+
+    livre::Pipeline pipeline = createFrameGraph();
+    for( uint32_t i = 0; i < nFrames; ++i )
+    {
+        pipeline.reset();
+        BOOST_CHECK_EQUAL( executeFrame( pipeline, i ), 2 * i + 5 );
+    }
+    const float reused = clock.resetTimef() * 1000.f / nFrames;
+
+    std::cout << "Per frame: rebuilt graph " << rebuilt << " us, re-armed graph "
+              << reused << " us, saved " << rebuilt - reused << " us" << std::endl;
+}
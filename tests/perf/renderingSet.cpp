@@ -0,0 +1,191 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE RenderingSet
+#include <boost/test/unit_test.hpp>
+
+#include <livre/lib/pipeline/RenderingSetGeneratorFilter.h>
+
+#include <livre/core/cache/Cache.h>
+#include <livre/core/cache/CacheObject.h>
+#include <livre/core/data/NodeId.h>
+#include <livre/core/pipeline/FutureMap.h>
+#include <livre/core/pipeline/PipeFilter.h>
+#include <livre/core/render/FrameInfo.h>
+
+#include <lunchbox/clock.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+const size_t nIterations = 20;
+const size_t nVisibles = 50000;
+const uint32_t visibleLevel = 5;
+
+class TextureObject : public livre::CacheObject
+{
+public:
+    explicit TextureObject( const livre::CacheId& cacheId )
+        : livre::CacheObject( cacheId )
+    {}
+
+    size_t getSize() const final { return 1; }
+};
+
+typedef livre::CacheT< TextureObject > TextureCache;
+
+/** The nodes of a cut at visibleLevel under two root blocks, in Morton order */
+livre::NodeIds createVisibles()
+{
+    livre::NodeIds visibles;
+    for( uint32_t x = 0; x < 2; ++x )
+    {
+        const livre::NodeId root( 0, livre::Vector3ui( x, 0, 0 ));
+        const livre::NodeIds& children = root.getChildrenAtLevel( visibleLevel );
+        visibles.insert( visibles.end(), children.begin(), children.end( ));
+    }
+    livre::sortMorton( visibles );
+    visibles.resize( nVisibles );
+    return visibles;
+}
+
+/**
+ * Loads a third of the visibles, every other parent one level up and, for the
+ * first half of the visibles, the coarser levels: the residency of a cache
+ * while the camera moves.
+ */
+void loadTextures( TextureCache& cache, const livre::NodeIds& visibles )
+{
+    for( size_t i = 0; i < visibles.size(); ++i )
+    {
+        if( i % 3 == 0 )
+            cache.load< TextureObject >( visibles[ i ].getId( ));
+
+        const livre::NodeId& parent = visibles[ i ].getParent();
+        if( parent.getMortonCode() % 2 == 0 )
+            cache.load< TextureObject >( parent.getId( ));
+
+        if( i >= visibles.size() / 2 )
+            continue;
+
+        for( const livre::NodeId& nodeId: parent.getParentRange( ))
+            if( nodeId.getLevel() < visibleLevel - 2 )
+                cache.load< TextureObject >( nodeId.getId( ));
+    }
+}
+
+/** The map with repeated scans for the covered nodes, as used before. */
+livre::ConstCacheObjects generateWithMap( const livre::Cache& cache,
+                                          const livre::NodeIds& visibles,
+                                          livre::NodeAvailability& availability )
+{
+    livre::ConstCacheMap cacheMap;
+    for( const livre::NodeId& nodeId: visibles )
+    {
+        livre::NodeId current = nodeId;
+        while( current.isValid( ))
+        {
+            const livre::ConstCacheObjectPtr texture = cache.get( current.getId( ));
+            if( texture )
+            {
+                cacheMap[ current.getId() ] = texture;
+                break;
+            }
+            current = current.isRoot() ? livre::NodeId() : current.getParent();
+        }
+        cacheMap.count( nodeId.getId( )) > 0 ? ++availability.nAvailable
+                                             : ++availability.nNotAvailable;
+    }
+
+    size_t previousSize = 0;
+    do
+    {
+        previousSize = cacheMap.size();
+        auto it = cacheMap.begin();
+        while( it != cacheMap.end( ))
+        {
+            bool hasParent = false;
+            for( const livre::NodeId& parentId: livre::NodeId( it->first ).getParentRange( ))
+                hasParent = hasParent || cacheMap.count( parentId.getId( )) > 0;
+            it = hasParent ? cacheMap.erase( it ) : std::next( it );
+        }
+    }
+    while( previousSize != cacheMap.size( ));
+
+    livre::ConstCacheObjects cacheObjects;
+    for( const auto& entry: cacheMap )
+        cacheObjects.push_back( entry.second );
+    return cacheObjects;
+}
+
+livre::CacheIds getIds( const livre::ConstCacheObjects& cacheObjects )
+{
+    livre::CacheIds ids;
+    for( const livre::ConstCacheObjectPtr& cacheObject: cacheObjects )
+        ids.push_back( cacheObject->getId( ));
+    std::sort( ids.begin(), ids.end( ));
+    return ids;
+}
+}
+
+BOOST_AUTO_TEST_CASE( renderingSetResolution )
+{
+    const livre::NodeIds& visibles = createVisibles();
+    TextureCache cache( "TextureCache", 1024 * 1024 * 1024 );
+    loadTextures( cache, visibles );
+
+    livre::PipeFilterT< livre::RenderingSetGeneratorFilter > filter( "RenderingSet",
+                                                                     cache );
+    livre::ConstCacheObjects renderingSet;
+    livre::NodeAvailability availability;
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < nIterations; ++i )
+    {
+        filter.reset();
+        filter.getPromise( "VisibleNodes" ).set( visibles );
+        filter.execute();
+
+        const livre::UniqueFutureMap futures( filter.getPostconditions( ));
+        renderingSet = futures.get< livre::ConstCacheObjects >( "CacheObjects" );
+        availability = futures.get< livre::NodeAvailability >( "NodeAvailability" );
+    }
+    const float singlePass = clock.resetTimef() / nIterations;
+
+    livre::ConstCacheObjects expected;
+    livre::NodeAvailability expectedAvailability;
+    for( size_t i = 0; i < nIterations; ++i )
+    {
+        expectedAvailability = livre::NodeAvailability();
+        expected = generateWithMap( cache, visibles, expectedAvailability );
+    }
+    const float withMap = clock.resetTimef() / nIterations;
+
+    BOOST_CHECK( getIds( renderingSet ) == getIds( expected ));
+    BOOST_CHECK_EQUAL( availability.nAvailable, expectedAvailability.nAvailable );
+    BOOST_CHECK_EQUAL( availability.nNotAvailable,
+                       expectedAvailability.nNotAvailable );
+    BOOST_CHECK_GT( renderingSet.size(), 0u );
+    BOOST_CHECK_LT( renderingSet.size(), visibles.size( ));
+
+    std::cout << visibles.size() << " visibles, " << renderingSet.size()
+              << " rendered: map with rescans " << withMap << " ms, single pass "
+              << singlePass << " ms" << std::endl;
+}
@@ -0,0 +1,181 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE VisibleSelection
+#include <boost/test/unit_test.hpp>
+
+#include <livre/lib/data/MemoryDataSource.h>
+
+#include <livre/core/data/DataSource.h>
+#include <livre/core/render/ClipPlanes.h>
+#include <livre/core/render/Frustum.h>
+#include <livre/core/render/LODCriterion.h>
+#include <livre/core/render/LODCut.h>
+#include <livre/core/render/SelectVisibles.h>
+#include <livre/core/visitor/DFSTraversal.h>
+
+#include <lunchbox/clock.h>
+#include <lunchbox/pluginRegisterer.h>
+
+#include <cmath>
+#include <thread>
+
+// Explicit registration required because the folder of the data source plugin is not
+// in the LD_LIBRARY_PATH of the test executable.
+lunchbox::PluginRegisterer< livre::MemoryDataSource > registerer;
+
+namespace
+{
+const size_t nIterations = 10;
+const uint32_t windowHeight = 2048;
+const float screenSpaceError = 1.0f;
+const uint32_t maxTaskLevel = 3;
+
+// A 64k^3 volume of 64^3 bricks, a tree of depth 11
+const char* const volumeURI = "mem://#65536,65536,65536,64";
+
+// Frames of the camera path, which turns slowly and moves closer
+const size_t nFrames = 100;
+
+livre::Frustum createFrustum( const size_t frame )
+{
+    const float projArray[] = { 2.0, 0, 0, 0,
+                                0, 2.0, 0, 0,
+                                0, 0, -1.01342285, -1,
+                                0, 0, -0.201342285, 0 };
+
+    const float angle = 0.002f * frame;
+    const float c = std::cos( angle );
+    const float s = std::sin( angle );
+    const float mvArray[] = { c, 0, -s, 0,
+                              0, 1, 0, 0,
+                              s, 0, c, 0,
+                              0, 0, -1.0f + 0.001f * frame, 1 };
+
+    return livre::Frustum( livre::Matrix4f( mvArray, mvArray + 16 ),
+                           livre::Matrix4f( projArray, projArray + 16 ));
+}
+
+livre::Frustum createFrustum()
+{
+    const float projArray[] = { 2.0, 0, 0, 0,
+                                0, 2.0, 0, 0,
+                                0, 0, -1.01342285, -1,
+                                0, 0, -0.201342285, 0 };
+
+    const float mvArray[] = { 1, 0, 0, 0,
+                              0, 1, 0, 0,
+                              0, 0, 1, 0,
+                              0, 0, -1.0, 1 };
+
+    return livre::Frustum( livre::Matrix4f( mvArray, mvArray + 16 ),
+                           livre::Matrix4f( projArray, projArray + 16 ));
+}
+
+template< class TraverseT >
+livre::NodeIds benchmark( const std::string& name,
+                          const livre::DataSource& dataSource,
+                          const TraverseT& traverse )
+{
+    const livre::Frustum frustum = createFrustum();
+    const livre::ClipPlanes clipPlanes;
+    livre::NodeIds visibles;
+
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < nIterations; ++i )
+    {
+        livre::SelectVisibles visitor( dataSource, frustum, windowHeight,
+                                       screenSpaceError, 0, 100,
+                                       {{ 0.0f, 1.0f }}, clipPlanes );
+        livre::DFSTraversal traverser;
+        traverse( traverser, visitor );
+        visibles = visitor.takeVisibles();
+    }
+
+    std::cout << name << ": " << clock.getTimef() / nIterations << " ms, "
+              << visibles.size() << " visible nodes" << std::endl;
+    return visibles;
+}
+}
+
+BOOST_AUTO_TEST_CASE( visibleSelection )
+{
+    const livre::DataSource dataSource( lunchbox::URI( volumeURI ));
+    const livre::RootNode& rootNode = dataSource.getVolumeInfo().rootNode;
+
+    const livre::NodeIds& sequential = benchmark( "sequential", dataSource,
+        [&]( livre::DFSTraversal& traverser, livre::SelectVisibles& visitor )
+        {
+            traverser.traverse( rootNode, visitor, 0 );
+        });
+
+    const size_t nCores = std::max( std::thread::hardware_concurrency(), 1u );
+    for( uint32_t taskLevel = 0; taskLevel <= maxTaskLevel; ++taskLevel )
+        for( size_t nThreads = 1; nThreads <= nCores; nThreads *= 2 )
+        {
+            const livre::NodeIds& parallel = benchmark(
+                "parallel, task level " + std::to_string( taskLevel ) + ", " +
+                std::to_string( nThreads ) + " threads", dataSource,
+                [&]( livre::DFSTraversal& traverser, livre::SelectVisibles& visitor )
+                {
+                    traverser.traverse( rootNode, visitor, 0, taskLevel, nThreads );
+                });
+
+            BOOST_CHECK( parallel == sequential );
+        }
+}
+
+BOOST_AUTO_TEST_CASE( incrementalSelection )
+{
+    const livre::DataSource dataSource( lunchbox::URI( volumeURI ));
+    const livre::RootNode& rootNode = dataSource.getVolumeInfo().rootNode;
+    const livre::ClipPlanes clipPlanes;
+
+    std::vector< livre::NodeIds > expected;
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < nFrames; ++i )
+    {
+        livre::SelectVisibles visitor( dataSource, createFrustum( i ), windowHeight,
+                                       screenSpaceError, 0, 100,
+                                       {{ 0.0f, 1.0f }}, clipPlanes );
+        livre::DFSTraversal traverser;
+        traverser.traverse( rootNode, visitor, 0, maxTaskLevel,
+                            std::thread::hardware_concurrency( ));
+        expected.push_back( visitor.takeVisibles( ));
+    }
+    std::cout << "camera path, full traversal: " << clock.resetTimef() / nFrames
+              << " ms per frame, " << expected.back().size() << " visible nodes"
+              << std::endl;
+
+    livre::LODCut lodCut( dataSource );
+    size_t nEvaluations = 0;
+    for( size_t i = 0; i < nFrames; ++i )
+    {
+        const livre::LODCriterion criterion( createFrustum( i ), windowHeight,
+                                             screenSpaceError, 0, 100,
+                                             rootNode.getDepth(), clipPlanes );
+        const livre::NodeIds& visibles = lodCut.update( criterion, 0 );
+        if( i > 0 )
+            nEvaluations += lodCut.getEvaluations();
+        BOOST_CHECK( visibles == expected[ i ] );
+    }
+    std::cout << "camera path, incremental: " << clock.getTimef() / nFrames
+              << " ms per frame, " << nEvaluations / ( nFrames - 1 )
+              << " evaluated nodes per frame" << std::endl;
+}
@@ -0,0 +1,146 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE WorkerScheduling
+#include <boost/test/unit_test.hpp>
+
+#include <livre/core/pipeline/Executable.h>
+#include <livre/core/pipeline/SimpleExecutor.h>
+#include <livre/core/pipeline/Workers.h>
+
+#include <lunchbox/clock.h>
+
+#include <boost/thread/thread.hpp>
+
+#include <atomic>
+
+namespace
+{
+const size_t nThreads = 4;
+const size_t nTinyExecutables = 100000;
+const size_t spawnDepth = 16; // 2^17 - 1 executables
+
+/** Executable with almost no work, so the scheduling overhead dominates */
+class TinyExecutable : public livre::Executable
+{
+public:
+    TinyExecutable( std::atomic< size_t >& counter,
+                    livre::Workers* workers = nullptr,
+                    const size_t depth = 0 )
+        : _counter( counter )
+        , _workers( workers )
+        , _depth( depth )
+    {}
+
+    void execute() final
+    {
+        // Fan out from within the worker: children go to its own deque
+        if( _workers && _depth > 0 )
+        {
+            for( size_t i = 0; i < 2; ++i )
+                _workers->schedule( std::make_shared< TinyExecutable >(
+                                        _counter, _workers, _depth - 1 ));
+        }
+        ++_counter;
+    }
+
+    livre::Futures getPostconditions() const final { return livre::Futures(); }
+    livre::Futures getPreconditions() const final { return livre::Futures(); }
+
+    livre::ExecutablePtr clone() const final
+    {
+        return std::make_shared< TinyExecutable >( _counter, _workers, _depth );
+    }
+
+private:
+    std::atomic< size_t >& _counter;
+    livre::Workers* const _workers;
+    const size_t _depth;
+};
+
+void waitFor( const std::atomic< size_t >& counter, const size_t expected )
+{
+    while( counter < expected )
+        boost::this_thread::yield();
+}
+
+void report( const std::string& name, const size_t count, const float time )
+{
+    std::cout << name << ": " << count / time << " executables/ms ("
+              << time * 1000.f / count << " us each)" << std::endl;
+}
+}
+
+BOOST_AUTO_TEST_CASE( injectedExecutables )
+{
+    for( const livre::Workers::Affinity affinity :
+         { livre::Workers::AFFINITY_NONE, livre::Workers::AFFINITY_CORE })
+    {
+        livre::Workers workers( nThreads, livre::ConstGLContextPtr(), affinity );
+        std::atomic< size_t > counter( 0 );
+
+        lunchbox::Clock clock;
+        for( size_t i = 0; i < nTinyExecutables; ++i )
+            workers.schedule( std::make_shared< TinyExecutable >( counter ));
+        waitFor( counter, nTinyExecutables );
+        const float time = clock.getTimef();
+
+        BOOST_CHECK_EQUAL( counter, nTinyExecutables );
+        report( affinity == livre::Workers::AFFINITY_NONE ?
+                    "injected" : "injected, core affinity",
+                nTinyExecutables, time );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( spawnedExecutables )
+{
+    livre::Workers workers( nThreads );
+    std::atomic< size_t > counter( 0 );
+    const size_t expected = ( size_t( 2 ) << spawnDepth ) - 1;
+
+    lunchbox::Clock clock;
+    workers.schedule( std::make_shared< TinyExecutable >( counter, &workers,
+                                                          spawnDepth ));
+    waitFor( counter, expected );
+    const float time = clock.getTimef();
+
+    BOOST_CHECK_EQUAL( counter, expected );
+    report( "spawned", expected, time );
+}
+
+BOOST_AUTO_TEST_CASE( sharedExecutors )
+{
+    // Three executors on one pool, as in the RenderPipeline
+    livre::WorkersPtr workers = std::make_shared< livre::Workers >( nThreads );
+    livre::SimpleExecutor renderExecutor( workers );
+    livre::SimpleExecutor computeExecutor( workers );
+    livre::SimpleExecutor uploadExecutor( workers );
+    livre::Executor* executors[] = { &renderExecutor, &computeExecutor,
+                                     &uploadExecutor };
+    std::atomic< size_t > counter( 0 );
+
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < nTinyExecutables; ++i )
+        executors[ i % 3 ]->schedule( std::make_shared< TinyExecutable >( counter ));
+    waitFor( counter, nTinyExecutables );
+    const float time = clock.getTimef();
+
+    BOOST_CHECK_EQUAL( counter, nTinyExecutables );
+    report( "shared executors", nTinyExecutables, time );
+}
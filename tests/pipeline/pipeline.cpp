@@ -23,12 +23,17 @@
 #include <livre/core/pipeline/Filter.h>
 #include <livre/core/pipeline/Pipeline.h>
 #include <livre/core/pipeline/SimpleExecutor.h>
+#include <livre/core/pipeline/DAGExecutor.h>
 #include <livre/core/pipeline/Workers.h>
 #include <livre/core/pipeline/FutureMap.h>
 #include <livre/core/pipeline/PromiseMap.h>
 #include <livre/core/pipeline/FuturePromise.h>
+#include <livre/core/pipeline/CancellationToken.h>
 
 #include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <future>
 
 namespace ut = boost::unit_test;
 
@@ -108,6 +113,118 @@ class ConvertFilter : public livre::Filter
     }
 };
 
+/** Counts the copies of large port data */
+struct CountedData
+{
+    CountedData() {}
+    CountedData( const CountedData& data )
+        : values( data.values )
+    {
+        ++copies;
+    }
+    CountedData( CountedData&& ) = default;
+
+    std::vector< uint32_t > values;
+    static size_t copies;
+};
+size_t CountedData::copies = 0;
+
+class ProduceDataFilter : public livre::Filter
+{
+    void execute( const livre::FutureMap&, livre::PromiseMap& output ) const final
+    {
+        CountedData data;
+        data.values.resize( 1024, defaultMeaningOfLife );
+        output.set( "Data", std::move( data ));
+    }
+
+    livre::DataInfos getOutputDataInfos() const final
+    {
+        return {{ "Data", livre::getType< CountedData >( ) }};
+    }
+};
+
+class ConsumeDataFilter : public livre::Filter
+{
+    void execute( const livre::FutureMap& input, livre::PromiseMap& output ) const final
+    {
+        const CountedData& data = input.getRefs< CountedData >( "Data" ).front();
+        const livre::UniqueFutureMap uniqueInput( input.getFutures( ));
+        BOOST_CHECK_EQUAL( &uniqueInput.get< CountedData >( "Data" ), &data );
+        BOOST_CHECK_EQUAL( uniqueInput.getFuture( "Data" ).getShared< CountedData >().get(),
+                           &data );
+        output.set( "Address", &data );
+    }
+
+    livre::DataInfos getInputDataInfos() const final
+    {
+        return {{ "Data", livre::getType< CountedData >( ) }};
+    }
+
+    livre::DataInfos getOutputDataInfos() const final
+    {
+        return {{ "Address", livre::getType< const CountedData* >( ) }};
+    }
+};
+
+typedef std::vector< uint32_t > Numbers;
+
+/** Adds an offset to chunks of numbers, for the parallel map */
+class OffsetFilter : public livre::Filter
+{
+    void execute( const livre::FutureMap& input, livre::PromiseMap& output ) const final
+    {
+        const livre::UniqueFutureMap uniqueInput( input.getFutures( ));
+        const uint32_t offset = uniqueInput.get< uint32_t >( "Offset" );
+        Numbers results;
+        for( const uint32_t number: uniqueInput.get< Numbers >( "Numbers" ))
+            results.push_back( number + offset );
+        output.set( "Results", std::move( results ));
+    }
+
+    livre::DataInfos getInputDataInfos() const final
+    {
+        return {{ "Numbers", livre::getType< Numbers >( ) },
+                { "Offset", livre::getType< uint32_t >( ) }};
+    }
+
+    livre::DataInfos getOutputDataInfos() const final
+    {
+        return {{ "Results", livre::getType< Numbers >( ) }};
+    }
+};
+
+/** Adds an offset to chunks of numbers once the gate is open */
+class GatedOffsetFilter : public livre::Filter
+{
+public:
+    explicit GatedOffsetFilter( const std::shared_future< void >& gate )
+        : _gate( gate )
+    {}
+
+private:
+    void execute( const livre::FutureMap& input, livre::PromiseMap& output ) const final
+    {
+        _gate.wait();
+        _filter().execute( input, output );
+    }
+
+    livre::DataInfos getInputDataInfos() const final
+    {
+        return _filter().getInputDataInfos();
+    }
+
+    livre::DataInfos getOutputDataInfos() const final
+    {
+        return _filter().getOutputDataInfos();
+    }
+
+    const livre::Filter& _filter() const { return _offset; }
+
+    const std::shared_future< void > _gate;
+    const OffsetFilter _offset;
+};
+
 bool check_error( const std::runtime_error& ) { return true; }
 
 BOOST_AUTO_TEST_CASE( testFilterNoInput )
@@ -291,6 +408,265 @@ BOOST_AUTO_TEST_CASE( testOneToManyManyToOnePipeline )
     }
 }
 
+BOOST_AUTO_TEST_CASE( testDAGExecutorPipeline )
+{
+    const size_t convertFilterCount = 10;
+    const uint32_t inputValue = 90;
+    livre::Pipeline pipeline = createPipeline( inputValue, convertFilterCount );
+
+    const livre::Executable& pipeOutput = pipeline.getExecutable( "Consumer" );
+    livre::DAGExecutor executor( 4 );
+    const livre::Futures& futures = pipeline.schedule( executor );
+    const livre::UniqueFutureMap portFutures1( pipeOutput.getPostconditions( ));
+    BOOST_CHECK_EQUAL( portFutures1.get< OutputData >( "TestOutputData" ).thanksForAllTheFish,
+                       1761 );
+
+    const livre::FutureMap futureMap( futures );
+    futureMap.wait();
+
+    // Scheduled before the input is set, dispatched by the continuations
+    pipeline.reset();
+    livre::PipeFilter pipeInput =
+            static_cast< const livre::PipeFilter& >(
+                pipeline.getExecutable( "Producer" ));
+    livre::Promise input = pipeInput.getPromise( "TestInputData" );
+    pipeline.schedule( executor );
+    input.set( InputData( inputValue ));
+
+    const livre::UniqueFutureMap portFutures2( pipeOutput.getPostconditions( ));
+    BOOST_CHECK_EQUAL( portFutures2.get< OutputData >( "TestOutputData" ).thanksForAllTheFish,
+                       1761 );
+}
+
+BOOST_AUTO_TEST_CASE( testFutureContinuation )
+{
+    livre::Promise promise( livre::DataInfo( "Continuation", livre::getType< uint32_t >( )));
+    const livre::Future future = promise.getFuture();
+
+    size_t calls = 0;
+    future.onReady( [&calls] { ++calls; } );
+    BOOST_CHECK_EQUAL( calls, 0 );
+
+    promise.set( 42u );
+    BOOST_CHECK_EQUAL( calls, 1 );
+
+    // Registered on a ready future, called immediately
+    future.onReady( [&calls] { ++calls; } );
+    BOOST_CHECK_EQUAL( calls, 2 );
+
+    // Flush calls the pending continuations with empty data
+    promise.reset();
+    promise.getFuture().onReady( [&calls] { ++calls; } );
+    promise.flush();
+    BOOST_CHECK_EQUAL( calls, 3 );
+
+    // Reset abandons the pending continuations, but wakes up the waiters
+    promise.reset();
+    const livre::Future abandoned = promise.getFuture();
+    abandoned.onReady( [&calls] { ++calls; } );
+    promise.reset();
+    BOOST_CHECK_EQUAL( calls, 3 );
+    BOOST_CHECK( abandoned.isReady( ));
+    BOOST_CHECK( !abandoned.hasValue( ));
+}
+
+BOOST_AUTO_TEST_CASE( testParallelMapPreview )
+{
+    const uint32_t nNumbers = 100;
+    const uint32_t offset = 42;
+    Numbers numbers( nNumbers );
+    for( uint32_t i = 0; i < nNumbers; ++i )
+        numbers[ i ] = i;
+
+    // The even numbers are known before the lanes process them
+    const livre::MapPreview< uint32_t, uint32_t > evenNumbers =
+        [offset]( const Numbers& items, const livre::FutureMap& )
+        {
+            Numbers preview;
+            for( const uint32_t item: items )
+                if( item % 2 == 0 )
+                    preview.push_back( item + offset );
+            return preview;
+        };
+
+    std::promise< void > gate;
+    livre::ParallelMap< uint32_t, uint32_t > map(
+        "Gated", std::make_shared< GatedOffsetFilter >( gate.get_future().share( )),
+        "Numbers", "Results", 4, 1, livre::MapOrder< uint32_t >(), evenNumbers );
+    map.getInput().getPromise( "Numbers" ).set( numbers );
+    map.getInput().getPromise( "Offset" ).set( offset );
+
+    livre::DAGExecutor executor( 4 );
+    for( livre::PipeFilter& filter: map.getFilters( ))
+        executor.schedule( std::make_shared< livre::PipeFilter >( filter ));
+
+    // The preview is ready while all lanes are blocked
+    const livre::UniqueFutureMap previewFutures( map.getInput().getPostconditions( ));
+    const Numbers& preview = previewFutures.get< Numbers >( "Results" );
+    BOOST_REQUIRE_EQUAL( preview.size(), nNumbers / 2 );
+    for( uint32_t i = 0; i < nNumbers / 2; ++i )
+        BOOST_CHECK_EQUAL( preview[ i ], 2 * i + offset );
+
+    for( const livre::PipeFilter& lane: map.getLanes( ))
+        for( const livre::Future& future: lane.getPostconditions( ))
+            BOOST_CHECK( !future.isReady( ));
+    for( const livre::Future& future: map.getOutput().getPostconditions( ))
+        BOOST_CHECK( !future.isReady( ));
+
+    gate.set_value();
+    const livre::UniqueFutureMap futures( map.getOutput().getPostconditions( ));
+    Numbers results = futures.get< Numbers >( "Results" );
+    BOOST_REQUIRE_EQUAL( results.size(), nNumbers );
+    std::sort( results.begin(), results.end( ));
+    for( uint32_t i = 0; i < nNumbers; ++i )
+        BOOST_CHECK_EQUAL( results[ i ], i + offset );
+}
+
+BOOST_AUTO_TEST_CASE( testLateWriterAfterReset )
+{
+    livre::Promise promise( livre::DataInfo( "Late", livre::getType< uint32_t >( )));
+    const livre::Future bound( promise );
+
+    // A writer of the previous run does not satisfy the reset promise
+    const livre::Promise current = promise.getCurrent();
+    promise.reset();
+    livre::Promise( current ).set( 1u );
+    livre::Promise( current ).flush();
+    BOOST_CHECK( !bound.isReady( ));
+
+    promise.set( 2u );
+    BOOST_CHECK_EQUAL( bound.get< uint32_t >(), 2u );
+}
+
+BOOST_AUTO_TEST_CASE( testWaitForAny )
+{
+    livre::Promise promise1( livre::DataInfo( "First", livre::getType< uint32_t >( )));
+    livre::Promise promise2( livre::DataInfo( "Second", livre::getType< uint32_t >( )));
+    const livre::Futures futures = { promise1.getFuture(), promise2.getFuture() };
+
+    // Blocks until the other thread sets the second promise
+    boost::thread setter( [&promise2] { promise2.set( 42u ); } );
+    livre::waitForAny( futures );
+    BOOST_CHECK( futures.back().isReady( ));
+    BOOST_CHECK_EQUAL( futures.back().get< uint32_t >(), 42u );
+    setter.join();
+
+    // Returns immediately with a ready future
+    livre::waitForAny( futures );
+    BOOST_CHECK( !futures.front().isReady( ));
+
+    // A flushed promise is ready without a value
+    promise1.flush();
+    BOOST_CHECK( futures.front().isReady( ));
+    BOOST_CHECK( !futures.front().hasValue( ));
+    BOOST_CHECK_THROW( promise1.set( 1u ), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( testNoCopyPortData )
+{
+    livre::Pipeline pipeline;
+    livre::PipeFilter producer = pipeline.add< ProduceDataFilter >( "Producer" );
+    livre::PipeFilter consumer1 = pipeline.add< ConsumeDataFilter >( "Consumer1" );
+    livre::PipeFilter consumer2 = pipeline.add< ConsumeDataFilter >( "Consumer2" );
+    producer.connect( "Data", consumer1, "Data" );
+    producer.connect( "Data", consumer2, "Data" );
+
+    CountedData::copies = 0;
+    pipeline.execute();
+
+    const livre::UniqueFutureMap futures1( consumer1.getPostconditions( ));
+    const livre::UniqueFutureMap futures2( consumer2.getPostconditions( ));
+    BOOST_CHECK_EQUAL( futures1.get< const CountedData* >( "Address" ),
+                       futures2.get< const CountedData* >( "Address" ));
+    BOOST_CHECK_EQUAL( CountedData::copies, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( testParallelMap )
+{
+    const uint32_t nNumbers = 1000;
+    const uint32_t offset = 42;
+    Numbers numbers( nNumbers );
+    for( uint32_t i = 0; i < nNumbers; ++i )
+        numbers[ i ] = i;
+
+    livre::Pipeline pipeline;
+    livre::ParallelMap< uint32_t, uint32_t > map =
+        pipeline.addParallelMap< OffsetFilter, uint32_t, uint32_t >( "Offset", "Numbers",
+                                                                     "Results", 4 );
+    BOOST_CHECK_EQUAL( map.getLanes().size(), 4 );
+
+    map.getInput().getPromise( "Numbers" ).set( numbers );
+    map.getInput().getPromise( "Offset" ).set( offset );
+
+    {
+        livre::DAGExecutor executor( 4 );
+        pipeline.schedule( executor );
+
+        const livre::UniqueFutureMap futures( map.getOutput().getPostconditions( ));
+        Numbers results = futures.get< Numbers >( "Results" );
+        BOOST_REQUIRE_EQUAL( results.size(), nNumbers );
+        std::sort( results.begin(), results.end( ));
+        for( uint32_t i = 0; i < nNumbers; ++i )
+            BOOST_CHECK_EQUAL( results[ i ], i + offset );
+    }
+
+    // Synchronous execution, with an empty collection
+    pipeline.reset();
+    map.getInput().getPromise( "Numbers" ).set( Numbers( ));
+    map.getInput().getPromise( "Offset" ).set( offset );
+    pipeline.execute();
+    const livre::UniqueFutureMap emptyFutures( map.getOutput().getPostconditions( ));
+    BOOST_CHECK( emptyFutures.get< Numbers >( "Results" ).empty( ));
+
+    // The collection is ordered before it is split, a single lane keeps it
+    livre::ParallelMap< uint32_t, uint32_t > ordered(
+        "Ordered", std::make_shared< OffsetFilter >(), "Numbers", "Results", 1, 1,
+        []( Numbers& items, const livre::FutureMap& )
+            { std::sort( items.rbegin(), items.rend( )); } );
+    ordered.getInput().getPromise( "Numbers" ).set( numbers );
+    ordered.getInput().getPromise( "Offset" ).set( offset );
+    for( livre::PipeFilter& filter: ordered.getFilters( ))
+        filter.execute();
+
+    const livre::UniqueFutureMap orderedFutures( ordered.getOutput().getPostconditions( ));
+    const Numbers& orderedResults = orderedFutures.get< Numbers >( "Results" );
+    BOOST_REQUIRE_EQUAL( orderedResults.size(), nNumbers );
+    for( uint32_t i = 0; i < nNumbers; ++i )
+        BOOST_CHECK_EQUAL( orderedResults[ i ], nNumbers - 1 - i + offset );
+}
+
+BOOST_AUTO_TEST_CASE( testCancelledFilter )
+{
+    livre::PipeFilter pipeFilter = livre::PipeFilterT< TestFilter >( "Cancelled" );
+    pipeFilter.getPromise( "TestInputData" ).set( InputData( 90 ));
+
+    const livre::CancellationToken token = livre::CancellationToken::create();
+    pipeFilter.setCancellationToken( token );
+    token.cancel();
+    BOOST_CHECK( pipeFilter.isCancelled( ));
+
+    // Cancellation takes effect once the deadline has passed
+    const livre::CancellationToken pending = livre::CancellationToken::create( 1e6f );
+    pending.cancel();
+    BOOST_CHECK( !pending.isCancelled( ));
+
+    // The cancelled filter does not execute, but its outputs are released
+    livre::SimpleExecutor executor( 2 );
+    executor.schedule( std::make_shared< livre::PipeFilter >( pipeFilter ));
+    const livre::UniqueFutureMap portFutures( pipeFilter.getPostconditions( ));
+    portFutures.wait( "TestOutputData" );
+    BOOST_CHECK_THROW( portFutures.get< OutputData >( "TestOutputData" ),
+                       std::runtime_error );
+
+    pipeFilter.reset();
+    pipeFilter.setCancellationToken( livre::CancellationToken( ));
+    pipeFilter.getPromise( "TestInputData" ).set( InputData( 90 ));
+    pipeFilter.execute();
+    const livre::UniqueFutureMap resetFutures( pipeFilter.getPostconditions( ));
+    BOOST_CHECK_EQUAL( resetFutures.get< OutputData >( "TestOutputData" ).thanksForAllTheFish,
+                       defaultThanksForAllTheFish + 90 + addMoreFish );
+}
+
 BOOST_AUTO_TEST_CASE( testPromiseFuture )
 {
     livre::Promise promise( livre::DataInfo( "Helloworld", livre::getType< uint32_t >( )));
@@ -0,0 +1,71 @@
+/* Copyright (c) 2011-2016, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE ThreadTuner
+
+#include <livre/core/pipeline/ThreadTuner.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+
+namespace
+{
+const size_t nFramesPerStep = 4;
+
+/** Runs frames of a stage which scales up to the given number of threads */
+size_t tune( livre::ThreadTuner& tuner, const size_t scalingLimit )
+{
+    const size_t nItems = 1000;
+    for( size_t i = 0; i < 100 && !tuner.isDone(); ++i )
+    {
+        const size_t nThreads = tuner.getThreadCount();
+        const float milliseconds = float( nItems ) / std::min( nThreads, scalingLimit );
+        const size_t queueDepth = nThreads < scalingLimit ? 10 : 0;
+        tuner.addFrame( nItems, milliseconds, queueDepth );
+    }
+    return tuner.getThreadCount();
+}
+}
+
+BOOST_AUTO_TEST_CASE( testTunerClimbsToScalingLimit )
+{
+    livre::ThreadTuner tuner( 1, 1, 16, nFramesPerStep );
+    BOOST_CHECK_EQUAL( tune( tuner, 6 ), 6 );
+    BOOST_CHECK( tuner.isDone( ));
+}
+
+BOOST_AUTO_TEST_CASE( testTunerRespectsMaximum )
+{
+    livre::ThreadTuner tuner( 2, 1, 4, nFramesPerStep );
+    BOOST_CHECK_EQUAL( tune( tuner, 8 ), 4 );
+}
+
+BOOST_AUTO_TEST_CASE( testTunerReleasesIdleThreads )
+{
+    livre::ThreadTuner tuner( 8, 1, 16, nFramesPerStep );
+    BOOST_CHECK_EQUAL( tune( tuner, 3 ), 3 );
+}
+
+BOOST_AUTO_TEST_CASE( testTunerFixedCount )
+{
+    livre::ThreadTuner tuner( 2, 2, 2, nFramesPerStep );
+    BOOST_CHECK( tuner.isDone( ));
+    BOOST_CHECK_EQUAL( tuner.addFrame( 10, 1.f, 10 ), 2 );
+}